@@ -0,0 +1,26 @@
+#ifndef ANTITHETIC_SHOE_H
+#define ANTITHETIC_SHOE_H
+
+#include <cstdint>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief Enum class to represent the part a shoe plays in an antithetic pair.
+ */
+enum class AntitheticShoe : std::uint8_t
+{
+  /// @brief The shoe is not paired, every card is drawn as it is needed.
+  NONE,
+  /// @brief The first shoe of a pair, every round draws the random bits of
+  /// all six cards it could deal up front.
+  FIRST,
+  /// @brief The second shoe of a pair, dealt from the same seed with the
+  /// random bits of the player and banker cards swapped.
+  MIRRORED
+};
+
+} // namespace BACCARAT
+
+#endif // ANTITHETIC_SHOE_H
@@ -175,17 +175,18 @@ auto Baccarat::handle_player_round(CasinoPlayer &player,
                  [](unsigned char bet_type_char)
                  { return std::toupper(bet_type_char); });
 
+  bool bet_placed = false;
   if (bet_type == "PLAYER")
   {
-    player.place_bet(BetType::PLAYER, bet_amount);
+    bet_placed = player.place_bet(BetType::PLAYER, bet_amount);
   }
   else if (bet_type == "BANKER")
   {
-    player.place_bet(BetType::BANKER, bet_amount);
+    bet_placed = player.place_bet(BetType::BANKER, bet_amount);
   }
   else if (bet_type == "TIE")
   {
-    player.place_bet(BetType::TIE, bet_amount);
+    bet_placed = player.place_bet(BetType::TIE, bet_amount);
   }
   else
   {
@@ -193,6 +194,12 @@ auto Baccarat::handle_player_round(CasinoPlayer &player,
     return false;
   }
 
+  // Don't deal a round for a bet the player could not afford.
+  if (!bet_placed)
+  {
+    return false;
+  }
+
   // Deal the cards and determine the outcome.
   card_dealer.play_round(current_outcome);
   BACCARAT::CardDealer::pay_out_bets(current_outcome, player);
@@ -0,0 +1,495 @@
+#include "bankroll_simulator.h"
+#include "casino_player.h"
+#include "chunk_runner.h"
+#include "simulation.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <utility>
+
+namespace BACCARAT
+{
+
+// CONSTRUCTORS
+
+BankrollSimulator::BankrollSimulator(const RuleSet &rules,
+                                     const BetStrategy &strategy,
+                                     const BankrollOptions &options)
+    : rules(rules), strategy(strategy), options(options)
+{
+  // Short sessions have fewer checkpoints than NUM_OF_CHECKPOINTS, every
+  // checkpoint must be a different round.
+  for (int i = 1; i <= NUM_OF_CHECKPOINTS; ++i)
+  {
+    int checkpoint_round =
+        std::max(1, options.session_length * i / NUM_OF_CHECKPOINTS);
+    if (checkpoint_rounds.empty() ||
+        checkpoint_round > checkpoint_rounds.back())
+    {
+      checkpoint_rounds.push_back(checkpoint_round);
+    }
+  }
+
+  // Balances above the stop win can't be reached, otherwise allow the player
+  // to triple their balance before the histograms overflow.
+  max_histogram_balance = options.stop_win > 0.0
+                              ? options.starting_balance + options.stop_win
+                              : 3 * options.starting_balance;
+}
+
+// PUBLIC METHODS
+
+void BankrollResult::merge(const BankrollResult &other)
+{
+  num_of_sessions += other.num_of_sessions;
+  num_of_ruined_sessions += other.num_of_ruined_sessions;
+  num_of_stop_loss_sessions += other.num_of_stop_loss_sessions;
+  num_of_stop_win_sessions += other.num_of_stop_win_sessions;
+  num_of_rounds += other.num_of_rounds;
+  total_final_balance += other.total_final_balance;
+  total_wagered += other.total_wagered;
+  for (std::size_t i = 0; i < ruin_round_counts.size(); ++i)
+  {
+    ruin_round_counts[i] += other.ruin_round_counts[i];
+  }
+  for (std::size_t i = 0; i < balance_histograms.size(); ++i)
+  {
+    for (std::size_t j = 0; j < balance_histograms[i].size(); ++j)
+    {
+      balance_histograms[i][j] += other.balance_histograms[i][j];
+    }
+  }
+}
+
+void BankrollResult::serialize(BinaryWriter &writer) const
+{
+  writer.write_u64(num_of_sessions);
+  writer.write_u64(num_of_ruined_sessions);
+  writer.write_u64(num_of_stop_loss_sessions);
+  writer.write_u64(num_of_stop_win_sessions);
+  writer.write_u64(num_of_rounds);
+  writer.write_double(total_final_balance);
+  writer.write_double(total_wagered);
+  writer.write_u64_vector(ruin_round_counts);
+  writer.write_u64(balance_histograms.size());
+  for (const std::vector<std::uint64_t> &balance_histogram :
+       balance_histograms)
+  {
+    writer.write_u64_vector(balance_histogram);
+  }
+}
+
+auto BankrollResult::deserialize(BinaryReader &reader) -> bool
+{
+  std::uint64_t num_of_histograms = 0;
+  if (!reader.read_u64(num_of_sessions) ||
+      !reader.read_u64(num_of_ruined_sessions) ||
+      !reader.read_u64(num_of_stop_loss_sessions) ||
+      !reader.read_u64(num_of_stop_win_sessions) ||
+      !reader.read_u64(num_of_rounds) ||
+      !reader.read_double(total_final_balance) ||
+      !reader.read_double(total_wagered) ||
+      !reader.read_u64_vector(ruin_round_counts) ||
+      !reader.read_u64(num_of_histograms))
+  {
+    return false;
+  }
+
+  balance_histograms.assign(num_of_histograms, {});
+  for (std::vector<std::uint64_t> &balance_histogram : balance_histograms)
+  {
+    if (!reader.read_u64_vector(balance_histogram))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto BankrollSimulator::run(BankrollResult &result) -> bool
+{
+  std::uint64_t num_of_chunks =
+      (options.num_of_sessions + SESSIONS_PER_CHUNK - 1) / SESSIONS_PER_CHUNK;
+
+  result = create_empty_result();
+  std::uint64_t first_chunk_index = 0;
+
+  Checkpoint checkpoint(options.checkpoint, serialize_setup());
+  if (checkpoint.can_resume())
+  {
+    std::vector<std::uint8_t> state;
+    if (!checkpoint.read(first_chunk_index, state))
+    {
+      return false;
+    }
+    BinaryReader reader(std::move(state));
+    if (!result.deserialize(reader))
+    {
+      printf("Checkpoint '%s' is corrupt.\n",
+             options.checkpoint.path.c_str());
+      return false;
+    }
+    printf("Resuming from checkpoint after %llu of %llu sessions.\n",
+           static_cast<unsigned long long>(result.num_of_sessions),
+           static_cast<unsigned long long>(options.num_of_sessions));
+  }
+
+  auto write_checkpoint = [&](std::uint64_t next_chunk_index)
+  {
+    BinaryWriter writer;
+    result.serialize(writer);
+    checkpoint.write(next_chunk_index, writer.get_buffer());
+  };
+
+  run_chunks_in_order<BankrollResult>(
+      first_chunk_index, num_of_chunks, options.num_of_threads,
+      [&](std::uint64_t chunk_index)
+      {
+        CardDealer card_dealer(rules, options.shoe_mode);
+        card_dealer.set_continuous_shuffle_delay(
+            options.continuous_shuffle_delay);
+        card_dealer.set_shuffle_model(options.shuffle_model,
+                                      options.num_of_shuffle_passes);
+        BetStrategy session_strategy = strategy;
+
+        BankrollResult chunk_result = create_empty_result();
+        std::uint64_t first_session_index = chunk_index * SESSIONS_PER_CHUNK;
+        std::uint64_t last_session_index = std::min(
+            first_session_index + SESSIONS_PER_CHUNK, options.num_of_sessions);
+        for (std::uint64_t session_index = first_session_index;
+             session_index < last_session_index; ++session_index)
+        {
+          simulate_session(session_index, card_dealer, session_strategy,
+                           chunk_result);
+        }
+        return chunk_result;
+      },
+      [&](std::uint64_t chunk_index, const BankrollResult &chunk_result)
+      {
+        result.merge(chunk_result);
+        if (checkpoint.is_due())
+        {
+          write_checkpoint(chunk_index + 1);
+        }
+      });
+
+  if (checkpoint.is_enabled())
+  {
+    write_checkpoint(num_of_chunks);
+  }
+  return true;
+}
+
+void BankrollSimulator::print_result(const BankrollResult &result) const
+{
+  auto num_of_sessions =
+      static_cast<double>(std::max<std::uint64_t>(result.num_of_sessions, 1));
+  auto percent_of_sessions = [&](std::uint64_t count)
+  { return 100.0 * static_cast<double>(count) / num_of_sessions; };
+
+  std::uint64_t num_of_full_sessions =
+      result.num_of_sessions - result.num_of_ruined_sessions -
+      result.num_of_stop_loss_sessions - result.num_of_stop_win_sessions;
+
+  // The 95% confidence interval of the risk of ruin, from the normal
+  // approximation to the binomial distribution.
+  double risk_of_ruin =
+      static_cast<double>(result.num_of_ruined_sessions) / num_of_sessions;
+  double risk_of_ruin_ci =
+      Z_95 * std::sqrt(risk_of_ruin * (1 - risk_of_ruin) / num_of_sessions);
+
+  printf("\n--- Bankroll Simulation ---\n\n");
+  printf("Strategy: %s\n", strategy.to_string().c_str());
+  printf("Sessions: %llu\n",
+         static_cast<unsigned long long>(result.num_of_sessions));
+  printf("Starting Balance: %.2f\n", options.starting_balance);
+  printf("Table Limits: %.2f - ", options.table_min);
+  if (options.table_max > 0.0)
+  {
+    printf("%.2f\n", options.table_max);
+  }
+  else
+  {
+    printf("no limit\n");
+  }
+  printf("Stop Loss: %.2f\nStop Win: %.2f\nSession Length: %d rounds\n\n",
+         options.stop_loss, options.stop_win, options.session_length);
+
+  printf("Risk of Ruin:        %8.4f%% +/- %.4f%%\n", 100.0 * risk_of_ruin,
+         100.0 * risk_of_ruin_ci);
+  printf("Stop Loss Reached:   %8.4f%%\n",
+         percent_of_sessions(result.num_of_stop_loss_sessions));
+  printf("Stop Win Reached:    %8.4f%%\n",
+         percent_of_sessions(result.num_of_stop_win_sessions));
+  printf("Full Session Played: %8.4f%%\n\n",
+         percent_of_sessions(num_of_full_sessions));
+
+  double average_final_balance = result.total_final_balance / num_of_sessions;
+  double total_loss = (options.starting_balance * num_of_sessions) -
+                      result.total_final_balance;
+  printf("Average Rounds Played: %.2f\n",
+         static_cast<double>(result.num_of_rounds) / num_of_sessions);
+  printf("Average Final Balance: %.2f\n", average_final_balance);
+  printf("Average Wagered:       %.2f\n",
+         result.total_wagered / num_of_sessions);
+  printf("Loss per Unit Wagered: %.6f\n\n",
+         result.total_wagered > 0.0 ? total_loss / result.total_wagered : 0.0);
+
+  if (result.num_of_ruined_sessions > 0)
+  {
+    // Percentiles of the number of rounds played before ruin, for the ruined
+    // sessions only.
+    static constexpr std::array<double, 5> RUIN_PERCENTILES = {0.1, 0.25, 0.5,
+                                                               0.75, 0.9};
+    double total_ruin_rounds = 0.0;
+    for (std::size_t i = 0; i < result.ruin_round_counts.size(); ++i)
+    {
+      total_ruin_rounds +=
+          static_cast<double>(i * result.ruin_round_counts[i]);
+    }
+    printf("Time to Ruin (rounds):\n  Mean: %.2f\n",
+           total_ruin_rounds /
+               static_cast<double>(result.num_of_ruined_sessions));
+
+    std::uint64_t cumulative_count = 0;
+    std::size_t percentile_index = 0;
+    for (std::size_t i = 0; i < result.ruin_round_counts.size() &&
+                            percentile_index < RUIN_PERCENTILES.size();
+         ++i)
+    {
+      cumulative_count += result.ruin_round_counts[i];
+      while (percentile_index < RUIN_PERCENTILES.size() &&
+             static_cast<double>(cumulative_count) >=
+                 RUIN_PERCENTILES[percentile_index] *
+                     static_cast<double>(result.num_of_ruined_sessions))
+      {
+        printf("  P%.0f: %zu\n", 100 * RUIN_PERCENTILES[percentile_index], i);
+        ++percentile_index;
+      }
+    }
+    printf("\n");
+  }
+
+  // The balance percentiles at each checkpoint, and the fraction of sessions
+  // ruined by then.
+  static constexpr std::array<double, 5> BALANCE_PERCENTILES = {
+      0.05, 0.25, 0.5, 0.75, 0.95};
+  printf("Balance Trajectory:\n\n%8s %10s %12s %12s %12s %12s %12s\n",
+         "ROUND", "RUINED", "P5", "P25", "P50", "P75", "P95");
+
+  std::uint64_t num_of_ruined_sessions = 0;
+  int previous_round = 0;
+  for (std::size_t i = 0; i < checkpoint_rounds.size(); ++i)
+  {
+    for (int round = previous_round + 1; round <= checkpoint_rounds[i];
+         ++round)
+    {
+      num_of_ruined_sessions += result.ruin_round_counts[round];
+    }
+    previous_round = checkpoint_rounds[i];
+
+    printf("%8d %9.4f%%", checkpoint_rounds[i],
+           percent_of_sessions(num_of_ruined_sessions));
+    for (double percentile : BALANCE_PERCENTILES)
+    {
+      printf(" %12.2f",
+             get_balance_percentile(result.balance_histograms[i],
+                                    result.num_of_sessions, percentile));
+    }
+    printf("\n");
+  }
+  printf("\n");
+}
+
+// PRIVATE METHODS
+
+auto BankrollSimulator::serialize_setup() const -> std::vector<std::uint8_t>
+{
+  BinaryWriter writer;
+  writer.write_string("ruin");
+  rules.serialize(writer);
+  writer.write_string(strategy.to_string());
+  writer.write_u64(options.num_of_sessions);
+  writer.write_u64(options.seed);
+  writer.write_double(options.starting_balance);
+  writer.write_double(options.table_min);
+  writer.write_double(options.table_max);
+  writer.write_double(options.stop_loss);
+  writer.write_double(options.stop_win);
+  writer.write_i64(options.session_length);
+  writer.write_double(options.penetration);
+  writer.write_u64(static_cast<std::uint64_t>(options.shoe_mode));
+  writer.write_i64(options.continuous_shuffle_delay);
+  writer.write_u64(static_cast<std::uint64_t>(options.shuffle_model));
+  writer.write_i64(options.num_of_shuffle_passes);
+  return writer.get_buffer();
+}
+
+auto BankrollSimulator::create_empty_result() const -> BankrollResult
+{
+  BankrollResult result;
+  result.ruin_round_counts.resize(options.session_length + 1);
+  result.balance_histograms.resize(
+      checkpoint_rounds.size(),
+      std::vector<std::uint64_t>(NUM_OF_BALANCE_BINS));
+  return result;
+}
+
+void BankrollSimulator::simulate_session(std::uint64_t session_index,
+                                         CardDealer &card_dealer,
+                                         BetStrategy &session_strategy,
+                                         BankrollResult &result) const
+{
+  CasinoPlayer player(options.starting_balance, false);
+  session_strategy.reset_state();
+
+  // Every session deals its own sequence of shoes.
+  std::uint64_t session_seed =
+      Simulation::get_shoe_seed(options.seed, session_index);
+  std::uint64_t shoe_index = 0;
+  card_dealer.reset_deck(Simulation::get_shoe_seed(session_seed, shoe_index));
+
+  int total_cards_in_deck = CardDealer::CARDS_PER_DECK * rules.num_of_decks;
+  auto cut_card_position =
+      static_cast<int>(options.penetration * total_cards_in_deck);
+  int num_of_cards_dealt = 0;
+
+  double table_max = options.table_max > 0.0
+                         ? options.table_max
+                         : std::numeric_limits<double>::max();
+
+  // Determines how the session ends given the current balance, the session
+  // ends early as soon as its outcome is known.
+  auto get_session_end = [&]()
+  {
+    double balance = player.check_balance();
+    if (balance < options.table_min || balance <= 0.0)
+    {
+      return SessionEnd::RUINED;
+    }
+    if (options.stop_loss > 0.0 &&
+        balance <= options.starting_balance - options.stop_loss)
+    {
+      return SessionEnd::STOP_LOSS;
+    }
+    if (options.stop_win > 0.0 &&
+        balance >= options.starting_balance + options.stop_win)
+    {
+      return SessionEnd::STOP_WIN;
+    }
+    return SessionEnd::NONE;
+  };
+
+  RoundResult round_result;
+  int num_of_rounds = 0;
+  std::size_t next_checkpoint = 0;
+  SessionEnd session_end = get_session_end();
+  while (session_end == SessionEnd::NONE &&
+         num_of_rounds < options.session_length)
+  {
+    // Start a new shoe once the cut card is reached.
+    if (num_of_cards_dealt >= cut_card_position ||
+        num_of_cards_dealt + MAX_CARDS_IN_ROUND > total_cards_in_deck)
+    {
+      card_dealer.reset_deck(
+          Simulation::get_shoe_seed(session_seed, ++shoe_index));
+      num_of_cards_dealt = 0;
+    }
+
+    // The bet is kept within the table limits, and a player that can't cover
+    // the bet stakes their remaining balance.
+    double bet_amount =
+        std::min({std::max(session_strategy.get_next_bet_amount(),
+                           options.table_min),
+                  table_max, player.check_balance()});
+    BetType bet_type = session_strategy.get_next_bet_type();
+    player.place_bet(bet_type, bet_amount);
+
+    card_dealer.deal_round(round_result);
+    num_of_cards_dealt +=
+        round_result.num_of_player_cards + round_result.num_of_banker_cards;
+
+    CardDealer::pay_out_bets(round_result.outcome, player, rules);
+    session_strategy.record_result(
+        round_result.outcome, CardDealer::get_payout_multiplier(
+                                  round_result.outcome, bet_type, rules));
+
+    ++num_of_rounds;
+    result.total_wagered += bet_amount;
+
+    if (next_checkpoint < checkpoint_rounds.size() &&
+        checkpoint_rounds[next_checkpoint] == num_of_rounds)
+    {
+      ++result.balance_histograms[next_checkpoint]
+                                 [get_balance_bin(player.check_balance())];
+      ++next_checkpoint;
+    }
+    session_end = get_session_end();
+  }
+
+  switch (session_end)
+  {
+  case SessionEnd::RUINED:
+    ++result.num_of_ruined_sessions;
+    ++result.ruin_round_counts[num_of_rounds];
+    break;
+  case SessionEnd::STOP_LOSS:
+    ++result.num_of_stop_loss_sessions;
+    break;
+  case SessionEnd::STOP_WIN:
+    ++result.num_of_stop_win_sessions;
+    break;
+  default:
+    break;
+  }
+
+  // Sessions that ended early keep their final balance for the remaining
+  // checkpoints.
+  for (; next_checkpoint < checkpoint_rounds.size(); ++next_checkpoint)
+  {
+    ++result.balance_histograms[next_checkpoint]
+                               [get_balance_bin(player.check_balance())];
+  }
+
+  ++result.num_of_sessions;
+  result.num_of_rounds += num_of_rounds;
+  result.total_final_balance += player.check_balance();
+}
+
+auto BankrollSimulator::get_balance_bin(double balance) const -> std::size_t
+{
+  double bin_width = max_histogram_balance / NUM_OF_BALANCE_BINS;
+  auto bin = static_cast<std::int64_t>(balance / bin_width);
+  return static_cast<std::size_t>(
+      std::clamp<std::int64_t>(bin, 0, NUM_OF_BALANCE_BINS - 1));
+}
+
+auto BankrollSimulator::get_balance_percentile(
+    const std::vector<std::uint64_t> &histogram,
+    std::uint64_t num_of_sessions,
+    double percentile) const -> double
+{
+  double bin_width = max_histogram_balance / NUM_OF_BALANCE_BINS;
+  double target_count = percentile * static_cast<double>(num_of_sessions);
+
+  std::uint64_t cumulative_count = 0;
+  for (std::size_t i = 0; i < histogram.size(); ++i)
+  {
+    if (histogram[i] > 0 &&
+        static_cast<double>(cumulative_count + histogram[i]) >= target_count)
+    {
+      // Interpolate within the bin.
+      double fraction_of_bin =
+          (target_count - static_cast<double>(cumulative_count)) /
+          static_cast<double>(histogram[i]);
+      return (static_cast<double>(i) + fraction_of_bin) * bin_width;
+    }
+    cumulative_count += histogram[i];
+  }
+  return max_histogram_balance;
+}
+
+} // namespace BACCARAT
@@ -0,0 +1,281 @@
+#ifndef BANKROLL_SIMULATOR_H
+#define BANKROLL_SIMULATOR_H
+
+#include "bet_strategy.h"
+#include "binary_io.h"
+#include "card_dealer.h"
+#include "checkpoint.h"
+#include "rule_set.h"
+#include "shoe_mode.h"
+#include "shuffle_model.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief The options of a bankroll simulation.
+ */
+struct BankrollOptions
+{
+  /// @brief The number of player sessions to simulate.
+  std::uint64_t num_of_sessions = 100000;
+
+  /// @brief The master seed, every session is seeded from it and its index.
+  std::uint64_t seed = 1;
+
+  /// @brief The balance the player starts every session with.
+  double starting_balance = 5000.0;
+
+  /// @brief The smallest bet allowed at the table. A player that cannot
+  /// afford the minimum bet is ruined.
+  double table_min = 10.0;
+
+  /// @brief The largest bet allowed at the table, 0 for no limit.
+  double table_max = 0.0;
+
+  /// @brief The player leaves once they have lost this much, 0 to disable.
+  double stop_loss = 0.0;
+
+  /// @brief The player leaves once they have won this much, 0 to disable.
+  double stop_win = 0.0;
+
+  /// @brief The most rounds played in a session.
+  int session_length = 1000;
+
+  /// @brief The fraction of the shoe dealt before the cut card is reached.
+  double penetration = 0.9;
+
+  /// @brief How cards are drawn from the shoe.
+  ShoeMode shoe_mode = ShoeMode::FINITE_SHOE;
+
+  /// @brief The number of rounds before the cards of a round are returned to
+  /// a CONTINUOUS_SHUFFLE shoe.
+  int continuous_shuffle_delay = 0;
+
+  /// @brief How the dealer shuffles a FINITE_SHOE, see
+  /// CardDealer::set_shuffle_model.
+  ShuffleModel shuffle_model = ShuffleModel::RANDOM;
+
+  /// @brief The number of riffles, strip cuts or passes through the machine
+  /// of every shuffle.
+  int num_of_shuffle_passes = 0;
+
+  /// @brief The number of worker threads, 0 to use every core.
+  int num_of_threads = 0;
+
+  /// @brief Where and how often the simulation state is saved.
+  CheckpointOptions checkpoint;
+};
+
+/**
+ * @brief The results of a bankroll simulation.
+ */
+struct BankrollResult
+{
+  /// @brief The number of sessions simulated.
+  std::uint64_t num_of_sessions = 0;
+
+  /// @brief The number of sessions where the player could no longer afford
+  /// the minimum bet.
+  std::uint64_t num_of_ruined_sessions = 0;
+
+  /// @brief The number of sessions ended by the stop loss.
+  std::uint64_t num_of_stop_loss_sessions = 0;
+
+  /// @brief The number of sessions ended by the stop win.
+  std::uint64_t num_of_stop_win_sessions = 0;
+
+  /// @brief The number of rounds played across all sessions.
+  std::uint64_t num_of_rounds = 0;
+
+  /// @brief The sum of the final balances of every session.
+  double total_final_balance = 0.0;
+
+  /// @brief The sum of every bet placed across all sessions.
+  double total_wagered = 0.0;
+
+  /// @brief The number of sessions ruined after each number of rounds.
+  /// @note The index is the number of rounds played when the player was
+  /// ruined.
+  std::vector<std::uint64_t> ruin_round_counts;
+
+  /// @brief A histogram of the balance of every session at each trajectory
+  /// checkpoint. Sessions that ended early keep their final balance.
+  /// @note The first index is the checkpoint, the second is the balance bin.
+  std::vector<std::vector<std::uint64_t>> balance_histograms;
+
+  /**
+   * @brief Adds the results of another bankroll simulation to this result.
+   *
+   * @param other The result to merge.
+   */
+  void merge(const BankrollResult &other);
+
+  /**
+   * @brief Writes the result to a binary buffer.
+   *
+   * @param writer The writer to write to.
+   */
+  void serialize(BinaryWriter &writer) const;
+
+  /**
+   * @brief Reads a result written by serialize.
+   *
+   * @param reader The reader to read from.
+   *
+   * @return true if the result was read, false otherwise.
+   */
+  auto deserialize(BinaryReader &reader) -> bool;
+};
+
+/**
+ * @brief A class to simulate many player sessions and measure the risk of
+ * ruin.
+ *
+ * @details Every session starts a CasinoPlayer with the starting balance, and
+ * plays the betting strategy against its own shoes until the player is ruined,
+ * reaches the stop loss or stop win, or plays the full session length. Bets
+ * are settled with CardDealer::pay_out_bets. The sessions are split into
+ * chunks that are simulated by a pool of worker threads.
+ *
+ * @note If a checkpoint path is given, the merged results are saved
+ * periodically and the simulation can be resumed with identical results.
+ */
+class BankrollSimulator
+{
+public:
+  /**
+   * @brief Constructor for the BankrollSimulator class.
+   *
+   * @param rules The table rules used to deal and settle the bets.
+   * @param strategy The betting strategy of the player.
+   * @param options The options of the simulation.
+   */
+  BankrollSimulator(const RuleSet &rules,
+                    const BetStrategy &strategy,
+                    const BankrollOptions &options);
+
+  /**
+   * @brief Runs the simulation.
+   *
+   * @param result The results of the simulation.
+   *
+   * @return true if the simulation finished, false if its checkpoint could not
+   * be resumed.
+   */
+  auto run(BankrollResult &result) -> bool;
+
+  /**
+   * @brief Prints the risk of ruin, time to ruin distribution and percentile
+   * trajectories of the balance.
+   *
+   * @param result The results of the simulation.
+   */
+  void print_result(const BankrollResult &result) const;
+
+private:
+  /// @brief The number of sessions in a chunk of work given to a worker.
+  static constexpr std::uint64_t SESSIONS_PER_CHUNK = 256;
+
+  /// @brief The most points on the balance trajectories, shorter sessions
+  /// have a point at every round.
+  static constexpr int NUM_OF_CHECKPOINTS = 10;
+
+  /// @brief The number of bins in each balance histogram.
+  static constexpr int NUM_OF_BALANCE_BINS = 1000;
+
+  /// @brief The most cards that can be dealt in a single round.
+  static constexpr int MAX_CARDS_IN_ROUND = 6;
+
+  /// @brief The z value of a two sided 95% confidence interval.
+  static constexpr double Z_95 = 1.959963984540054;
+
+  /**
+   * @brief How a player session ended.
+   */
+  enum class SessionEnd : std::uint8_t
+  {
+    /// @brief The session is still being played, or played every round.
+    NONE,
+    /// @brief The player could no longer afford the minimum bet.
+    RUINED,
+    /// @brief The player reached the stop loss.
+    STOP_LOSS,
+    /// @brief The player reached the stop win.
+    STOP_WIN
+  };
+
+  /// @brief The table rules used to deal and settle the bets.
+  RuleSet rules;
+
+  /// @brief The betting strategy of the player.
+  BetStrategy strategy;
+
+  /// @brief The options of the simulation.
+  BankrollOptions options;
+
+  /// @brief The round of each trajectory checkpoint.
+  std::vector<int> checkpoint_rounds;
+
+  /// @brief The largest balance tracked by the balance histograms, larger
+  /// balances are counted in the last bin.
+  double max_histogram_balance = 0.0;
+
+  /**
+   * @brief Writes the setup of the simulation, every option that changes its
+   * results.
+   *
+   * @return The serialized setup.
+   */
+  [[nodiscard]] auto serialize_setup() const -> std::vector<std::uint8_t>;
+
+  /**
+   * @brief Creates an empty result sized for the options.
+   *
+   * @return The empty result.
+   */
+  [[nodiscard]] auto create_empty_result() const -> BankrollResult;
+
+  /**
+   * @brief Simulates a single player session.
+   *
+   * @param session_index The index of the session.
+   * @param card_dealer The dealer used to deal the session's shoes.
+   * @param session_strategy The strategy of the player, reset by the session.
+   * @param result The result to update.
+   */
+  void simulate_session(std::uint64_t session_index,
+                        CardDealer &card_dealer,
+                        BetStrategy &session_strategy,
+                        BankrollResult &result) const;
+
+  /**
+   * @brief Gets the balance histogram bin of a balance.
+   *
+   * @param balance The balance.
+   *
+   * @return The index of the bin.
+   */
+  [[nodiscard]] auto get_balance_bin(double balance) const -> std::size_t;
+
+  /**
+   * @brief Gets a percentile of a balance histogram.
+   *
+   * @param histogram The balance histogram.
+   * @param num_of_sessions The number of sessions in the histogram.
+   * @param percentile The percentile, from 0 to 1.
+   *
+   * @return The balance at the percentile, interpolated within its bin.
+   */
+  [[nodiscard]] auto
+  get_balance_percentile(const std::vector<std::uint64_t> &histogram,
+                         std::uint64_t num_of_sessions,
+                         double percentile) const -> double;
+};
+
+} // namespace BACCARAT
+
+#endif // BANKROLL_SIMULATOR_H
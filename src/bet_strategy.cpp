@@ -0,0 +1,171 @@
+#include "bet_strategy.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace BACCARAT
+{
+
+// CONSTRUCTORS
+
+BetStrategy::BetStrategy() = default;
+
+BetStrategy::BetStrategy(StrategyType strategy_type,
+                         BetType bet_type,
+                         double base_bet)
+    : strategy_type(strategy_type), bet_type(bet_type), base_bet(base_bet)
+{
+  reset_state();
+}
+
+// PUBLIC METHODS
+
+auto BetStrategy::from_string(const std::string &strategy_string,
+                              BetStrategy &strategy) -> bool
+{
+  static const std::array<std::string, 4> STRATEGY_TYPE_STRINGS = {
+      "FLAT", "FOLLOW", "CHOP", "MARTINGALE"};
+
+  // Split the string into TYPE, BET_TYPE and BASE_BET.
+  std::vector<std::string> parts;
+  std::stringstream string_stream(strategy_string);
+  std::string part;
+  while (std::getline(string_stream, part, ':'))
+  {
+    std::transform(part.begin(), part.end(), part.begin(),
+                   [](unsigned char part_char)
+                   { return std::toupper(part_char); });
+    parts.push_back(part);
+  }
+  if (parts.empty() || parts.size() > 3)
+  {
+    return false;
+  }
+
+  auto strategy_type_string = std::find(
+      STRATEGY_TYPE_STRINGS.begin(), STRATEGY_TYPE_STRINGS.end(), parts[0]);
+  if (strategy_type_string == STRATEGY_TYPE_STRINGS.end())
+  {
+    return false;
+  }
+  auto strategy_type = static_cast<StrategyType>(
+      std::distance(STRATEGY_TYPE_STRINGS.begin(), strategy_type_string));
+
+  BetType bet_type = BetType::BANKER;
+  if (parts.size() > 1)
+  {
+    if (parts[1] == "PLAYER")
+    {
+      bet_type = BetType::PLAYER;
+    }
+    else if (parts[1] == "BANKER")
+    {
+      bet_type = BetType::BANKER;
+    }
+    else if (parts[1] == "TIE")
+    {
+      bet_type = BetType::TIE;
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+  double base_bet = 1.0;
+  if (parts.size() > 2)
+  {
+    try
+    {
+      base_bet = std::stod(parts[2]);
+    }
+    catch (const std::logic_error &e)
+    {
+      return false;
+    }
+    if (base_bet <= 0.0)
+    {
+      return false;
+    }
+  }
+
+  strategy = BetStrategy(strategy_type, bet_type, base_bet);
+  return true;
+}
+
+auto BetStrategy::to_string() const -> std::string
+{
+  static const std::array<std::string, 4> STRATEGY_TYPE_STRINGS = {
+      "flat", "follow", "chop", "martingale"};
+
+  std::string bet_type_string = get_string_bet_type(bet_type);
+  std::transform(bet_type_string.begin(), bet_type_string.end(),
+                 bet_type_string.begin(),
+                 [](unsigned char bet_type_char)
+                 { return std::tolower(bet_type_char); });
+
+  std::ostringstream string_stream;
+  string_stream << STRATEGY_TYPE_STRINGS[static_cast<std::size_t>(
+                       strategy_type)]
+                << ":" << bet_type_string << ":" << base_bet;
+  return string_stream.str();
+}
+
+auto BetStrategy::get_next_bet_type() const -> BetType
+{
+  return next_bet_type;
+}
+
+auto BetStrategy::get_next_bet_amount() const -> double
+{
+  return next_bet_amount;
+}
+
+void BetStrategy::record_result(BetType outcome, double payout_multiplier)
+{
+  switch (strategy_type)
+  {
+  case StrategyType::FOLLOW:
+    // Ties do not change who the last winner was.
+    if (outcome != BetType::TIE)
+    {
+      next_bet_type = outcome;
+    }
+    break;
+  case StrategyType::CHOP:
+    if (outcome == BetType::PLAYER)
+    {
+      next_bet_type = BetType::BANKER;
+    }
+    else if (outcome == BetType::BANKER)
+    {
+      next_bet_type = BetType::PLAYER;
+    }
+    break;
+  case StrategyType::MARTINGALE:
+    // A pushed bet is neither a win nor a loss.
+    if (payout_multiplier > 1.0)
+    {
+      next_bet_amount = base_bet;
+    }
+    else if (payout_multiplier < 1.0)
+    {
+      next_bet_amount *= 2;
+    }
+    break;
+  default:
+    break;
+  }
+}
+
+void BetStrategy::reset_state()
+{
+  next_bet_type = bet_type;
+  next_bet_amount = base_bet;
+}
+
+} // namespace BACCARAT
@@ -0,0 +1,123 @@
+#ifndef BET_STRATEGY_H
+#define BET_STRATEGY_H
+
+#include "bet_type.h"
+
+#include <cstdint>
+#include <string>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief Enum class to represent the betting strategies that can be simulated.
+ */
+enum class StrategyType : std::uint8_t
+{
+  /// @brief Always bet the base bet on the same bet type.
+  FLAT,
+  /// @brief Bet the base bet on the winner of the last PLAYER or BANKER round.
+  FOLLOW,
+  /// @brief Bet the base bet against the winner of the last PLAYER or BANKER
+  /// round.
+  CHOP,
+  /// @brief Double the bet after every loss, return to the base bet after a
+  /// win.
+  MARTINGALE
+};
+
+/**
+ * @brief A class to decide the bets placed by a simulated player.
+ *
+ * @details The strategy decides the bet type and amount of the next bet, and
+ * is updated with the outcome of every round. The strategy state is reset with
+ * reset_state, e.g. at the start of a new shoe or session.
+ *
+ * @note A strategy is written as TYPE:BET_TYPE:BASE_BET, e.g. 'flat:banker',
+ * 'martingale:player:10' or 'follow'. The bet type is the first bet of the
+ * FOLLOW and CHOP strategies and the base bet defaults to 1.
+ */
+class BetStrategy
+{
+public:
+  /**
+   * @brief Default Constructor for the BetStrategy class, a flat banker bet.
+   */
+  BetStrategy();
+
+  /**
+   * @brief Constructor for the BetStrategy class.
+   *
+   * @param strategy_type The type of strategy.
+   * @param bet_type The bet type of the strategy.
+   * @param base_bet The amount of the base bet.
+   */
+  BetStrategy(StrategyType strategy_type, BetType bet_type, double base_bet);
+
+  /**
+   * @brief Creates a strategy from its string representation.
+   *
+   * @param strategy_string The strategy, e.g. 'martingale:player:10'.
+   * @param strategy The strategy to update.
+   *
+   * @return true if the string is a valid strategy, false otherwise.
+   */
+  static auto from_string(const std::string &strategy_string,
+                          BetStrategy &strategy) -> bool;
+
+  /**
+   * @brief Converts the strategy to its string representation.
+   *
+   * @return The string representation, e.g. 'martingale:player:10'.
+   */
+  [[nodiscard]] auto to_string() const -> std::string;
+
+  /**
+   * @brief Get the bet type of the next bet.
+   *
+   * @return The bet type of the next bet.
+   */
+  [[nodiscard]] auto get_next_bet_type() const -> BetType;
+
+  /**
+   * @brief Get the amount of the next bet.
+   *
+   * @return The amount of the next bet.
+   */
+  [[nodiscard]] auto get_next_bet_amount() const -> double;
+
+  /**
+   * @brief Updates the strategy with the result of the last bet.
+   *
+   * @param outcome The outcome of the round.
+   * @param payout_multiplier The amount returned per unit staked, see
+   * CardDealer::get_payout_multiplier.
+   */
+  void record_result(BetType outcome, double payout_multiplier);
+
+  /**
+   * @brief Resets the strategy to its first bet.
+   */
+  void reset_state();
+
+private:
+  /// @brief The type of strategy.
+  StrategyType strategy_type = StrategyType::FLAT;
+
+  /// @brief The bet type of a FLAT or MARTINGALE strategy, and the first bet
+  /// of a FOLLOW or CHOP strategy.
+  BetType bet_type = BetType::BANKER;
+
+  /// @brief The amount of the base bet.
+  double base_bet = 1.0;
+
+  /// @brief The bet type of the next bet.
+  BetType next_bet_type = BetType::BANKER;
+
+  /// @brief The amount of the next bet.
+  double next_bet_amount = 1.0;
+};
+
+} // namespace BACCARAT
+
+#endif // BET_STRATEGY_H
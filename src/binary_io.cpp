@@ -0,0 +1,193 @@
+#include "binary_io.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+#include <utility>
+
+namespace BACCARAT
+{
+
+// BINARY WRITER
+
+void BinaryWriter::write_u64(std::uint64_t value)
+{
+  for (int i = 0; i < 8; ++i)
+  {
+    buffer.push_back(static_cast<std::uint8_t>(value >> (8U * i)));
+  }
+}
+
+void BinaryWriter::write_u32(std::uint32_t value)
+{
+  for (int i = 0; i < 4; ++i)
+  {
+    buffer.push_back(static_cast<std::uint8_t>(value >> (8U * i)));
+  }
+}
+
+void BinaryWriter::write_i64(std::int64_t value)
+{
+  write_u64(static_cast<std::uint64_t>(value));
+}
+
+void BinaryWriter::write_double(double value)
+{
+  std::uint64_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  write_u64(bits);
+}
+
+void BinaryWriter::write_string(const std::string &value)
+{
+  write_u64(value.size());
+  buffer.insert(buffer.end(), value.begin(), value.end());
+}
+
+void BinaryWriter::write_bytes(const std::vector<std::uint8_t> &bytes)
+{
+  buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+}
+
+void BinaryWriter::write_u64_vector(const std::vector<std::uint64_t> &values)
+{
+  write_u64(values.size());
+  for (std::uint64_t value : values)
+  {
+    write_u64(value);
+  }
+}
+
+auto BinaryWriter::get_buffer() const -> const std::vector<std::uint8_t> &
+{
+  return buffer;
+}
+
+// BINARY READER
+
+BinaryReader::BinaryReader(std::vector<std::uint8_t> buffer)
+    : buffer(std::move(buffer))
+{
+}
+
+auto BinaryReader::read_u64(std::uint64_t &value) -> bool
+{
+  if (buffer.size() - position < 8)
+  {
+    return false;
+  }
+
+  value = 0;
+  for (int i = 0; i < 8; ++i)
+  {
+    value |= static_cast<std::uint64_t>(buffer[position++]) << (8U * i);
+  }
+  return true;
+}
+
+auto BinaryReader::read_i64(std::int64_t &value) -> bool
+{
+  std::uint64_t bits = 0;
+  if (!read_u64(bits))
+  {
+    return false;
+  }
+  value = static_cast<std::int64_t>(bits);
+  return true;
+}
+
+auto BinaryReader::read_double(double &value) -> bool
+{
+  std::uint64_t bits = 0;
+  if (!read_u64(bits))
+  {
+    return false;
+  }
+  std::memcpy(&value, &bits, sizeof(value));
+  return true;
+}
+
+auto BinaryReader::read_string(std::string &value) -> bool
+{
+  std::uint64_t size = 0;
+  if (!read_u64(size) || buffer.size() - position < size)
+  {
+    return false;
+  }
+  value.assign(buffer.begin() + static_cast<std::ptrdiff_t>(position),
+               buffer.begin() + static_cast<std::ptrdiff_t>(position + size));
+  position += size;
+  return true;
+}
+
+auto BinaryReader::read_bytes(std::size_t num_of_bytes,
+                              std::vector<std::uint8_t> &bytes) -> bool
+{
+  if (buffer.size() - position < num_of_bytes)
+  {
+    return false;
+  }
+  bytes.assign(
+      buffer.begin() + static_cast<std::ptrdiff_t>(position),
+      buffer.begin() + static_cast<std::ptrdiff_t>(position + num_of_bytes));
+  position += num_of_bytes;
+  return true;
+}
+
+auto BinaryReader::read_u64_vector(std::vector<std::uint64_t> &values) -> bool
+{
+  std::uint64_t size = 0;
+  if (!read_u64(size) || (buffer.size() - position) / 8 < size)
+  {
+    return false;
+  }
+  values.resize(size);
+  for (std::uint64_t &value : values)
+  {
+    read_u64(value);
+  }
+  return true;
+}
+
+auto BinaryReader::is_at_end() const -> bool
+{
+  return position == buffer.size();
+}
+
+// FILES
+
+auto write_file_atomically(const std::string &path,
+                           const std::vector<std::uint8_t> &buffer) -> bool
+{
+  std::string temporary_path = path + ".tmp";
+  {
+    std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(buffer.data()),
+               static_cast<std::streamsize>(buffer.size()));
+    if (!file)
+    {
+      return false;
+    }
+  }
+
+  std::error_code error_code;
+  std::filesystem::rename(temporary_path, path, error_code);
+  return !error_code;
+}
+
+auto read_file(const std::string &path,
+               std::vector<std::uint8_t> &buffer) -> bool
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+  {
+    return false;
+  }
+  buffer.assign(std::istreambuf_iterator<char>(file),
+                std::istreambuf_iterator<char>());
+  return !file.bad();
+}
+
+} // namespace BACCARAT
@@ -0,0 +1,195 @@
+#ifndef BINARY_IO_H
+#define BINARY_IO_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief A class to write values to a compact little endian binary buffer.
+ *
+ * @note Doubles are written bit for bit, so a value read back with
+ * BinaryReader is identical to the value written.
+ */
+class BinaryWriter
+{
+public:
+  /**
+   * @brief Writes an unsigned 64 bit integer.
+   *
+   * @param value The value to write.
+   */
+  void write_u64(std::uint64_t value);
+
+  /**
+   * @brief Writes an unsigned 32 bit integer.
+   *
+   * @param value The value to write.
+   */
+  void write_u32(std::uint32_t value);
+
+  /**
+   * @brief Writes a signed 64 bit integer.
+   *
+   * @param value The value to write.
+   */
+  void write_i64(std::int64_t value);
+
+  /**
+   * @brief Writes a double.
+   *
+   * @param value The value to write.
+   */
+  void write_double(double value);
+
+  /**
+   * @brief Writes a string, prefixed by its length.
+   *
+   * @param value The value to write.
+   */
+  void write_string(const std::string &value);
+
+  /**
+   * @brief Writes raw bytes, without a length prefix.
+   *
+   * @param bytes The bytes to write.
+   */
+  void write_bytes(const std::vector<std::uint8_t> &bytes);
+
+  /**
+   * @brief Writes a vector of unsigned 64 bit integers, prefixed by its size.
+   *
+   * @param values The values to write.
+   */
+  void write_u64_vector(const std::vector<std::uint64_t> &values);
+
+  /**
+   * @brief Get the bytes written so far.
+   *
+   * @return The buffer.
+   */
+  [[nodiscard]] auto get_buffer() const -> const std::vector<std::uint8_t> &;
+
+private:
+  /// @brief The bytes written so far.
+  std::vector<std::uint8_t> buffer;
+};
+
+/**
+ * @brief A class to read values written by BinaryWriter.
+ *
+ * @details Every read returns false once the end of the buffer is reached, so
+ * a truncated or corrupt file is detected rather than read past.
+ */
+class BinaryReader
+{
+public:
+  /**
+   * @brief Constructor for the BinaryReader class.
+   *
+   * @param buffer The bytes to read.
+   */
+  explicit BinaryReader(std::vector<std::uint8_t> buffer);
+
+  /**
+   * @brief Reads an unsigned 64 bit integer.
+   *
+   * @param value The value read.
+   *
+   * @return true if the value was read, false otherwise.
+   */
+  auto read_u64(std::uint64_t &value) -> bool;
+
+  /**
+   * @brief Reads a signed 64 bit integer.
+   *
+   * @param value The value read.
+   *
+   * @return true if the value was read, false otherwise.
+   */
+  auto read_i64(std::int64_t &value) -> bool;
+
+  /**
+   * @brief Reads a double.
+   *
+   * @param value The value read.
+   *
+   * @return true if the value was read, false otherwise.
+   */
+  auto read_double(double &value) -> bool;
+
+  /**
+   * @brief Reads a string written with write_string.
+   *
+   * @param value The value read.
+   *
+   * @return true if the value was read, false otherwise.
+   */
+  auto read_string(std::string &value) -> bool;
+
+  /**
+   * @brief Reads raw bytes.
+   *
+   * @param num_of_bytes The number of bytes to read.
+   * @param bytes The bytes read.
+   *
+   * @return true if the bytes were read, false otherwise.
+   */
+  auto read_bytes(std::size_t num_of_bytes,
+                  std::vector<std::uint8_t> &bytes) -> bool;
+
+  /**
+   * @brief Reads a vector written with write_u64_vector.
+   *
+   * @param values The values read.
+   *
+   * @return true if the values were read, false otherwise.
+   */
+  auto read_u64_vector(std::vector<std::uint64_t> &values) -> bool;
+
+  /**
+   * @brief Determines if every byte has been read.
+   *
+   * @return true if the end of the buffer has been reached.
+   */
+  [[nodiscard]] auto is_at_end() const -> bool;
+
+private:
+  /// @brief The bytes to read.
+  std::vector<std::uint8_t> buffer;
+
+  /// @brief The position of the next byte to read.
+  std::size_t position = 0;
+};
+
+/**
+ * @brief Writes a buffer to a file.
+ *
+ * @details The buffer is first written to a temporary file that then replaces
+ * the file, so an interrupted write never leaves a partial file behind.
+ *
+ * @param path The path of the file.
+ * @param buffer The bytes to write.
+ *
+ * @return true if the file was written, false otherwise.
+ */
+auto write_file_atomically(const std::string &path,
+                           const std::vector<std::uint8_t> &buffer) -> bool;
+
+/**
+ * @brief Reads a whole file.
+ *
+ * @param path The path of the file.
+ * @param buffer The bytes read.
+ *
+ * @return true if the file was read, false otherwise.
+ */
+auto read_file(const std::string &path,
+               std::vector<std::uint8_t> &buffer) -> bool;
+
+} // namespace BACCARAT
+
+#endif // BINARY_IO_H
@@ -1,5 +1,9 @@
 #include "card_dealer.h"
 
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
 namespace BACCARAT
 {
 
@@ -7,6 +11,14 @@ namespace BACCARAT
 
 CardDealer::CardDealer() { reset_deck(); }
 
+CardDealer::CardDealer(const RuleSet &rules, ShoeMode shoe_mode)
+    : rules(rules), shoe_mode(shoe_mode),
+      max_draws_per_card(CARDS_OF_EACH_TYPE_PER_DECK * rules.num_of_decks),
+      total_cards_in_deck(CARDS_PER_DECK * rules.num_of_decks)
+{
+  reset_deck();
+}
+
 // PUBLIC METHODS
 
 void CardDealer::play_round(BetType &outcome)
@@ -49,50 +61,173 @@ void CardDealer::deal_player_and_banker_cards(std::string &player_cards,
                                               int &player_hand_value,
                                               int &banker_hand_value)
 {
+  RoundResult round_result;
+  deal_round(round_result);
+
+  for (int i = 0; i < round_result.num_of_player_cards; ++i)
+  {
+    if (!player_cards.empty())
+    {
+      player_cards += ",";
+    }
+    player_cards += get_string_card_type(round_result.player_cards[i]);
+  }
+  for (int i = 0; i < round_result.num_of_banker_cards; ++i)
+  {
+    if (!banker_cards.empty())
+    {
+      banker_cards += ",";
+    }
+    banker_cards += get_string_card_type(round_result.banker_cards[i]);
+  }
+
+  player_hand_value = round_result.player_hand_value;
+  banker_hand_value = round_result.banker_hand_value;
+}
+
+void CardDealer::deal_round(RoundResult &round_result)
+{
+  round_result.num_of_player_cards = 0;
+  round_result.num_of_banker_cards = 0;
+  round_result.player_hand_value = 0;
+  round_result.banker_hand_value = 0;
+  if (antithetic_shoe != AntitheticShoe::NONE)
+  {
+    for (std::uint32_t &random_bits : round_random_bits)
+    {
+      random_bits = gen();
+    }
+  }
+
   // Deal the two cards to the player
-  deal_a_card(player_cards, player_hand_value);
-  deal_a_card(player_cards, player_hand_value);
+  deal_a_card(round_result, BetType::PLAYER);
+  deal_a_card(round_result, BetType::PLAYER);
 
   // Deal the two cards to the banker
-  deal_a_card(banker_cards, banker_hand_value);
-  deal_a_card(banker_cards, banker_hand_value);
+  deal_a_card(round_result, BetType::BANKER);
+  deal_a_card(round_result, BetType::BANKER);
 
   // Check if either player or banker has a natural hand (8 or 9). If so, no
   // more cards are to be drawn.
-  if (CardDealer::player_or_banker_has_natural_hand(player_hand_value,
-                                                    banker_hand_value))
+  if (!CardDealer::player_or_banker_has_natural_hand(
+          round_result.player_hand_value, round_result.banker_hand_value))
   {
-    return;
-  }
+    // Is used to determine if the banker can draw a third card. A value of -1
+    // indicates that the player did not draw a third card.
+    int player_third_card = -1;
+
+    // Check if the player can draw a third card
+    if (player_can_draw_third_card(round_result.player_hand_value))
+    {
+      player_third_card = deal_a_card(round_result, BetType::PLAYER);
+    }
 
-  // Is used to determine if the banker can draw a third card. A value of -1
-  // indicates that the player did not draw a third card.
-  int player_third_card = -1;
+    // Check if the banker can draw a third card
+    if (banker_can_draw_third_card(round_result.banker_hand_value,
+                                   player_third_card))
+    {
+      deal_a_card(round_result, BetType::BANKER);
+    }
+  }
 
-  // Check if the player can draw a third card
-  if (player_hand_value <= THRESHOLD_FOR_THIRD_CARD)
+  // Determine the winner.
+  if (round_result.player_hand_value > round_result.banker_hand_value)
+  {
+    round_result.outcome = BetType::PLAYER;
+  }
+  else if (round_result.banker_hand_value > round_result.player_hand_value)
   {
-    player_third_card = deal_a_card(player_cards, player_hand_value);
+    round_result.outcome = BetType::BANKER;
+  }
+  else
+  {
+    round_result.outcome = BetType::TIE;
   }
 
-  // Check if the banker can draw a third card
-  if (banker_can_draw_third_card(banker_hand_value, player_third_card))
+  if (shoe_mode == ShoeMode::CONTINUOUS_SHUFFLE)
   {
-    deal_a_card(banker_cards, banker_hand_value);
+    return_cards_to_shoe(round_result);
   }
 }
 
 void CardDealer::reset_deck()
 {
+  pick_up_discards();
   drawn_card_counter.fill(0);
   total_cards_drawn = 0;
+  remaining_cards.fill(max_draws_per_card);
+  discard_rack.clear();
+  log_tilt_ratio = 0.0;
 
   // Initialize the random number generator with a new random seed
   // using std::random_device
   std::random_device my_random_device;
   gen = std::mt19937(my_random_device());
+  shoe_shuffler.shuffle(ordered_shoe, gen);
+}
+
+void CardDealer::reset_deck(std::uint64_t shoe_seed)
+{
+  pick_up_discards();
+  drawn_card_counter.fill(0);
+  total_cards_drawn = 0;
+  remaining_cards.fill(max_draws_per_card);
+  discard_rack.clear();
+  log_tilt_ratio = 0.0;
+
+  // Seed the random number generator with both halves of the shoe seed, so
+  // the same seed always deals the same shoe.
+  std::seed_seq seed_sequence = {
+      static_cast<std::uint32_t>(shoe_seed),
+      static_cast<std::uint32_t>(shoe_seed >> 32U)};
+  gen.seed(seed_sequence);
+  shoe_shuffler.shuffle(ordered_shoe, gen);
+}
+
+void CardDealer::set_antithetic(AntitheticShoe antithetic_shoe)
+{
+  this->antithetic_shoe = antithetic_shoe;
+}
+
+void CardDealer::set_continuous_shuffle_delay(int num_of_rounds)
+{
+  continuous_shuffle_delay = num_of_rounds;
+}
+
+void CardDealer::set_shuffle_model(ShuffleModel shuffle_model,
+                                   int num_of_passes)
+{
+  ordered_shoe.clear();
+  shoe_shuffler = ShoeShuffler();
+  if (shuffle_model == ShuffleModel::RANDOM ||
+      shoe_mode != ShoeMode::FINITE_SHOE)
+  {
+    return;
+  }
+  shoe_shuffler = ShoeShuffler(shuffle_model, num_of_passes);
+
+  // New decks come out of the box sorted from A to K.
+  for (int i = 0; i < total_cards_in_deck; ++i)
+  {
+    ordered_shoe.push_back(static_cast<std::uint8_t>(i % NUM_OF_UNIQUE_CARDS));
+  }
+  drawn_card_counter.fill(0);
+  total_cards_drawn = 0;
+  remaining_cards.fill(max_draws_per_card);
 }
 
+void CardDealer::set_rank_tilt(std::shared_ptr<const RankTilt> rank_tilt)
+{
+  this->rank_tilt = std::move(rank_tilt);
+}
+
+void CardDealer::set_rank_tilt_enabled(bool enabled)
+{
+  rank_tilt_enabled = enabled;
+}
+
+auto CardDealer::get_log_tilt_ratio() const -> double { return log_tilt_ratio; }
+
 void CardDealer::print_drawn_card_counter()
 {
   printf("\nDrawn Card Counter:\n");
@@ -105,14 +240,27 @@ void CardDealer::print_drawn_card_counter()
 
 // PRIVATE METHODS
 
-auto CardDealer::deal_a_card(std::string &cards, int &hand_value) -> int
+auto CardDealer::deal_a_card(RoundResult &round_result, BetType hand) -> int
 {
-  int card_type = draw_card();
-  if (!cards.empty())
-  {
-    cards += ",";
-  }
-  cards += get_string_card_type(card_type);
+  bool is_player = hand == BetType::PLAYER;
+  std::array<int, MAX_CARDS_DRAWN> &cards =
+      is_player ? round_result.player_cards : round_result.banker_cards;
+  int &num_of_cards = is_player ? round_result.num_of_player_cards
+                                : round_result.num_of_banker_cards;
+  int &hand_value = is_player ? round_result.player_hand_value
+                              : round_result.banker_hand_value;
+
+  // The mirrored shoe of a pair deals each hand the card the other hand got.
+  bool draws_as_player =
+      is_player != (antithetic_shoe == AntitheticShoe::MIRRORED);
+  int draw_index = (draws_as_player ? 0 : MAX_CARDS_DRAWN) + num_of_cards;
+  int card_type = draw_card(RankTilt::get_deal_state(
+                                hand, num_of_cards,
+                                round_result.player_hand_value,
+                                round_result.banker_hand_value),
+                            draw_index);
+  cards[num_of_cards] = card_type;
+  ++num_of_cards;
 
   // Hand value is the last digit of the sum of the card values.
   // This is to ensure that the hand value is between 0 and 9.
@@ -121,6 +269,16 @@ auto CardDealer::deal_a_card(std::string &cards, int &hand_value) -> int
   return card_type;
 }
 
+auto CardDealer::get_card_value(int card_type) -> int
+{
+  return CARD_VALUES[card_type];
+}
+
+auto CardDealer::player_can_draw_third_card(int player_hand_value) -> bool
+{
+  return player_hand_value <= THRESHOLD_FOR_THIRD_CARD;
+}
+
 auto CardDealer::banker_can_draw_third_card(int banker_hand_value,
                                             int player_third_card) -> bool
 {
@@ -147,9 +305,33 @@ auto CardDealer::player_or_banker_has_natural_hand(
       banker_hand_value == NATURAL_EIGHT || banker_hand_value == NATURAL_NINE);
 }
 
-auto CardDealer::draw_card() -> int
+auto CardDealer::draw_card(int deal_state, int draw_index) -> int
 {
-  if (total_cards_drawn >= TOTAL_CARDS_IN_DECK)
+  if (shoe_mode == ShoeMode::INFINITE_DECK)
+  {
+    // Every card type is equally likely on every draw, so there is no shoe
+    // state to update.
+    int card_type = 0;
+    if (rank_tilt_enabled)
+    {
+      card_type = draw_tilted_card_type(deal_state);
+    }
+    else if (antithetic_shoe != AntitheticShoe::NONE)
+    {
+      card_type = draw_uniform_position(NUM_OF_UNIQUE_CARDS, draw_index);
+    }
+    else
+    {
+      card_type = dist(gen);
+    }
+    if (rank_tilt)
+    {
+      add_to_log_tilt_ratio(card_type, deal_state);
+    }
+    return card_type;
+  }
+
+  if (total_cards_drawn >= total_cards_in_deck)
   {
     // There are no more cards left to draw.
     printf(
@@ -157,31 +339,151 @@ auto CardDealer::draw_card() -> int
     reset_deck();
   }
 
-  // Draw a random number to represent the card type
-  // The range is from 0 to 12 (13 unique cards)
-  int card_type = dist(gen);
+  int card_type = 0;
+  if (!ordered_shoe.empty())
+  {
+    // An ordered shoe is dealt from the top.
+    card_type = ordered_shoe[total_cards_drawn];
+  }
+  else if (rank_tilt_enabled)
+  {
+    card_type = draw_tilted_card_type(deal_state);
+  }
+  else
+  {
+    // Pick one of the remaining cards uniformly, then find its card type.
+    int card_position = draw_uniform_position(
+        remaining_cards.get_total_weight(), draw_index);
+    card_type = remaining_cards.find(card_position);
+  }
+  if (rank_tilt && ordered_shoe.empty())
+  {
+    add_to_log_tilt_ratio(card_type, deal_state);
+  }
+
+  remaining_cards.add(card_type, -1);
+  ++drawn_card_counter[card_type];
+  ++total_cards_drawn;
+  return card_type;
+}
 
-  // This is to prevent an infinite loop.
-  int number_of_cards_checked = 0;
+auto CardDealer::draw_tilted_card_type(int deal_state) -> int
+{
+  std::array<double, NUM_OF_UNIQUE_CARDS> tilted_counts = {};
+  double total_tilted_count = get_tilted_counts(deal_state, tilted_counts);
 
-  // Check if the card has already been drawn 32 times
-  // If so, increment the random number until a valid card is found.
-  while (number_of_cards_checked < NUM_OF_UNIQUE_CARDS)
+  double position =
+      std::uniform_real_distribution<double>(0.0, total_tilted_count)(gen);
+  int card_type = NUM_OF_UNIQUE_CARDS - 1;
+  for (int i = 0; i < NUM_OF_UNIQUE_CARDS; ++i)
   {
-    if (drawn_card_counter[card_type] < MAX_DRAWS_PER_CARD)
+    if (position < tilted_counts[i])
     {
-      ++total_cards_drawn;
-      ++drawn_card_counter[card_type];
-      return card_type;
+      card_type = i;
+      break;
     }
-    card_type = (card_type + 1) % NUM_OF_UNIQUE_CARDS;
-    number_of_cards_checked++;
+    position -= tilted_counts[i];
+  }
+
+  // Guard against rounding past the last card type that is left.
+  while (tilted_counts[card_type] <= 0.0)
+  {
+    --card_type;
+  }
+  return card_type;
+}
+
+void CardDealer::add_to_log_tilt_ratio(int card_type, int deal_state)
+{
+  std::array<double, NUM_OF_UNIQUE_CARDS> tilted_counts = {};
+  double total_tilted_count = get_tilted_counts(deal_state, tilted_counts);
+  int num_of_cards_remaining = shoe_mode == ShoeMode::INFINITE_DECK
+                                   ? NUM_OF_UNIQUE_CARDS
+                                   : total_cards_in_deck - total_cards_drawn;
+
+  // The fair probability is count / remaining and the tilted probability is
+  // weight * count / total_tilted_count, so the count cancels out.
+  const std::array<double, NUM_OF_UNIQUE_CARDS> &weights =
+      rank_tilt->weights[deal_state];
+  log_tilt_ratio += std::log(weights[card_type] * num_of_cards_remaining /
+                             total_tilted_count);
+}
+
+auto CardDealer::get_tilted_counts(
+    int deal_state,
+    std::array<double, NUM_OF_UNIQUE_CARDS> &tilted_counts) const -> double
+{
+  const std::array<double, NUM_OF_UNIQUE_CARDS> &weights =
+      rank_tilt->weights[deal_state];
+
+  bool infinite_deck = shoe_mode == ShoeMode::INFINITE_DECK;
+  double total_tilted_count = 0.0;
+  for (int i = 0; i < NUM_OF_UNIQUE_CARDS; ++i)
+  {
+    int num_of_cards = infinite_deck
+                           ? 1
+                           : max_draws_per_card - drawn_card_counter[i];
+    tilted_counts[i] = weights[i] * num_of_cards;
+    total_tilted_count += tilted_counts[i];
+  }
+  return total_tilted_count;
+}
+
+auto CardDealer::draw_uniform_position(int num_of_positions, int draw_index)
+    -> int
+{
+  if (antithetic_shoe == AntitheticShoe::NONE)
+  {
+    return ShoeShuffler::draw_uniform_position(gen, num_of_positions);
   }
 
-  // NOTE: Unreachable code. If there are no cards left to draw, we shouldn't
-  // have reached this point.
-  BREAKPOINT;
-  return -1;
+  // Lemire's method on the bits drawn for the card. The rare low products
+  // that would bias the position are drawn again from the generator, which
+  // keeps the position exactly uniform at the cost of the pairing.
+  auto range = static_cast<std::uint32_t>(num_of_positions);
+  std::uint64_t product =
+      static_cast<std::uint64_t>(round_random_bits[draw_index]) * range;
+  if (static_cast<std::uint32_t>(product) < (0U - range) % range)
+  {
+    return ShoeShuffler::draw_uniform_position(gen, num_of_positions);
+  }
+  return static_cast<int>(product >> 32U);
+}
+
+void CardDealer::return_cards_to_shoe(const RoundResult &round_result)
+{
+  discard_rack.push_back(round_result);
+  while (static_cast<int>(discard_rack.size()) > continuous_shuffle_delay)
+  {
+    const RoundResult &returned_round = discard_rack.front();
+    auto return_cards = [&](const std::array<int, MAX_CARDS_DRAWN> &cards,
+                            int num_of_cards)
+    {
+      for (int i = 0; i < num_of_cards; ++i)
+      {
+        remaining_cards.add(cards[i], 1);
+        --drawn_card_counter[cards[i]];
+        --total_cards_drawn;
+      }
+    };
+    return_cards(returned_round.player_cards,
+                 returned_round.num_of_player_cards);
+    return_cards(returned_round.banker_cards,
+                 returned_round.num_of_banker_cards);
+    discard_rack.pop_front();
+  }
+}
+
+void CardDealer::pick_up_discards()
+{
+  if (ordered_shoe.empty())
+  {
+    return;
+  }
+
+  // The discard rack is picked up with the last card dealt on top, and the
+  // cards behind the cut card stay underneath it in their order.
+  std::reverse(ordered_shoe.begin(), ordered_shoe.begin() + total_cards_drawn);
 }
 
 auto CardDealer::get_string_card_type(const int &card_type) -> std::string
@@ -192,52 +494,72 @@ auto CardDealer::get_string_card_type(const int &card_type) -> std::string
   return INT_TO_STRING_CARD_TYPE_MAP[card_type];
 }
 
-void CardDealer::pay_out_bets(const BetType &outcome, CasinoPlayer &player)
+void CardDealer::pay_out_bets(const BetType &outcome,
+                              CasinoPlayer &player,
+                              const RuleSet &rules)
 {
   if (player.get_current_bet_type() == BetType::NONE)
   {
-    printf("\nNo bet placed.\n");
+    if (player.is_verbose())
+    {
+      printf("\nNo bet placed.\n");
+    }
     return;
   }
 
-  if (player.get_current_bet_type() != outcome)
+  double payout_multiplier =
+      get_payout_multiplier(outcome, player.get_current_bet_type(), rules);
+  if (payout_multiplier <= 0.0)
   {
-    printf("\nBet lost. No payout.\n");
-    return;
+    if (player.is_verbose())
+    {
+      printf("\nBet lost. No payout.\n");
+    }
+  }
+  else if (player.get_current_bet_amount() > 0)
+  {
+    // Player's bet amount and winnings are added to the balance.
+    player.add_to_balance(player.get_current_bet_amount() * payout_multiplier);
   }
 
-  switch (outcome)
+  // The bet has been settled, so it cannot be paid out again.
+  player.clear_bet();
+}
+
+auto CardDealer::get_payout_multiplier(const BetType &outcome,
+                                       const BetType &bet_type,
+                                       const RuleSet &rules) -> double
+{
+  if (bet_type == BetType::NONE)
   {
-  case BetType::PLAYER:
-    if (player.get_current_bet_amount() > 0)
+    return 0.0;
+  }
+
+  if (bet_type != outcome)
+  {
+    // PLAYER and BANKER bets may be returned on a tie, depending on the rules.
+    if (outcome == BetType::TIE && rules.push_on_tie)
     {
-      // Player wins, payout is 1:1
-      // Player's bet amount is added to the balance
-      player.add_to_balance(player.get_current_bet_amount() *
-                            (PAYOUT_PLAYER + 1));
+      return 1.0;
     }
-    break;
+    return 0.0;
+  }
+
+  switch (outcome)
+  {
+  case BetType::PLAYER:
+    // Player wins, payout is 1:1
+    return rules.payout_player + 1;
   case BetType::BANKER:
-    if (player.get_current_bet_amount() > 0)
-    {
-      // Banker wins, payout is 1:1 - 5% commission
-      // Player's bet amount is added to the balance
-      player.add_to_balance(player.get_current_bet_amount() *
-                            (PAYOUT_BANKER - PAYOUT_BANKER_COMMISSION + 1));
-    }
-    break;
+    // Banker wins, payout is 1:1 - 5% commission
+    return rules.payout_banker - rules.banker_commission + 1;
   case BetType::TIE:
-    if (player.get_current_bet_amount() > 0)
-    {
-      // Tie wins, payout is 8:1
-      // Player's bet amount is added to the balance
-      player.add_to_balance(player.get_current_bet_amount() * (PAYOUT_TIE + 1));
-    }
-    break;
+    // Tie wins, payout is 8:1
+    return rules.payout_tie + 1;
   default:
     // Invalid bet type, unreachable code.
     BREAKPOINT;
-    break;
+    return 0.0;
   }
 }
 
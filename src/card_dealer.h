@@ -8,12 +8,24 @@
               << __func__ << "\n";                                             \
   }
 
+#include "antithetic_shoe.h"
 #include "bet_type.h"
 #include "casino_player.h"
+#include "rank_sampler.h"
+#include "rank_tilt.h"
+#include "round_result.h"
+#include "rule_set.h"
+#include "shoe_mode.h"
+#include "shoe_shuffler.h"
+#include "shuffle_model.h"
 #include <array>
+#include <cstdint>
+#include <deque>
 #include <iostream>
+#include <memory>
 #include <random>
 #include <string>
+#include <vector>
 
 namespace BACCARAT
 {
@@ -23,8 +35,11 @@ namespace BACCARAT
  * @details The Baccarat class handles the initialization and dealing of cards
  * for a game of Baccarat.
  *
- * @remarks The class simulates the game with 8 decks of cards for a true
- * Baccarat experience.
+ * @remarks By default the class simulates the game with 8 decks of cards for a
+ * true Baccarat experience. The number of decks and payouts are taken from the
+ * RuleSet, and the ShoeMode selects between a depleting shoe, an infinite
+ * deck where every draw is independent, and a continuous shuffling machine
+ * where the cards of each round are returned to the shoe.
  *
  * @note See 'https://en.wikipedia.org/wiki/Baccarat' for more
  * information about the rules of Baccarat.
@@ -37,6 +52,15 @@ public:
    */
   CardDealer();
 
+  /**
+   * @brief Constructor for the CardDealer class.
+   *
+   * @param rules The table rules, used for the number of decks in the shoe.
+   * @param shoe_mode How cards are drawn from the shoe.
+   */
+  explicit CardDealer(const RuleSet &rules,
+                      ShoeMode shoe_mode = ShoeMode::FINITE_SHOE);
+
   /**
    * @brief Handles a round of Baccarat.
    *
@@ -64,6 +88,17 @@ public:
                                     int &player_hand_value,
                                     int &banker_hand_value);
 
+  /**
+   * @brief Deals a round of Baccarat without printing anything.
+   *
+   * @details This is the dealing kernel used by play_round and by the batch
+   * simulations, it draws the cards using Baccarat rules and determines the
+   * winner.
+   *
+   * @param round_result The cards, hand values and outcome of the round.
+   */
+  void deal_round(RoundResult &round_result);
+
   /**
    * @brief Resets the deck of cards when all cards have been drawn.
    *
@@ -72,6 +107,103 @@ public:
    */
   void reset_deck();
 
+  /**
+   * @brief Resets the deck of cards and seeds the shuffle.
+   *
+   * @details The same shoe seed always deals the same shoe, which allows
+   * different configurations to be simulated on identical shoes.
+   *
+   * @param shoe_seed The seed for the random number generator.
+   */
+  void reset_deck(std::uint64_t shoe_seed);
+
+  /**
+   * @brief Sets the part the shoe plays in an antithetic pair.
+   *
+   * @details Both shoes of a pair draw the random bits of all six cards a
+   * round could deal at the start of every round, so they stay in step
+   * however many cards their rounds deal. The mirrored shoe deals the player
+   * the cards drawn with the bits of the banker cards and the other way
+   * around. Its hands mostly swap, so a round the banker wins in one shoe is
+   * mostly won by the player in the other, which reduces the variance of the
+   * BANKER and PLAYER bets and of their differences. Each shoe on its own is
+   * dealt fairly. An ordered shoe is dealt the same in both.
+   *
+   * @param antithetic_shoe The part the shoe plays.
+   */
+  void set_antithetic(AntitheticShoe antithetic_shoe);
+
+  /**
+   * @brief Sets how long the cards of a round stay out of a continuous
+   * shuffling machine.
+   *
+   * @details In CONTINUOUS_SHUFFLE mode the cards of each round are put in a
+   * discard rack, and are returned to the shoe once the given number of
+   * further rounds have been dealt. A delay of 0 returns the cards as soon as
+   * the round is over.
+   *
+   * @param num_of_rounds The number of rounds the cards wait before they are
+   * returned to the shoe.
+   */
+  void set_continuous_shuffle_delay(int num_of_rounds);
+
+  /**
+   * @brief Sets how the dealer shuffles a FINITE_SHOE.
+   *
+   * @details With any model but RANDOM the shoe is kept as an ordered stack
+   * of cards that are dealt from the top. The dealer starts with new decks in
+   * factory order, and every reset picks up the discards, the last card dealt
+   * on top, puts them on the cards behind the cut card and shuffles that
+   * stack with the model, so the order left by one shoe carries into the
+   * next. The rank tilt is not used by an ordered shoe, and other shoe modes
+   * ignore the shuffle model.
+   *
+   * @param shuffle_model How the shoe is shuffled.
+   * @param num_of_passes The number of riffles, strip cuts or passes through
+   * the machine.
+   */
+  void set_shuffle_model(ShuffleModel shuffle_model, int num_of_passes);
+
+  /**
+   * @brief Sets the weights of a tilted shoe, for importance sampling of rare
+   * events.
+   *
+   * @details Once a tilt is set the tilt ratio of every card drawn is
+   * accumulated, see get_log_tilt_ratio, and set_rank_tilt_enabled selects
+   * whether the cards are drawn from the tilted shoe or the fair shoe. The
+   * tilt is shared rather than copied, as it holds the weights of every deal
+   * state and many dealers deal with the same tilt.
+   *
+   * @param rank_tilt The weights of each card type, see RankTilt.
+   */
+  void set_rank_tilt(std::shared_ptr<const RankTilt> rank_tilt);
+
+  /**
+   * @brief Sets whether the cards drawn next are drawn from the tilted shoe.
+   *
+   * @details The tilt can be switched between any two cards, e.g. a rare
+   * event simulation only tilts the rounds of a single streak. The antithetic
+   * setting is ignored while the tilt is enabled.
+   *
+   * @param enabled true to draw from the tilted shoe, false to draw from the
+   * fair shoe.
+   */
+  void set_rank_tilt_enabled(bool enabled);
+
+  /**
+   * @brief Gets the log of the tilt ratio of the cards drawn since the deck
+   * was last reset.
+   *
+   * @details The tilt ratio of a card is the probability of drawing it from
+   * the tilted shoe over the probability of drawing it from the fair shoe,
+   * given the cards remaining when it was drawn. It is accumulated whether or
+   * not the tilt was enabled, so the likelihood ratio of any tilted part of a
+   * shoe can be worked out once the shoe has been dealt.
+   *
+   * @return The sum of the log tilt ratios, 0 if no tilt is set.
+   */
+  [[nodiscard]] auto get_log_tilt_ratio() const -> double;
+
   /**
    * @brief Prints the drawn card counter.
    *
@@ -86,25 +218,117 @@ public:
    * @brief Pays out the bets to the player.
    *
    * @details This function simulates paying out the bets to the player based on
-   * the outcome of the game.
+   * the outcome of the game. The player's bet is cleared once it is settled.
    *
    * @param player The player to pay out the bets to.
+   * @param rules The table rules used to settle the bet.
    */
-  static void pay_out_bets(const BetType &outcome, CasinoPlayer &player);
+  static void pay_out_bets(const BetType &outcome,
+                           CasinoPlayer &player,
+                           const RuleSet &rules = RuleSet());
+
+  /**
+   * @brief Gets the amount returned to a bet for each unit staked.
+   *
+   * @details A losing bet returns 0, a pushed bet returns 1 and a winning bet
+   * returns the stake plus the payout, e.g. 1.95 for a winning banker bet.
+   *
+   * @param outcome The outcome of the round.
+   * @param bet_type The type of bet that was placed.
+   * @param rules The table rules used to settle the bet.
+   *
+   * @return The amount returned per unit staked.
+   */
+  [[nodiscard]] static auto get_payout_multiplier(
+      const BetType &outcome, const BetType &bet_type, const RuleSet &rules)
+      -> double;
+
+  /**
+   * @brief Gets the Baccarat value of a card type.
+   *
+   * @param card_type The card type, see get_string_card_type method.
+   *
+   * @return The value of the card, from 0 to 9.
+   */
+  [[nodiscard]] static auto get_card_value(int card_type) -> int;
+
+  /**
+   * @brief Converts the card type to a string.
+   *
+   * @details This function maps an int to a string representation of the card.
+   *
+   * @example 0 is "A", 1 is "2", 2 is "3", ..., 9 is "10", 10 is "J",
+   * 11 is "Q", and 12 is "K".
+   *
+   * @param card_type The card type to convert.
+   *
+   * @return The string representation of the card type.
+   */
+  static auto get_string_card_type(const int &card_type) -> std::string;
+
+  /**
+   * @brief Determines if the player can draw a third card.
+   *
+   * @param player_hand_value The value of the player's first two cards.
+   *
+   * @return true if the player can draw a third card, false otherwise.
+   */
+  [[nodiscard]] static auto
+  player_can_draw_third_card(int player_hand_value) -> bool;
+
+  /**
+   * @brief Determines if the banker can draw a third card.
+   *
+   * @param banker_hand_value The value of the banker's hand.
+   * @param player_third_card The card type of the player's third card, or -1
+   * if the player did not draw a third card.
+   *
+   * @return true if the banker can draw a third card, false otherwise.
+   */
+  [[nodiscard]] static auto
+  banker_can_draw_third_card(int banker_hand_value,
+                             int player_third_card) -> bool;
+
+  /**
+   * @brief Determines if the player or banker has a natural hand.
+   *
+   * @param player_hand_value The value of the player's hand.
+   * @param banker_hand_value The value of the banker's hand.
+   *
+   * @return true if either the player or banker has a natural hand, false
+   * otherwise.
+   */
+  [[nodiscard]] static auto
+  player_or_banker_has_natural_hand(const int &player_hand_value,
+                                    const int &banker_hand_value) -> bool;
 
-private:
   /// @brief The number of unique cards in a standard deck used in Baccarat.
   static constexpr int NUM_OF_UNIQUE_CARDS = 13;
 
-  /// @brief The maximum number of times a card can be drawn from the deck.
-  /// @note Baccarat uses 8 decks of cards, each deck has 4 cards of each type,
-  /// hence the maximum number of times a card can be drawn is 32 (8 x 4).
-  static constexpr int MAX_DRAWS_PER_CARD = 32;
+  /// @brief The number of cards of each type in a single deck.
+  static constexpr int CARDS_OF_EACH_TYPE_PER_DECK = 4;
+
+  /// @brief The number of cards in a single deck.
+  static constexpr int CARDS_PER_DECK = 52;
+
+private:
+  /// @brief The table rules used by this dealer.
+  RuleSet rules;
+
+  /// @brief How cards are drawn from the shoe.
+  ShoeMode shoe_mode = ShoeMode::FINITE_SHOE;
+
+  /// @brief The maximum number of cards of each type in the shoe.
+  /// @note Baccarat uses 8 decks of cards by default, each deck has 4 cards of
+  /// each type, hence the maximum number of times a card can be drawn is 32
+  /// (8 x 4).
+  int max_draws_per_card =
+      CARDS_OF_EACH_TYPE_PER_DECK * RuleSet().num_of_decks;
 
   /// @brief The total number of cards in a shoe used in Baccarat.
-  /// @details There are 8 decks of cards, each deck has 52 cards, hence the
-  /// total number of cards in a deck is 416 (8 x 52).
-  static constexpr int TOTAL_CARDS_IN_DECK = 416;
+  /// @details There are 8 decks of cards by default, each deck has 52 cards,
+  /// hence the total number of cards in a deck is 416 (8 x 52).
+  int total_cards_in_deck = CARDS_PER_DECK * RuleSet().num_of_decks;
 
   /// @brief The maximum number of cards that can be drawn from the deck for the
   /// player and banker.
@@ -148,20 +372,11 @@ private:
   static constexpr std::array<int, 13> CARD_VALUES = {1, 2, 3, 4, 5, 6, 7,
                                                       8, 9, 0, 0, 0, 0};
 
-  /// @brief The payout for a tie bet.
-  static constexpr double PAYOUT_TIE = 8.0;
-
-  /// @brief The payout for a banker bet.
-  static constexpr double PAYOUT_BANKER = 1.0;
-
-  /// @brief The payout for a player bet.
-  static constexpr double PAYOUT_PLAYER = 1.0;
-
-  /// @brief The commission for a banker.
-  static constexpr double PAYOUT_BANKER_COMMISSION = 0.05;
-
   /// @brief Keeps track of how many times each card has been drawn.
-  /// @note Each card can be drawn a maximum of 32 times (4 decks of 8 cards).
+  /// @note Each card can be drawn a maximum of 32 times (8 decks of 4 cards).
+  /// @note The counter is not used in INFINITE_DECK mode, and in
+  /// CONTINUOUS_SHUFFLE mode it counts the cards that have not yet been
+  /// returned to the shoe.
   /// @note The index represents the card type. See get_string_card_type method
   /// for more information.
   std::array<int, NUM_OF_UNIQUE_CARDS> drawn_card_counter = {};
@@ -169,9 +384,48 @@ private:
   /// @brief The number of cards drawn from the deck.
   int total_cards_drawn = 0;
 
+  /// @brief The number of cards of each type remaining in the shoe, used to
+  /// draw every card in exact proportion to the cards remaining.
+  RankSampler<int> remaining_cards;
+
+  /// @brief The rounds whose cards have not yet been returned to the shoe of
+  /// a continuous shuffling machine, oldest first.
+  std::deque<RoundResult> discard_rack;
+
+  /// @brief The number of rounds the cards of a round wait in the discard
+  /// rack before they are returned to a continuous shuffling machine.
+  int continuous_shuffle_delay = 0;
+
+  /// @brief The card types of the shoe in the order they are dealt, the
+  /// cards drawn so far first. Empty unless a shuffle model is set, see
+  /// set_shuffle_model.
+  std::vector<std::uint8_t> ordered_shoe;
+
+  /// @brief Shuffles the ordered shoe.
+  ShoeShuffler shoe_shuffler;
+
   /// @brief Random number generator for drawing cards.
   std::mt19937 gen;
 
+  /// @brief The part the shoe plays in an antithetic pair, see
+  /// set_antithetic.
+  AntitheticShoe antithetic_shoe = AntitheticShoe::NONE;
+
+  /// @brief The random bits of every card the current round could deal, the
+  /// player cards first, drawn at the start of the round of a paired shoe.
+  std::array<std::uint32_t, 2 * MAX_CARDS_DRAWN> round_random_bits = {};
+
+  /// @brief If true, cards are drawn with the weights of rank_tilt.
+  bool rank_tilt_enabled = false;
+
+  /// @brief The weights of each card type, null unless set with
+  /// set_rank_tilt.
+  std::shared_ptr<const RankTilt> rank_tilt;
+
+  /// @brief The log of the tilt ratio of the cards drawn since the deck was
+  /// last reset, see get_log_tilt_ratio.
+  double log_tilt_ratio = 0.0;
+
   /// @brief Random number distribution for drawing cards.
   /// @note The range is from 0 to NUM_OF_UNIQUE_CARDS - 1.
   std::uniform_int_distribution<> dist =
@@ -183,63 +437,95 @@ private:
    * @details This function simulates dealing cards to the player or banker and
    * will update the cards and hand value.
    *
-   * @param cards The cards dealt to either the player or banker.
-   * @param hand_value The value of the hand of either the player or banker.
+   * @param round_result The round being dealt, the cards and hand value of
+   * the hand dealt to are updated.
+   * @param hand The hand dealt to, either PLAYER or BANKER.
    *
    * @return The card type dealt.
    */
-  auto deal_a_card(std::string &cards, int &hand_value) -> int;
+  auto deal_a_card(RoundResult &round_result, BetType hand) -> int;
 
   /**
-   * @brief Determines if the banker can draw a third card.
+   * @brief Draws a card from the deck.
    *
-   * @param banker_hand_value The value of the banker's hand.
-   * @param player_third_card The value of the player's third card.
+   * @details This function simulates drawing a card from the deck using random
+   * number generation. Each card type is drawn in exact proportion to the
+   * number of cards of that type remaining. In INFINITE_DECK mode every draw is
+   * independent and the drawn card counter is not updated.
    *
-   * @return true if the banker can draw a third card, false otherwise.
+   * @param deal_state The deal state of the card, used by the rank tilt, see
+   * RankTilt::get_deal_state.
+   * @param draw_index The index of the random bits of the card in
+   * round_random_bits, used by a paired shoe.
+   *
+   * @return The card drawn from the deck. The card type is represented by an
+   * int, see get_string_card_type method for more information.
+   *
+   * @note The deck is reset if there are no cards left to draw.
    */
-  static auto banker_can_draw_third_card(int banker_hand_value,
-                                         int player_third_card) -> bool;
+  auto draw_card(int deal_state, int draw_index) -> int;
 
   /**
-   * @brief Determines if the player or banker has a natural hand.
+   * @brief Draws the type of a card with the weights of the rank tilt.
    *
-   * @param player_hand_value The value of the player's hand.
-   * @param banker_hand_value The value of the banker's hand.
+   * @param deal_state The deal state of the card.
    *
-   * @return true if either the player or banker has a natural hand, false
-   * otherwise.
+   * @return The card type drawn.
    */
-  static auto
-  player_or_banker_has_natural_hand(const int &player_hand_value,
-                                    const int &banker_hand_value) -> bool;
+  auto draw_tilted_card_type(int deal_state) -> int;
 
   /**
-   * @brief Draws a card from the deck.
+   * @brief Adds the log tilt ratio of a card that is about to be removed from
+   * the shoe.
    *
-   * @details This function simulates drawing a card from the deck using random
-   * number generation.
+   * @param card_type The card type drawn.
+   * @param deal_state The deal state of the card.
+   */
+  void add_to_log_tilt_ratio(int card_type, int deal_state);
+
+  /**
+   * @brief Gets the number of cards of each type remaining, multiplied by the
+   * weights of the rank tilt.
    *
-   * @return The card drawn from the deck. The card type is represented by an
-   * int, see get_string_card_type method for more information.
+   * @details An infinite deck counts as a shoe with one card of each type.
+   *
+   * @param deal_state The deal state of the card.
+   * @param tilted_counts The tilted count of each card type.
    *
-   * @note Returns -1 if there are no cards left to draw.
+   * @return The sum of the tilted counts.
    */
-  auto draw_card() -> int;
+  auto get_tilted_counts(int deal_state,
+                         std::array<double, NUM_OF_UNIQUE_CARDS> &tilted_counts)
+      const -> double;
 
   /**
-   * @brief Converts the card type to a string.
+   * @brief Draws a uniformly random position.
    *
-   * @details This function maps an int to a string representation of the card.
+   * @details A paired shoe uses the random bits drawn for the card at the
+   * start of the round, see set_antithetic.
    *
-   * @example 0 is "A", 1 is "2", 2 is "3", ..., 9 is "10", 10 is "J",
-   * 11 is "Q", and 12 is "K".
+   * @param num_of_positions The number of positions, must be positive.
+   * @param draw_index The index of the random bits of the card in
+   * round_random_bits.
    *
-   * @param card_type The card type to convert.
+   * @return A position from 0 to num_of_positions - 1.
+   */
+  auto draw_uniform_position(int num_of_positions, int draw_index) -> int;
+
+  /**
+   * @brief Moves the cards of a round to the discard rack of a continuous
+   * shuffling machine, and returns the cards that have waited long enough to
+   * the shoe.
    *
-   * @return The string representation of the card type.
+   * @param round_result The round that was just dealt.
    */
-  static auto get_string_card_type(const int &card_type) -> std::string;
+  void return_cards_to_shoe(const RoundResult &round_result);
+
+  /**
+   * @brief Picks up the discards of an ordered shoe and puts them on the
+   * cards behind the cut card, the last card dealt on top.
+   */
+  void pick_up_discards();
 };
 } // namespace BACCARAT
 
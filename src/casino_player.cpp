@@ -5,21 +5,33 @@ namespace BACCARAT
 
 CasinoPlayer::CasinoPlayer() = default;
 
-void CasinoPlayer::place_bet(BetType bet_type, double amount)
+CasinoPlayer::CasinoPlayer(double starting_balance, bool verbose)
+    : balance(starting_balance), verbose(verbose)
+{
+}
+
+auto CasinoPlayer::place_bet(BetType bet_type, double amount) -> bool
 {
   if (amount > balance)
   {
-    printf("\nInsufficient balance to place the bet. Balance: %.2f\n\n",
-           balance);
-    return;
+    if (verbose)
+    {
+      printf("\nInsufficient balance to place the bet. Balance: %.2f\n\n",
+             balance);
+    }
+    return false;
   }
 
   current_bet_type = bet_type;
   current_bet_amount = amount;
   balance -= amount;
 
-  printf("\nBet placed: %s %.2f\n\n", get_string_bet_type(bet_type).c_str(),
-         amount);
+  if (verbose)
+  {
+    printf("\nBet placed: %s %.2f\n\n", get_string_bet_type(bet_type).c_str(),
+           amount);
+  }
+  return true;
 }
 
 auto CasinoPlayer::check_balance() const -> double { return balance; }
@@ -37,7 +49,18 @@ auto CasinoPlayer::get_current_bet_amount() const -> double
 void CasinoPlayer::add_to_balance(double amount)
 {
   balance += amount;
-  printf("\nBalance updated: %.2f\n", balance);
+  if (verbose)
+  {
+    printf("\nBalance updated: %.2f\n", balance);
+  }
 }
 
+void CasinoPlayer::clear_bet()
+{
+  current_bet_type = BetType::NONE;
+  current_bet_amount = 0.0;
+}
+
+auto CasinoPlayer::is_verbose() const -> bool { return verbose; }
+
 } // namespace BACCARAT
\ No newline at end of file
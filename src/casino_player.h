@@ -19,6 +19,15 @@ class CasinoPlayer
 public:
   CasinoPlayer();
 
+  /**
+   * @brief Constructor for the CasinoPlayer class.
+   *
+   * @param starting_balance The balance the player starts with.
+   * @param verbose If false, the player does not print bets and balance
+   * updates, e.g. when simulating many sessions.
+   */
+  CasinoPlayer(double starting_balance, bool verbose);
+
   ~CasinoPlayer() = default;
 
   /**
@@ -26,8 +35,10 @@ public:
    *
    * @param bet_type The type of bet to place (PLAYER, BANKER, TIE).
    * @param amount The amount to bet.
+   *
+   * @return true if the bet was placed, false if the balance is insufficient.
    */
-  void place_bet(BetType bet_type, double amount);
+  auto place_bet(BetType bet_type, double amount) -> bool;
 
   /**
    * @brief Check the player's balance.
@@ -57,6 +68,18 @@ public:
    */
   void add_to_balance(double amount);
 
+  /**
+   * @brief Clears the current bet once it has been settled.
+   */
+  void clear_bet();
+
+  /**
+   * @brief Check if the player prints bets and balance updates.
+   *
+   * @return true if the player is verbose, false otherwise.
+   */
+  [[nodiscard]] auto is_verbose() const -> bool;
+
 private:
   /// @brief The starting balance for the player.
   static constexpr double STARTING_BALANCE = 5000.0;
@@ -71,6 +94,9 @@ private:
   /// @brief The current bet amount placed by the player.
   /// @note Default is 0.0.
   double current_bet_amount = 0.0;
+
+  /// @brief If false, the player does not print bets and balance updates.
+  bool verbose = true;
 };
 
 } // namespace BACCARAT
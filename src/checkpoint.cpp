@@ -0,0 +1,93 @@
+#include "checkpoint.h"
+#include "binary_io.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <utility>
+
+namespace BACCARAT
+{
+
+// CONSTRUCTORS
+
+Checkpoint::Checkpoint(CheckpointOptions options,
+                       std::vector<std::uint8_t> setup)
+    : options(std::move(options)), setup(std::move(setup))
+{
+}
+
+// PUBLIC METHODS
+
+auto Checkpoint::is_enabled() const -> bool { return !options.path.empty(); }
+
+auto Checkpoint::can_resume() const -> bool
+{
+  std::error_code error_code;
+  return is_enabled() && options.resume &&
+         std::filesystem::exists(options.path, error_code);
+}
+
+auto Checkpoint::is_due() const -> bool
+{
+  std::chrono::duration<double> time_since_last_write =
+      std::chrono::steady_clock::now() - last_write_time;
+  return is_enabled() &&
+         time_since_last_write.count() >= options.interval_seconds;
+}
+
+auto Checkpoint::write(std::uint64_t next_chunk_index,
+                       const std::vector<std::uint8_t> &state) -> bool
+{
+  last_write_time = std::chrono::steady_clock::now();
+
+  BinaryWriter writer;
+  writer.write_u64(CHECKPOINT_MAGIC);
+  writer.write_u64(setup.size());
+  writer.write_bytes(setup);
+  writer.write_u64(next_chunk_index);
+  writer.write_u64(state.size());
+  writer.write_bytes(state);
+
+  if (!write_file_atomically(options.path, writer.get_buffer()))
+  {
+    printf("Failed to write checkpoint '%s'.\n", options.path.c_str());
+    return false;
+  }
+  return true;
+}
+
+auto Checkpoint::read(std::uint64_t &next_chunk_index,
+                      std::vector<std::uint8_t> &state) const -> bool
+{
+  std::vector<std::uint8_t> buffer;
+  if (!read_file(options.path, buffer))
+  {
+    printf("Failed to read checkpoint '%s'.\n", options.path.c_str());
+    return false;
+  }
+
+  BinaryReader reader(std::move(buffer));
+  std::uint64_t magic = 0;
+  std::uint64_t setup_size = 0;
+  std::vector<std::uint8_t> checkpoint_setup;
+  std::uint64_t state_size = 0;
+  if (!reader.read_u64(magic) || magic != CHECKPOINT_MAGIC ||
+      !reader.read_u64(setup_size) ||
+      !reader.read_bytes(setup_size, checkpoint_setup) ||
+      !reader.read_u64(next_chunk_index) || !reader.read_u64(state_size) ||
+      !reader.read_bytes(state_size, state) || !reader.is_at_end())
+  {
+    printf("'%s' is not a valid checkpoint.\n", options.path.c_str());
+    return false;
+  }
+
+  if (checkpoint_setup != setup)
+  {
+    printf("Checkpoint '%s' was written by a different simulation setup.\n",
+           options.path.c_str());
+    return false;
+  }
+  return true;
+}
+
+} // namespace BACCARAT
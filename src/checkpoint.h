@@ -0,0 +1,113 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief The checkpoint options of a long running simulation.
+ */
+struct CheckpointOptions
+{
+  /// @brief The path of the checkpoint file, empty to disable checkpoints.
+  std::string path;
+
+  /// @brief The number of seconds between checkpoints.
+  double interval_seconds = 60.0;
+
+  /// @brief If true, continue from the checkpoint file if it exists.
+  bool resume = false;
+};
+
+/**
+ * @brief A class to periodically save and restore the state of a simulation.
+ *
+ * @details Simulations are split into chunks that are merged in order, so the
+ * state of a simulation is the index of the next chunk to merge and the
+ * merged results. The random number generator, shoe and strategy states are
+ * all seeded from the chunk index, so no state of a chunk in progress needs to
+ * be saved and a resumed simulation finishes with bit identical results.
+ *
+ * @note The setup of the simulation (seed, rules, strategies and options) is
+ * stored in the checkpoint, and a checkpoint can only be resumed by the same
+ * setup.
+ */
+class Checkpoint
+{
+public:
+  /**
+   * @brief Constructor for the Checkpoint class.
+   *
+   * @param options The checkpoint options.
+   * @param setup The serialized setup of the simulation.
+   */
+  Checkpoint(CheckpointOptions options, std::vector<std::uint8_t> setup);
+
+  /**
+   * @brief Determines if checkpoints are enabled.
+   *
+   * @return true if a checkpoint path was given, false otherwise.
+   */
+  [[nodiscard]] auto is_enabled() const -> bool;
+
+  /**
+   * @brief Determines if the simulation should be resumed from a checkpoint.
+   *
+   * @return true if resume was requested and the checkpoint file exists.
+   */
+  [[nodiscard]] auto can_resume() const -> bool;
+
+  /**
+   * @brief Determines if the next checkpoint is due.
+   *
+   * @return true if checkpoints are enabled and the interval has passed since
+   * the last checkpoint.
+   */
+  [[nodiscard]] auto is_due() const -> bool;
+
+  /**
+   * @brief Writes a checkpoint.
+   *
+   * @param next_chunk_index The index of the next chunk to merge.
+   * @param state The serialized results merged so far.
+   *
+   * @return true if the checkpoint was written, false otherwise.
+   */
+  auto write(std::uint64_t next_chunk_index,
+             const std::vector<std::uint8_t> &state) -> bool;
+
+  /**
+   * @brief Reads the checkpoint.
+   *
+   * @param next_chunk_index The index of the next chunk to merge.
+   * @param state The serialized results merged so far.
+   *
+   * @return true if the checkpoint was read and matches the setup, false
+   * otherwise.
+   */
+  auto read(std::uint64_t &next_chunk_index,
+            std::vector<std::uint8_t> &state) const -> bool;
+
+private:
+  /// @brief Identifies a checkpoint file, the ASCII string "BACCKPT2".
+  static constexpr std::uint64_t CHECKPOINT_MAGIC = 0x3254504B43434142ULL;
+
+  /// @brief The checkpoint options.
+  CheckpointOptions options;
+
+  /// @brief The serialized setup of the simulation.
+  std::vector<std::uint8_t> setup;
+
+  /// @brief When the last checkpoint was written, or the simulation started.
+  std::chrono::steady_clock::time_point last_write_time =
+      std::chrono::steady_clock::now();
+};
+
+} // namespace BACCARAT
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,121 @@
+#ifndef CHUNK_RUNNER_H
+#define CHUNK_RUNNER_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief Gets the number of worker threads to use.
+ *
+ * @param num_of_threads The requested number of threads, 0 to use every core.
+ * @param num_of_chunks The number of chunks of work, no more threads than
+ * chunks are used.
+ *
+ * @return The number of worker threads, at least 1.
+ */
+[[nodiscard]] inline auto
+get_num_of_worker_threads(int num_of_threads,
+                          std::uint64_t num_of_chunks) -> int
+{
+  if (num_of_threads <= 0)
+  {
+    num_of_threads =
+        std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+  return static_cast<int>(std::min<std::uint64_t>(
+      num_of_threads, std::max<std::uint64_t>(num_of_chunks, 1)));
+}
+
+/**
+ * @brief Runs chunks of work on a pool of worker threads and merges their
+ * results in order.
+ *
+ * @details Workers take the next chunk index from a shared counter and call
+ * simulate_chunk, which must only use state owned by the chunk. The calling
+ * thread calls merge_chunk for every chunk in increasing chunk index order, so
+ * the merged result does not depend on the number of threads or on which
+ * worker finished first.
+ *
+ * @param first_chunk_index The index of the first chunk to run.
+ * @param num_of_chunks The index one past the last chunk to run.
+ * @param num_of_threads The number of worker threads, 0 to use every core.
+ * @param simulate_chunk Called as simulate_chunk(chunk_index) on a worker
+ * thread, returns the ChunkResult of the chunk.
+ * @param merge_chunk Called as merge_chunk(chunk_index, chunk_result) on the
+ * calling thread.
+ */
+template <typename ChunkResult, typename SimulateChunk, typename MergeChunk>
+void run_chunks_in_order(std::uint64_t first_chunk_index,
+                         std::uint64_t num_of_chunks,
+                         int num_of_threads,
+                         SimulateChunk simulate_chunk,
+                         MergeChunk merge_chunk)
+{
+  if (first_chunk_index >= num_of_chunks)
+  {
+    return;
+  }
+
+  std::atomic<std::uint64_t> next_chunk_index = first_chunk_index;
+  std::mutex finished_chunks_mutex;
+  std::condition_variable chunk_finished;
+  std::map<std::uint64_t, ChunkResult> finished_chunks;
+
+  auto worker = [&]()
+  {
+    for (std::uint64_t chunk_index = next_chunk_index++;
+         chunk_index < num_of_chunks; chunk_index = next_chunk_index++)
+    {
+      ChunkResult chunk_result = simulate_chunk(chunk_index);
+
+      std::lock_guard<std::mutex> lock(finished_chunks_mutex);
+      finished_chunks.emplace(chunk_index, std::move(chunk_result));
+      chunk_finished.notify_one();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  int num_of_workers = get_num_of_worker_threads(
+      num_of_threads, num_of_chunks - first_chunk_index);
+  workers.reserve(num_of_workers);
+  for (int i = 0; i < num_of_workers; ++i)
+  {
+    workers.emplace_back(worker);
+  }
+
+  // Merge the chunks in order, so the result does not depend on which worker
+  // finished first.
+  for (std::uint64_t chunk_index = first_chunk_index;
+       chunk_index < num_of_chunks; ++chunk_index)
+  {
+    ChunkResult chunk_result;
+    {
+      std::unique_lock<std::mutex> lock(finished_chunks_mutex);
+      chunk_finished.wait(lock, [&]()
+                          { return finished_chunks.count(chunk_index) > 0; });
+      auto finished_chunk = finished_chunks.find(chunk_index);
+      chunk_result = std::move(finished_chunk->second);
+      finished_chunks.erase(finished_chunk);
+    }
+    merge_chunk(chunk_index, chunk_result);
+  }
+
+  for (std::thread &worker_thread : workers)
+  {
+    worker_thread.join();
+  }
+}
+
+} // namespace BACCARAT
+
+#endif // CHUNK_RUNNER_H
@@ -0,0 +1,1339 @@
+#include "command_line.h"
+#include "shoe_analysis.h"
+#include "shoe_index.h"
+#include "shoe_log.h"
+#include "shoe_query.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace BACCARAT
+{
+
+// CONSTRUCTORS
+
+CommandLine::CommandLine(const std::vector<std::string> &args)
+{
+  if (args.empty())
+  {
+    return;
+  }
+
+  subcommand = args[0];
+  for (std::size_t i = 1; i < args.size(); ++i)
+  {
+    const std::string &arg = args[i];
+    if (arg.rfind("--", 0) != 0)
+    {
+      positional_args.push_back(arg);
+      continue;
+    }
+
+    // An option is followed by its value, unless it is a flag.
+    std::string name = arg.substr(2);
+    if (i + 1 < args.size() && args[i + 1].rfind("--", 0) != 0)
+    {
+      options[name] = args[++i];
+    }
+    else
+    {
+      options[name] = "true";
+    }
+  }
+}
+
+// PUBLIC METHODS
+
+auto CommandLine::run() -> int
+{
+  if (!check_options())
+  {
+    return 1;
+  }
+  if (subcommand == "analyze")
+  {
+    return run_analyze();
+  }
+  if (subcommand == "batch")
+  {
+    return run_simulation(1);
+  }
+  if (subcommand == "compare")
+  {
+    return run_simulation(2);
+  }
+  if (subcommand == "ruin")
+  {
+    return run_ruin();
+  }
+  if (subcommand == "rare")
+  {
+    return run_rare();
+  }
+  if (subcommand == "floor")
+  {
+    return run_floor();
+  }
+  if (subcommand == "sweep")
+  {
+    return run_sweep();
+  }
+  if (subcommand == "merge")
+  {
+    return run_merge();
+  }
+  if (subcommand == "live")
+  {
+    return run_live();
+  }
+  if (subcommand == "record")
+  {
+    return run_record();
+  }
+  if (subcommand == "build-index")
+  {
+    return run_build_index();
+  }
+  if (subcommand == "query")
+  {
+    return run_query();
+  }
+  if (subcommand == "help" || subcommand == "--help")
+  {
+    print_usage();
+    return 0;
+  }
+
+  printf("Unknown command '%s'.\n\n", subcommand.c_str());
+  print_usage();
+  return 1;
+}
+
+// PRIVATE METHODS
+
+void CommandLine::print_usage()
+{
+  printf("Usage: baccarat [command] [options]\n\n"
+         "Run without a command to play the interactive game.\n\n"
+         "Commands:\n"
+         "  analyze    Compare exact finite shoe and infinite deck odds\n"
+         "  batch      Simulate strategies over many shoes\n"
+         "  compare    Simulate strategies on identical shoes and report\n"
+         "             the paired difference in EV\n"
+         "  ruin       Simulate player sessions of a strategy and report the\n"
+         "             risk of ruin and balance trajectories\n"
+         "  rare       Estimate the probability of a rare event with\n"
+         "             importance sampling\n"
+         "  floor      Simulate the tables of a casino floor over time and\n"
+         "             report hands and revenue per hour\n"
+         "  sweep      Simulate every combination of parameter values and\n"
+         "             write a single results table\n"
+         "  merge      Combine the shard files of a sharded batch or\n"
+         "             compare into the result of a single run\n"
+         "  live       Print the live stats of a running batch, compare or\n"
+         "             sweep\n"
+         "  record     Deal shoes and archive their cards to a shoe log\n"
+         "  build-index Build the columnar index of a shoe log\n"
+         "  query      Find the shoes and hands of an index that match\n"
+         "             filters\n"
+         "  help       Print this message\n\n"
+         "Strategies for batch and compare are given as arguments in the\n"
+         "form TYPE:BET_TYPE:BASE_BET followed by optional rule overrides,\n"
+         "e.g. 'flat:banker', 'martingale:player:10' or\n"
+         "'flat:tie,tie-payout=9'. TYPE is flat, follow, chop or martingale.\n\n"
+         "Simulation options:\n"
+         "  --shoes N              Number of shoes to deal (default 10000)\n"
+         "  --seed N               Master seed (default 1)\n"
+         "  --penetration X        Fraction of the shoe dealt (default 0.9)\n"
+         "  --threads N            Worker threads (default every core)\n"
+         "  --antithetic           Pair every shoe with a shoe where the\n"
+         "                         player and banker swap cards, the number\n"
+         "                         of shoes must be even\n"
+         "  --infinite-deck        Deal from an infinite deck\n"
+         "  --csm                  Deal from a continuous shuffling machine\n"
+         "  --csm-delay N          Rounds before cards return to the machine\n"
+         "                         (default 0)\n"
+         "  --shuffle MODEL[:N]    Shuffle the shoe with N passes of random,\n"
+         "                         riffle (default 7), strip (default 4) or\n"
+         "                         machine (default 1), carrying the order\n"
+         "                         of each shoe into the next\n"
+         "  --checkpoint FILE      Save progress to FILE periodically\n"
+         "  --checkpoint-interval S Seconds between checkpoints (default 60)\n"
+         "  --resume               Continue from the checkpoint if it exists\n"
+         "  --live-stats NAME      Publish running counters to shared memory\n"
+         "  --shard I/N            Deal shard I of N of batch or compare,\n"
+         "                         split into chunks of 256 shoes\n"
+         "  --shard-output FILE    Shard results file (default\n"
+         "                         shard-I-of-N.bin)\n"
+         "  --packed               Deal the shoes of batch and compare in\n"
+         "                         lockstep from 32 byte shoe states\n\n"
+         "Ruin options (also --seed, --penetration, --threads,\n"
+         "--infinite-deck and the checkpoint options), the strategy\n"
+         "defaults to flat:banker:100:\n"
+         "  --sessions N           Number of sessions (default 100000)\n"
+         "  --balance X            Starting balance (default 5000)\n"
+         "  --table-min X          Minimum bet (default 10)\n"
+         "  --table-max X          Maximum bet (default no limit)\n"
+         "  --stop-loss X          Leave after losing X (default off)\n"
+         "  --stop-win X           Leave after winning X (default off)\n"
+         "  --session-length N     Most rounds in a session (default 1000)\n\n"
+         "Rare events are given as an argument in the form TYPE:TARGET,\n"
+         "e.g. 'banker-streak:12', 'tie-streak:4' or 'dragon7:3'. TYPE is\n"
+         "banker-streak, player-streak, tie-streak, dragon7 or panda8.\n"
+         "Rare options (also --seed, --penetration, --threads and the shoe\n"
+         "modes), the probability is per shoe:\n"
+         "  --shoes N              Number of shoes (default 100000)\n"
+         "  --pilot-runs N         Runs that tune the tilt (default 5)\n"
+         "  --pilot-shoes N        Shoes in each pilot run (default 10000)\n"
+         "  --elite-fraction X     Fraction of pilot shoes the tilt is tuned\n"
+         "                         on (default 0.1)\n"
+         "  --player-tilt W,...    Initial weights of A to K for the player,\n"
+         "                         instead of the exact tilt of every deal\n"
+         "  --banker-tilt W,...    Initial weights of A to K for the banker,\n"
+         "                         instead of the exact tilt of every deal\n\n"
+         "Floor options (also --seed, --penetration, --threads, the shoe\n"
+         "modes, --balance, --table-min and --table-max), the strategy of\n"
+         "every player defaults to flat:banker:100:\n"
+         "  --tables N             Number of tables (default 100)\n"
+         "  --seats N              Seats at every table (default 7)\n"
+         "  --hours X              Hours the floor is open (default 8)\n"
+         "  --arrivals X           Players arriving at a table per hour\n"
+         "                         (default 30)\n"
+         "  --stay X               Mean minutes a player stays (default 45)\n"
+         "  --shuffle-time S       Seconds to shuffle a shoe (default 300)\n"
+         "  --card-time S          Seconds to deal a card (default 2)\n"
+         "  --squeeze-time S       Mean seconds to squeeze a round\n"
+         "                         (default 10)\n"
+         "  --settle-time S        Seconds to settle a bet (default 2)\n"
+         "  --output FILE          Per table results, CSV if FILE ends in\n"
+         "                         .csv, otherwise columnar binary\n\n"
+         "Sweep parameters are given as arguments in the form NAME=V1,V2,...\n"
+         "where NAME is a rule option, penetration or strategy, e.g.\n"
+         "'baccarat sweep decks=6,8 tie-payout=8,9 strategy=flat:tie'.\n"
+         "Sweeps take the simulation options and:\n"
+         "  --output FILE          Results table, CSV if FILE ends in .csv,\n"
+         "                         otherwise columnar binary (default\n"
+         "                         sweep.csv)\n\n"
+         "Live stats are read with 'baccarat live NAME', which prints them\n"
+         "once, or takes:\n"
+         "  --follow               Print them until the simulation finishes\n"
+         "  --interval S           Seconds between prints (default 1)\n\n"
+         "Shoe logs are written with 'baccarat record [LOG]', which takes\n"
+         "--shoes, --seed, --penetration, the shoe modes and:\n"
+         "  --output FILE          Shoe log, instead of LOG (default\n"
+         "                         shoes.log)\n"
+         "'baccarat build-index LOG' indexes a log and takes:\n"
+         "  --output FILE          Index (default LOG.idx)\n"
+         "'baccarat query INDEX FILTER...' takes filters on shoe features,\n"
+         "e.g. 'player-streak>=10' or 'ties=0', and on hands, e.g.\n"
+         "'banker-draw', 'player-third=7' or 'not:tie', and:\n"
+         "  --limit N              Most matches to list (default 20)\n\n"
+         "Rule options:\n"
+         "  --decks N              Number of decks in the shoe (default 8)\n"
+         "  --player-payout X      Payout for a player bet (default 1)\n"
+         "  --banker-payout X      Payout for a banker bet (default 1)\n"
+         "  --commission X         Commission on a banker win (default 0.05)\n"
+         "  --tie-payout X         Payout for a tie bet (default 8)\n"
+         "  --push-on-tie          Return PLAYER and BANKER bets on a tie\n");
+}
+
+auto CommandLine::run_analyze() -> int
+{
+  RuleSet rules;
+  if (!parse_rule_set(rules))
+  {
+    return 1;
+  }
+
+  ShoeAnalysis::print_comparison_report(rules);
+  return 0;
+}
+
+auto CommandLine::run_simulation(std::size_t min_num_of_configs) -> int
+{
+  RuleSet rules;
+  SimulationOptions simulation_options;
+  std::vector<SimulationConfig> configs;
+  if (!parse_rule_set(rules) ||
+      !parse_simulation_options(simulation_options) ||
+      !parse_shard_options(simulation_options) ||
+      !parse_packed_option(rules, simulation_options) ||
+      !parse_simulation_configs(rules, configs))
+  {
+    return 1;
+  }
+  if (configs.size() < min_num_of_configs)
+  {
+    printf("At least %zu strategies are needed.\n", min_num_of_configs);
+    return 1;
+  }
+  simulation_options.compare = min_num_of_configs > 1;
+
+  Simulation simulation(configs, simulation_options);
+  SimulationResult result;
+  if (!simulation.run(result))
+  {
+    return 1;
+  }
+  simulation.print_result(result, simulation_options.compare);
+  return 0;
+}
+
+auto CommandLine::run_ruin() -> int
+{
+  RuleSet rules;
+  BankrollOptions bankroll_options;
+  if (!parse_rule_set(rules) || !parse_bankroll_options(bankroll_options))
+  {
+    return 1;
+  }
+
+  std::string strategy_string =
+      positional_args.empty() ? "flat:banker:100" : positional_args[0];
+  BetStrategy strategy;
+  if (positional_args.size() > 1 ||
+      !BetStrategy::from_string(strategy_string, strategy))
+  {
+    printf("Invalid strategy '%s', a single strategy is needed.\n",
+           strategy_string.c_str());
+    return 1;
+  }
+
+  BankrollSimulator bankroll_simulator(rules, strategy, bankroll_options);
+  BankrollResult result;
+  if (!bankroll_simulator.run(result))
+  {
+    return 1;
+  }
+  bankroll_simulator.print_result(result);
+  return 0;
+}
+
+auto CommandLine::run_floor() -> int
+{
+  RuleSet rules;
+  FloorOptions floor_options;
+  std::string output_path;
+  if (!parse_rule_set(rules) || !parse_floor_options(floor_options) ||
+      !get_option("output", output_path))
+  {
+    return 1;
+  }
+
+  std::string strategy_string =
+      positional_args.empty() ? "flat:banker:100" : positional_args[0];
+  BetStrategy strategy;
+  if (positional_args.size() > 1 ||
+      !BetStrategy::from_string(strategy_string, strategy))
+  {
+    printf("Invalid strategy '%s', a single strategy is needed.\n",
+           strategy_string.c_str());
+    return 1;
+  }
+
+  FloorSimulator floor_simulator(rules, strategy, floor_options);
+  FloorResult result;
+  floor_simulator.run(result);
+  floor_simulator.print_result(result);
+  if (!output_path.empty() &&
+      !floor_simulator.write_result(result, output_path))
+  {
+    return 1;
+  }
+  return 0;
+}
+
+auto CommandLine::run_rare() -> int
+{
+  RuleSet rules;
+  RareEventOptions rare_event_options;
+  if (!parse_rule_set(rules) || !parse_rare_event_options(rare_event_options))
+  {
+    return 1;
+  }
+
+  RareEvent event;
+  if (positional_args.size() != 1 ||
+      !RareEvent::from_string(positional_args[0], event))
+  {
+    printf("A single rare event is needed, e.g. 'banker-streak:12'.\n");
+    return 1;
+  }
+
+  RareEventSimulation rare_event_simulation(event, rules, rare_event_options);
+  RareEventResult result;
+  rare_event_simulation.run(result);
+  rare_event_simulation.print_result(result);
+  return 0;
+}
+
+auto CommandLine::run_sweep() -> int
+{
+  RuleSet rules;
+  SimulationOptions simulation_options;
+  std::vector<SweepPoint> points;
+  std::string output_path = "sweep.csv";
+  if (!parse_rule_set(rules) ||
+      !parse_simulation_options(simulation_options) ||
+      !get_option("output", output_path) ||
+      !parse_sweep_points(rules, simulation_options.penetration, points))
+  {
+    return 1;
+  }
+
+  ParameterSweep parameter_sweep(points, simulation_options);
+  return parameter_sweep.run(output_path) ? 0 : 1;
+}
+
+auto CommandLine::run_merge() -> int
+{
+  if (positional_args.empty())
+  {
+    printf("At least one shard file is needed.\n");
+    return 1;
+  }
+
+  std::vector<SimulationConfig> configs;
+  SimulationOptions simulation_options;
+  SimulationResult result;
+  if (!Simulation::merge_shards(positional_args, configs, simulation_options,
+                                result))
+  {
+    return 1;
+  }
+
+  Simulation simulation(configs, simulation_options);
+  simulation.print_result(result, simulation_options.compare);
+  return 0;
+}
+
+auto CommandLine::run_live() -> int
+{
+  double interval_seconds = 1.0;
+  if (!get_option("interval", interval_seconds))
+  {
+    return 1;
+  }
+  if (positional_args.size() != 1)
+  {
+    printf("The name the live stats are published under is needed.\n");
+    return 1;
+  }
+
+  const std::string &name = positional_args[0];
+  LiveStatsReader live_stats_reader;
+  if (!live_stats_reader.open(name))
+  {
+    printf("No live stats are published under '%s'.\n", name.c_str());
+    return 1;
+  }
+
+  // Reading never blocks the simulation, a read that keeps racing the writer
+  // is simply tried again at the next interval.
+  bool follow = has_option("follow");
+  LiveStats live_stats;
+  while (true)
+  {
+    if (live_stats_reader.read(live_stats))
+    {
+      print_live_stats(name, live_stats);
+      if (!follow || live_stats.finished != 0)
+      {
+        return 0;
+      }
+    }
+    else if (!follow)
+    {
+      printf("The live stats of '%s' could not be read.\n", name.c_str());
+      return 1;
+    }
+    std::this_thread::sleep_for(
+        std::chrono::duration<double>(std::max(interval_seconds, 0.01)));
+  }
+}
+
+void CommandLine::print_live_stats(const std::string &name,
+                                   const LiveStats &live_stats)
+{
+  printf("\n--- Live Stats '%s' (%s) ---\n\n", name.c_str(),
+         live_stats.finished != 0 ? "finished" : "running");
+  printf("Shoes: %llu of %llu\nRounds: %llu\nElapsed: %.1f s\n"
+         "Rounds/s: %.0f\n\n",
+         static_cast<unsigned long long>(live_stats.num_of_shoes),
+         static_cast<unsigned long long>(live_stats.num_of_shoes_to_deal),
+         static_cast<unsigned long long>(live_stats.num_of_rounds),
+         live_stats.elapsed_seconds, live_stats.rounds_per_second);
+
+  auto num_of_rounds = static_cast<double>(
+      std::max<std::uint64_t>(live_stats.num_of_rounds, 1));
+  for (std::size_t i = 0; i < live_stats.outcome_counts.size(); ++i)
+  {
+    printf("%-8s %14llu %12.8f\n",
+           get_string_bet_type(static_cast<BetType>(i)).c_str(),
+           static_cast<unsigned long long>(live_stats.outcome_counts[i]),
+           static_cast<double>(live_stats.outcome_counts[i]) / num_of_rounds);
+  }
+
+  printf("\nCards  %s\n", "     A     2     3     4     5     6     7     8"
+                           "     9    10     J     Q     K");
+  std::uint64_t num_of_cards = 0;
+  for (std::uint64_t card_count : live_stats.card_counts)
+  {
+    num_of_cards += card_count;
+  }
+  printf("%-6s ", "%");
+  for (std::uint64_t card_count : live_stats.card_counts)
+  {
+    printf("%6.2f", 100.0 * static_cast<double>(card_count) /
+                        static_cast<double>(std::max<std::uint64_t>(
+                            num_of_cards, 1)));
+  }
+  printf("\n");
+
+  printf("\n%-31s %13s %11s %13s\n", "CONFIG", "EV/ROUND", "95% CI",
+         "EV/WAGERED");
+  for (std::size_t i = 0;
+       i < std::min<std::size_t>(live_stats.num_of_configs,
+                                 LiveStats::MAX_CONFIGS);
+       ++i)
+  {
+    const LiveConfigStats &config_stats = live_stats.configs[i];
+    printf("%-31s %+13.8f %11.8f %+13.8f\n", config_stats.name.data(),
+           config_stats.ev_per_round,
+           config_stats.ev_per_round_confidence_interval,
+           config_stats.ev_per_unit_wagered);
+  }
+  printf("\n");
+  fflush(stdout);
+}
+
+auto CommandLine::run_record() -> int
+{
+  RuleSet rules;
+  SimulationOptions simulation_options;
+  std::string output_path = "shoes.log";
+  if (!parse_rule_set(rules) ||
+      !parse_simulation_options(simulation_options) ||
+      !get_option("output", output_path))
+  {
+    return 1;
+  }
+
+  // A log holds the shoes of a plain batch run, which neither pairs its
+  // shoes nor deals them from packed shoe states.
+  if (simulation_options.antithetic || has_option("packed"))
+  {
+    printf("Shoe logs cannot be recorded with --antithetic or --packed, they "
+           "hold the shoes of a plain batch run.\n");
+    return 1;
+  }
+
+  // The log can also be given as a positional argument, like the files of
+  // build-index and query.
+  if (positional_args.size() > 1 ||
+      (!positional_args.empty() && has_option("output")))
+  {
+    printf("A single shoe log is needed.\n");
+    return 1;
+  }
+  if (!positional_args.empty())
+  {
+    output_path = positional_args[0];
+  }
+
+  if (!ShoeLogWriter::record_shoes(rules, simulation_options, output_path))
+  {
+    return 1;
+  }
+  printf("Recorded %llu shoes to '%s'.\n",
+         static_cast<unsigned long long>(simulation_options.num_of_shoes),
+         output_path.c_str());
+  return 0;
+}
+
+auto CommandLine::run_build_index() -> int
+{
+  if (positional_args.size() != 1)
+  {
+    printf("A single shoe log is needed.\n");
+    return 1;
+  }
+
+  const std::string &log_path = positional_args[0];
+  std::string index_path = log_path + ".idx";
+  if (!get_option("output", index_path) ||
+      !ShoeIndex::build(log_path, index_path))
+  {
+    return 1;
+  }
+  printf("Indexed '%s' to '%s'.\n", log_path.c_str(), index_path.c_str());
+  return 0;
+}
+
+auto CommandLine::run_query() -> int
+{
+  std::uint64_t limit = 20;
+  if (!get_option("limit", limit))
+  {
+    return 1;
+  }
+  if (positional_args.empty())
+  {
+    printf("An index is needed.\n");
+    return 1;
+  }
+
+  ShoeIndex shoe_index;
+  if (!shoe_index.open(positional_args[0]))
+  {
+    printf("Failed to read index '%s'.\n", positional_args[0].c_str());
+    return 1;
+  }
+
+  ShoeQuery shoe_query(shoe_index);
+  for (std::size_t i = 1; i < positional_args.size(); ++i)
+  {
+    if (!shoe_query.add_filter(positional_args[i]))
+    {
+      return 1;
+    }
+  }
+  shoe_query.run(limit);
+  return 0;
+}
+
+auto CommandLine::parse_sweep_points(const RuleSet &rules,
+                                     double penetration,
+                                     std::vector<SweepPoint> &points) const
+    -> bool
+{
+  static const std::vector<std::string> SWEEP_PARAMETERS = {
+      "decks",      "player-payout", "banker-payout", "commission",
+      "tie-payout", "push-on-tie",   "penetration",   "strategy"};
+
+  // Split each argument into its parameter name and values.
+  std::vector<std::pair<std::string, std::vector<std::string>>> parameters;
+  for (const std::string &arg : positional_args)
+  {
+    std::size_t pos = arg.find('=');
+    std::string name = arg.substr(0, pos);
+    if (pos == std::string::npos ||
+        std::find(SWEEP_PARAMETERS.begin(), SWEEP_PARAMETERS.end(), name) ==
+            SWEEP_PARAMETERS.end())
+    {
+      printf("Invalid sweep parameter '%s'.\n", arg.c_str());
+      return false;
+    }
+
+    std::vector<std::string> values;
+    std::stringstream string_stream(arg.substr(pos + 1));
+    std::string value;
+    while (std::getline(string_stream, value, ','))
+    {
+      values.push_back(value);
+    }
+    if (values.empty())
+    {
+      printf("Sweep parameter '%s' has no values.\n", name.c_str());
+      return false;
+    }
+    parameters.emplace_back(name, values);
+  }
+
+  // Count through every combination of values, the last parameter changes
+  // fastest.
+  std::vector<std::size_t> value_indexes(parameters.size(), 0);
+  while (true)
+  {
+    SweepPoint point;
+    point.rules = rules;
+    point.penetration = penetration;
+    std::string strategy_string = "flat:banker";
+
+    // The values are parsed as if they were given as options.
+    std::vector<std::string> override_args = {subcommand};
+    for (std::size_t i = 0; i < parameters.size(); ++i)
+    {
+      const std::string &name = parameters[i].first;
+      const std::string &value = parameters[i].second[value_indexes[i]];
+      point.name += (i > 0 ? " " : "") + name + "=" + value;
+
+      if (name == "strategy")
+      {
+        strategy_string = value;
+      }
+      else if (name == "push-on-tie")
+      {
+        point.rules.push_on_tie = value == "1" || value == "true";
+      }
+      else
+      {
+        override_args.push_back("--" + name);
+        override_args.push_back(value);
+      }
+    }
+
+    CommandLine override_command_line(override_args);
+    if (!override_command_line.parse_rule_set(point.rules) ||
+        !override_command_line.get_option("penetration", point.penetration))
+    {
+      return false;
+    }
+    if (point.penetration <= 0.0 || point.penetration > 1.0)
+    {
+      printf("Penetration must be between 0 and 1.\n");
+      return false;
+    }
+    if (!BetStrategy::from_string(strategy_string, point.strategy))
+    {
+      printf("Invalid strategy '%s'.\n", strategy_string.c_str());
+      return false;
+    }
+    points.push_back(point);
+
+    // Move to the next combination of values.
+    std::size_t i = parameters.size();
+    while (i > 0 && ++value_indexes[i - 1] == parameters[i - 1].second.size())
+    {
+      value_indexes[--i] = 0;
+    }
+    if (i == 0)
+    {
+      break;
+    }
+  }
+  return true;
+}
+
+auto CommandLine::parse_bankroll_options(
+    BankrollOptions &bankroll_options) const -> bool
+{
+  // The shared options are read the same way as for a batch simulation.
+  SimulationOptions simulation_options;
+  simulation_options.seed = bankroll_options.seed;
+  if (!parse_simulation_options(simulation_options) ||
+      !get_option("sessions", bankroll_options.num_of_sessions) ||
+      !get_option("balance", bankroll_options.starting_balance) ||
+      !get_option("table-min", bankroll_options.table_min) ||
+      !get_option("table-max", bankroll_options.table_max) ||
+      !get_option("stop-loss", bankroll_options.stop_loss) ||
+      !get_option("stop-win", bankroll_options.stop_win) ||
+      !get_option("session-length", bankroll_options.session_length))
+  {
+    return false;
+  }
+  bankroll_options.seed = simulation_options.seed;
+  bankroll_options.penetration = simulation_options.penetration;
+  bankroll_options.shoe_mode = simulation_options.shoe_mode;
+  bankroll_options.continuous_shuffle_delay =
+      simulation_options.continuous_shuffle_delay;
+  bankroll_options.shuffle_model = simulation_options.shuffle_model;
+  bankroll_options.num_of_shuffle_passes =
+      simulation_options.num_of_shuffle_passes;
+  bankroll_options.num_of_threads = simulation_options.num_of_threads;
+  bankroll_options.checkpoint = simulation_options.checkpoint;
+
+  if (bankroll_options.starting_balance <= 0.0 ||
+      bankroll_options.table_min < 0.0 || bankroll_options.table_max < 0.0 ||
+      bankroll_options.stop_loss < 0.0 || bankroll_options.stop_win < 0.0)
+  {
+    printf("Balances, limits and stops cannot be negative.\n");
+    return false;
+  }
+  if (bankroll_options.session_length <= 0)
+  {
+    printf("Session length must be positive.\n");
+    return false;
+  }
+  return true;
+}
+
+auto CommandLine::parse_floor_options(FloorOptions &floor_options) const
+    -> bool
+{
+  // The shared options are read the same way as for a batch simulation.
+  SimulationOptions simulation_options;
+  simulation_options.seed = floor_options.seed;
+  if (!parse_simulation_options(simulation_options) ||
+      !get_option("tables", floor_options.num_of_tables) ||
+      !get_option("seats", floor_options.seats_per_table) ||
+      !get_option("hours", floor_options.hours) ||
+      !get_option("arrivals", floor_options.arrivals_per_hour) ||
+      !get_option("stay", floor_options.stay_minutes) ||
+      !get_option("shuffle-time", floor_options.shuffle_seconds) ||
+      !get_option("card-time", floor_options.card_seconds) ||
+      !get_option("squeeze-time", floor_options.squeeze_seconds) ||
+      !get_option("settle-time", floor_options.settle_seconds) ||
+      !get_option("balance", floor_options.starting_balance) ||
+      !get_option("table-min", floor_options.table_min) ||
+      !get_option("table-max", floor_options.table_max))
+  {
+    return false;
+  }
+  floor_options.seed = simulation_options.seed;
+  floor_options.penetration = simulation_options.penetration;
+  floor_options.shoe_mode = simulation_options.shoe_mode;
+  floor_options.continuous_shuffle_delay =
+      simulation_options.continuous_shuffle_delay;
+  floor_options.shuffle_model = simulation_options.shuffle_model;
+  floor_options.num_of_shuffle_passes =
+      simulation_options.num_of_shuffle_passes;
+  floor_options.num_of_threads = simulation_options.num_of_threads;
+
+  if (floor_options.num_of_tables <= 0 || floor_options.seats_per_table <= 0)
+  {
+    printf("Tables and seats must be positive.\n");
+    return false;
+  }
+  if (floor_options.hours <= 0.0 || floor_options.arrivals_per_hour <= 0.0 ||
+      floor_options.stay_minutes <= 0.0)
+  {
+    printf("Hours, arrivals and stay must be positive.\n");
+    return false;
+  }
+  // Every round must take time, or a full table would never reach the next
+  // event.
+  if (floor_options.card_seconds <= 0.0 ||
+      floor_options.shuffle_seconds < 0.0 ||
+      floor_options.squeeze_seconds < 0.0 ||
+      floor_options.settle_seconds < 0.0)
+  {
+    printf("Card time must be positive and other times cannot be "
+           "negative.\n");
+    return false;
+  }
+  if (floor_options.starting_balance <= 0.0 || floor_options.table_min < 0.0 ||
+      floor_options.table_max < 0.0)
+  {
+    printf("Balances and limits cannot be negative.\n");
+    return false;
+  }
+  return true;
+}
+
+auto CommandLine::parse_rare_event_options(
+    RareEventOptions &rare_event_options) const -> bool
+{
+  // The shared options are read the same way as for a batch simulation.
+  SimulationOptions simulation_options;
+  simulation_options.num_of_shoes = rare_event_options.num_of_shoes;
+  if (!parse_simulation_options(simulation_options) ||
+      !get_option("pilot-runs", rare_event_options.num_of_pilot_runs) ||
+      !get_option("pilot-shoes", rare_event_options.num_of_pilot_shoes) ||
+      !get_option("elite-fraction", rare_event_options.elite_fraction) ||
+      !get_rank_tilt_option("player-tilt", BetType::PLAYER,
+                            rare_event_options.rank_tilt) ||
+      !get_rank_tilt_option("banker-tilt", BetType::BANKER,
+                            rare_event_options.rank_tilt))
+  {
+    return false;
+  }
+  rare_event_options.exact_tilt =
+      !has_option("player-tilt") && !has_option("banker-tilt");
+  rare_event_options.num_of_shoes = simulation_options.num_of_shoes;
+  rare_event_options.seed = simulation_options.seed;
+  rare_event_options.penetration = simulation_options.penetration;
+  rare_event_options.shoe_mode = simulation_options.shoe_mode;
+  rare_event_options.continuous_shuffle_delay =
+      simulation_options.continuous_shuffle_delay;
+  rare_event_options.num_of_threads = simulation_options.num_of_threads;
+
+  if (simulation_options.shuffle_model != ShuffleModel::RANDOM)
+  {
+    printf("Rare event simulations only support a random shuffle.\n");
+    return false;
+  }
+  if (simulation_options.antithetic)
+  {
+    printf("Rare event simulations do not support --antithetic, the tilted "
+           "shoes are already weighted.\n");
+    return false;
+  }
+
+  if (rare_event_options.num_of_pilot_runs < 0)
+  {
+    printf("Number of pilot runs cannot be negative.\n");
+    return false;
+  }
+  if (rare_event_options.elite_fraction <= 0.0 ||
+      rare_event_options.elite_fraction > 1.0)
+  {
+    printf("Elite fraction must be between 0 and 1.\n");
+    return false;
+  }
+  return true;
+}
+
+auto CommandLine::get_rank_tilt_option(const std::string &name,
+                                       BetType hand,
+                                       RankTilt &rank_tilt) const -> bool
+{
+  auto option = options.find(name);
+  if (option == options.end())
+  {
+    return true;
+  }
+
+  // Each weight is parsed as if it was given as an option.
+  std::array<double, 13> tilt_weights = {};
+  std::stringstream string_stream(option->second);
+  std::string weight;
+  std::size_t num_of_weights = 0;
+  while (std::getline(string_stream, weight, ','))
+  {
+    if (num_of_weights == tilt_weights.size() ||
+        !CommandLine({subcommand, "--" + name, weight})
+             .get_option(name, tilt_weights[num_of_weights]))
+    {
+      num_of_weights = 0;
+      break;
+    }
+    ++num_of_weights;
+  }
+  if (num_of_weights != tilt_weights.size() ||
+      std::any_of(tilt_weights.begin(), tilt_weights.end(),
+                  [](double tilt_weight) { return tilt_weight <= 0.0; }))
+  {
+    printf("--%s needs a positive weight for each of the 13 card types.\n",
+           name.c_str());
+    return false;
+  }
+  rank_tilt.set_hand_weights(hand, tilt_weights);
+  return true;
+}
+
+auto CommandLine::parse_simulation_options(
+    SimulationOptions &simulation_options) const -> bool
+{
+  if (!get_option("shoes", simulation_options.num_of_shoes) ||
+      !get_option("seed", simulation_options.seed) ||
+      !get_option("penetration", simulation_options.penetration) ||
+      !get_option("threads", simulation_options.num_of_threads))
+  {
+    return false;
+  }
+  if (!get_option("checkpoint", simulation_options.checkpoint.path) ||
+      !get_option("checkpoint-interval",
+                  simulation_options.checkpoint.interval_seconds))
+  {
+    return false;
+  }
+  simulation_options.checkpoint.resume = has_option("resume");
+  if (!get_option("live-stats", simulation_options.live_stats_name))
+  {
+    return false;
+  }
+  if (simulation_options.live_stats_name.find_first_of("/\\") !=
+      std::string::npos)
+  {
+    printf("Live stats names cannot contain slashes.\n");
+    return false;
+  }
+  simulation_options.antithetic = has_option("antithetic");
+  if (simulation_options.antithetic && simulation_options.num_of_shoes % 2 != 0)
+  {
+    printf("The number of shoes must be even with --antithetic, the shoes are "
+           "dealt in pairs.\n");
+    return false;
+  }
+  if (has_option("infinite-deck"))
+  {
+    simulation_options.shoe_mode = ShoeMode::INFINITE_DECK;
+  }
+  if (has_option("csm"))
+  {
+    simulation_options.shoe_mode = ShoeMode::CONTINUOUS_SHUFFLE;
+  }
+  if (!get_option("csm-delay", simulation_options.continuous_shuffle_delay))
+  {
+    return false;
+  }
+  if (simulation_options.continuous_shuffle_delay < 0)
+  {
+    printf("Continuous shuffle delay cannot be negative.\n");
+    return false;
+  }
+  if (!parse_shuffle_option(simulation_options))
+  {
+    return false;
+  }
+
+  if (simulation_options.penetration <= 0.0 ||
+      simulation_options.penetration > 1.0)
+  {
+    printf("Penetration must be between 0 and 1.\n");
+    return false;
+  }
+  return true;
+}
+
+auto CommandLine::parse_shuffle_option(
+    SimulationOptions &simulation_options) const -> bool
+{
+  if (!has_option("shuffle"))
+  {
+    return true;
+  }
+
+  // Each model has a typical number of passes, used unless one is given.
+  static const std::map<std::string, std::pair<ShuffleModel, int>>
+      SHUFFLE_MODELS = {{"random", {ShuffleModel::RANDOM, 0}},
+                        {"riffle", {ShuffleModel::RIFFLE, 7}},
+                        {"strip", {ShuffleModel::STRIP, 4}},
+                        {"machine", {ShuffleModel::MACHINE, 1}}};
+
+  std::string shuffle_string;
+  get_option("shuffle", shuffle_string);
+  std::size_t pos = shuffle_string.find(':');
+  auto shuffle_model = SHUFFLE_MODELS.find(shuffle_string.substr(0, pos));
+  if (shuffle_model == SHUFFLE_MODELS.end())
+  {
+    printf("Unknown shuffle model '%s', expected random, riffle, strip or "
+           "machine.\n",
+           shuffle_string.c_str());
+    return false;
+  }
+  simulation_options.shuffle_model = shuffle_model->second.first;
+  simulation_options.num_of_shuffle_passes = shuffle_model->second.second;
+  if (pos != std::string::npos &&
+      (!CommandLine({subcommand, "--shuffle", shuffle_string.substr(pos + 1)})
+            .get_option("shuffle", simulation_options.num_of_shuffle_passes) ||
+       simulation_options.num_of_shuffle_passes <= 0))
+  {
+    printf("Invalid shuffle '%s', the number of passes must be positive.\n",
+           shuffle_string.c_str());
+    return false;
+  }
+
+  // Only a finite shoe is ever shuffled, and an antithetic shoe would have to
+  // be dealt from the same stack as the shoe before it.
+  if (simulation_options.shuffle_model != ShuffleModel::RANDOM &&
+      (simulation_options.shoe_mode != ShoeMode::FINITE_SHOE ||
+       simulation_options.antithetic))
+  {
+    printf("Shuffle models cannot be combined with --infinite-deck, --csm or "
+           "--antithetic.\n");
+    return false;
+  }
+  return true;
+}
+
+auto CommandLine::parse_shard_options(
+    SimulationOptions &simulation_options) const -> bool
+{
+  if (!has_option("shard"))
+  {
+    return true;
+  }
+
+  // The shard is written as I/N, where I counts from 1.
+  std::string shard_string;
+  std::uint64_t shard_number = 0;
+  get_option("shard", shard_string);
+  std::size_t pos = shard_string.find('/');
+  if (pos == std::string::npos ||
+      !CommandLine({subcommand, "--shard", shard_string.substr(0, pos)})
+           .get_option("shard", shard_number) ||
+      !CommandLine({subcommand, "--shard", shard_string.substr(pos + 1)})
+           .get_option("shard", simulation_options.num_of_shards) ||
+      shard_number == 0 || shard_number > simulation_options.num_of_shards)
+  {
+    printf("Invalid shard '%s', expected I/N with I from 1 to N.\n",
+           shard_string.c_str());
+    return false;
+  }
+  simulation_options.shard_index = shard_number - 1;
+
+  simulation_options.shard_path = "shard-" + std::to_string(shard_number) +
+                                  "-of-" +
+                                  std::to_string(
+                                      simulation_options.num_of_shards) +
+                                  ".bin";
+  return get_option("shard-output", simulation_options.shard_path);
+}
+
+auto CommandLine::parse_packed_option(
+    const RuleSet &rules,
+    SimulationOptions &simulation_options) const -> bool
+{
+  simulation_options.packed_shoes = has_option("packed");
+  if (!simulation_options.packed_shoes)
+  {
+    return true;
+  }
+
+  // A packed shoe only holds the counts of a finite shoe.
+  if (simulation_options.shoe_mode != ShoeMode::FINITE_SHOE ||
+      simulation_options.shuffle_model != ShuffleModel::RANDOM ||
+      simulation_options.antithetic)
+  {
+    printf("Packed shoes cannot be combined with --infinite-deck, --csm, "
+           "--shuffle or --antithetic.\n");
+    return false;
+  }
+  if (rules.num_of_decks > PackedShoeBatch::MAX_DECKS)
+  {
+    printf("Packed shoes hold at most %d decks.\n", PackedShoeBatch::MAX_DECKS);
+    return false;
+  }
+  return true;
+}
+
+auto CommandLine::parse_simulation_configs(
+    const RuleSet &rules,
+    std::vector<SimulationConfig> &configs) const -> bool
+{
+  static const std::vector<std::string> RULE_OVERRIDES = {
+      "decks",      "player-payout", "banker-payout",
+      "commission", "tie-payout",    "push-on-tie"};
+
+  std::vector<std::string> config_strings = positional_args;
+  if (config_strings.empty())
+  {
+    config_strings = {"flat:player", "flat:banker", "flat:tie"};
+  }
+
+  for (const std::string &config_string : config_strings)
+  {
+    // The strategy is followed by comma separated rule overrides, which are
+    // parsed as if they were given as rule options.
+    std::vector<std::string> override_args = {subcommand};
+    std::stringstream string_stream(config_string);
+    std::string strategy_string;
+    std::getline(string_stream, strategy_string, ',');
+    std::string rule_override;
+    while (std::getline(string_stream, rule_override, ','))
+    {
+      std::size_t pos = rule_override.find('=');
+      if (std::find(RULE_OVERRIDES.begin(), RULE_OVERRIDES.end(),
+                    rule_override.substr(0, pos)) == RULE_OVERRIDES.end())
+      {
+        printf("Invalid rule override '%s' in '%s'.\n", rule_override.c_str(),
+               config_string.c_str());
+        return false;
+      }
+      override_args.push_back("--" + rule_override.substr(0, pos));
+      if (pos != std::string::npos)
+      {
+        override_args.push_back(rule_override.substr(pos + 1));
+      }
+    }
+
+    SimulationConfig config;
+    config.name = config_string;
+    config.rules = rules;
+    if (!BetStrategy::from_string(strategy_string, config.strategy))
+    {
+      printf("Invalid strategy '%s'.\n", strategy_string.c_str());
+      return false;
+    }
+    if (!CommandLine(override_args).parse_rule_set(config.rules))
+    {
+      return false;
+    }
+    if (config.rules.num_of_decks != rules.num_of_decks)
+    {
+      printf("Strategies are simulated on the same shoes, use --decks to "
+             "change the number of decks.\n");
+      return false;
+    }
+    configs.push_back(config);
+  }
+  return true;
+}
+
+auto CommandLine::parse_rule_set(RuleSet &rules) const -> bool
+{
+  if (!get_option("decks", rules.num_of_decks) ||
+      !get_option("player-payout", rules.payout_player) ||
+      !get_option("banker-payout", rules.payout_banker) ||
+      !get_option("commission", rules.banker_commission) ||
+      !get_option("tie-payout", rules.payout_tie))
+  {
+    return false;
+  }
+  rules.push_on_tie = rules.push_on_tie || has_option("push-on-tie");
+
+  if (rules.num_of_decks <= 0)
+  {
+    printf("Number of decks must be positive.\n");
+    return false;
+  }
+  return true;
+}
+
+auto CommandLine::check_options() const -> bool
+{
+  // The options each subcommand reads, built from the groups of options
+  // that are parsed together. A subcommand that rejects an option with a
+  // reason, e.g. rare and --antithetic, still lists it.
+  static const std::vector<std::string> RULE_OPTIONS = {
+      "decks",      "player-payout", "banker-payout",
+      "commission", "tie-payout",    "push-on-tie"};
+  static const std::vector<std::string> SHOE_OPTIONS = {
+      "seed", "penetration", "infinite-deck", "csm", "csm-delay", "shuffle"};
+  static const std::vector<std::string> CHECKPOINT_OPTIONS = {
+      "checkpoint", "checkpoint-interval", "resume"};
+  static const std::vector<std::string> BATCH_OPTIONS = {
+      "shoes", "threads",      "antithetic", "live-stats",
+      "shard", "shard-output", "packed"};
+  static const std::vector<std::string> RUIN_OPTIONS = {
+      "threads",   "sessions",  "balance",  "table-min",
+      "table-max", "stop-loss", "stop-win", "session-length"};
+  static const std::vector<std::string> RARE_OPTIONS = {
+      "shoes",       "threads",        "antithetic",  "pilot-runs",
+      "pilot-shoes", "elite-fraction", "player-tilt", "banker-tilt"};
+  static const std::vector<std::string> FLOOR_OPTIONS = {
+      "threads",     "balance",      "table-min", "table-max",
+      "tables",      "seats",        "hours",     "arrivals",
+      "stay",        "shuffle-time", "card-time", "squeeze-time",
+      "settle-time", "output"};
+  static const std::vector<std::string> SWEEP_OPTIONS = {
+      "shoes", "threads", "antithetic", "live-stats", "output"};
+  static const std::vector<std::string> RECORD_OPTIONS = {
+      "shoes", "antithetic", "packed", "output"};
+  static const std::map<std::string, std::vector<std::vector<std::string>>>
+      SUBCOMMAND_OPTIONS = {
+          {"analyze", {RULE_OPTIONS}},
+          {"batch",
+           {RULE_OPTIONS, SHOE_OPTIONS, CHECKPOINT_OPTIONS, BATCH_OPTIONS}},
+          {"compare",
+           {RULE_OPTIONS, SHOE_OPTIONS, CHECKPOINT_OPTIONS, BATCH_OPTIONS}},
+          {"ruin",
+           {RULE_OPTIONS, SHOE_OPTIONS, CHECKPOINT_OPTIONS, RUIN_OPTIONS}},
+          {"rare", {RULE_OPTIONS, SHOE_OPTIONS, RARE_OPTIONS}},
+          {"floor", {RULE_OPTIONS, SHOE_OPTIONS, FLOOR_OPTIONS}},
+          {"sweep", {RULE_OPTIONS, SHOE_OPTIONS, SWEEP_OPTIONS}},
+          {"merge", {}},
+          {"live", {{"follow", "interval"}}},
+          {"record", {RULE_OPTIONS, SHOE_OPTIONS, RECORD_OPTIONS}},
+          {"build-index", {{"output"}}},
+          {"query", {{"limit"}}}};
+
+  // An unknown subcommand is reported by run.
+  auto subcommand_options = SUBCOMMAND_OPTIONS.find(subcommand);
+  if (subcommand_options == SUBCOMMAND_OPTIONS.end())
+  {
+    return true;
+  }
+  for (const auto &option : options)
+  {
+    bool is_read = false;
+    for (const std::vector<std::string> &option_group :
+         subcommand_options->second)
+    {
+      is_read = is_read || std::find(option_group.begin(), option_group.end(),
+                                     option.first) != option_group.end();
+    }
+    if (!is_read)
+    {
+      printf("Unknown option '--%s' for %s, see 'baccarat help'.\n",
+             option.first.c_str(), subcommand.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+auto CommandLine::has_option(const std::string &name) const -> bool
+{
+  return options.find(name) != options.end();
+}
+
+auto CommandLine::get_option(const std::string &name, int &value) const -> bool
+{
+  auto option = options.find(name);
+  if (option == options.end())
+  {
+    return true;
+  }
+
+  try
+  {
+    std::size_t num_of_chars_read = 0;
+    value = std::stoi(option->second, &num_of_chars_read);
+    if (num_of_chars_read == option->second.size())
+    {
+      return true;
+    }
+  }
+  catch (const std::logic_error &e)
+  {
+    // Handled below.
+  }
+  printf("Invalid value '%s' for --%s.\n", option->second.c_str(),
+         name.c_str());
+  return false;
+}
+
+auto CommandLine::get_option(const std::string &name,
+                             std::uint64_t &value) const -> bool
+{
+  auto option = options.find(name);
+  if (option == options.end())
+  {
+    return true;
+  }
+
+  try
+  {
+    std::size_t num_of_chars_read = 0;
+    value = std::stoull(option->second, &num_of_chars_read);
+    if (num_of_chars_read == option->second.size() &&
+        option->second[0] != '-')
+    {
+      return true;
+    }
+  }
+  catch (const std::logic_error &e)
+  {
+    // Handled below.
+  }
+  printf("Invalid value '%s' for --%s.\n", option->second.c_str(),
+         name.c_str());
+  return false;
+}
+
+auto CommandLine::get_option(const std::string &name,
+                             double &value) const -> bool
+{
+  auto option = options.find(name);
+  if (option == options.end())
+  {
+    return true;
+  }
+
+  try
+  {
+    std::size_t num_of_chars_read = 0;
+    value = std::stod(option->second, &num_of_chars_read);
+    if (num_of_chars_read == option->second.size())
+    {
+      return true;
+    }
+  }
+  catch (const std::logic_error &e)
+  {
+    // Handled below.
+  }
+  printf("Invalid value '%s' for --%s.\n", option->second.c_str(),
+         name.c_str());
+  return false;
+}
+
+auto CommandLine::get_option(const std::string &name,
+                             std::string &value) const -> bool
+{
+  auto option = options.find(name);
+  if (option != options.end())
+  {
+    value = option->second;
+  }
+  return true;
+}
+
+} // namespace BACCARAT
@@ -0,0 +1,358 @@
+#ifndef COMMAND_LINE_H
+#define COMMAND_LINE_H
+
+#include "bankroll_simulator.h"
+#include "floor_simulator.h"
+#include "live_stats.h"
+#include "parameter_sweep.h"
+#include "rare_event_simulation.h"
+#include "rule_set.h"
+#include "simulation.h"
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief A class to run the non-interactive subcommands of the simulator.
+ *
+ * @details The first argument selects the subcommand, the remaining arguments
+ * are options in the form '--name value' or '--flag'. Any argument that is not
+ * an option is kept as a positional argument. Example:
+ *
+ * baccarat analyze --decks 6 --tie-payout 9
+ *
+ * @note When no arguments are given the interactive game is started instead.
+ */
+class CommandLine
+{
+public:
+  /**
+   * @brief Constructor for the CommandLine class.
+   *
+   * @param args The command line arguments, excluding the program name.
+   */
+  explicit CommandLine(const std::vector<std::string> &args);
+
+  /**
+   * @brief Runs the selected subcommand.
+   *
+   * @return The exit code of the program, 0 on success.
+   */
+  auto run() -> int;
+
+private:
+  /// @brief The selected subcommand.
+  std::string subcommand;
+
+  /// @brief The options given after the subcommand, by name without '--'.
+  /// @note Flags without a value are stored as "true".
+  std::map<std::string, std::string> options;
+
+  /// @brief The arguments given after the subcommand that are not options.
+  std::vector<std::string> positional_args;
+
+  /**
+   * @brief Prints the list of subcommands and options.
+   */
+  static void print_usage();
+
+  /**
+   * @brief Runs the 'analyze' subcommand, which compares the exact outcome
+   * probabilities and house edges of the finite shoe and the infinite deck.
+   *
+   * @return The exit code of the subcommand.
+   */
+  auto run_analyze() -> int;
+
+  /**
+   * @brief Runs the 'batch' and 'compare' subcommands, which simulate the
+   * configurations given as positional arguments on the same shoes.
+   *
+   * @param min_num_of_configs The fewest configurations the subcommand needs.
+   *
+   * @return The exit code of the subcommand.
+   */
+  auto run_simulation(std::size_t min_num_of_configs) -> int;
+
+  /**
+   * @brief Runs the 'ruin' subcommand, which simulates many player sessions of
+   * the strategy given as a positional argument and reports the risk of ruin.
+   *
+   * @return The exit code of the subcommand.
+   */
+  auto run_ruin() -> int;
+
+  /**
+   * @brief Runs the 'floor' subcommand, which simulates the tables of a casino
+   * floor over time with the strategy given as a positional argument.
+   *
+   * @return The exit code of the subcommand.
+   */
+  auto run_floor() -> int;
+
+  /**
+   * @brief Runs the 'rare' subcommand, which estimates the probability of the
+   * rare event given as a positional argument with importance sampling.
+   *
+   * @return The exit code of the subcommand.
+   */
+  auto run_rare() -> int;
+
+  /**
+   * @brief Runs the 'merge' subcommand, which combines the shard files given
+   * as positional arguments into the result of a single run.
+   *
+   * @return The exit code of the subcommand.
+   */
+  auto run_merge() -> int;
+
+  /**
+   * @brief Runs the 'live' subcommand, which prints the live stats published
+   * by a running simulation under the name given as a positional argument.
+   *
+   * @return The exit code of the subcommand.
+   */
+  auto run_live() -> int;
+
+  /**
+   * @brief Prints the live stats of a simulation.
+   *
+   * @param name The name the stats were published under.
+   * @param live_stats The stats to print.
+   */
+  static void print_live_stats(const std::string &name,
+                               const LiveStats &live_stats);
+
+  /**
+   * @brief Runs the 'record' subcommand, which deals shoes and archives them
+   * to a shoe log.
+   *
+   * @return The exit code of the subcommand.
+   */
+  auto run_record() -> int;
+
+  /**
+   * @brief Runs the 'build-index' subcommand, which builds the columnar index
+   * of the shoe log given as a positional argument.
+   *
+   * @return The exit code of the subcommand.
+   */
+  auto run_build_index() -> int;
+
+  /**
+   * @brief Runs the 'query' subcommand, which finds the shoes and hands of
+   * an index that match the filters given as positional arguments.
+   *
+   * @return The exit code of the subcommand.
+   */
+  auto run_query() -> int;
+
+  /**
+   * @brief Runs the 'sweep' subcommand, which simulates every combination of
+   * the parameter values given as positional arguments.
+   *
+   * @return The exit code of the subcommand.
+   */
+  auto run_sweep() -> int;
+
+  /**
+   * @brief Creates the points of a parameter sweep from the positional
+   * arguments.
+   *
+   * @details Each argument is a parameter and its values, e.g.
+   * 'tie-payout=8,9'. The parameters are the rule options, 'penetration' and
+   * 'strategy', and every combination of the values is a point of the grid.
+   *
+   * @param rules The table rules that the points override.
+   * @param penetration The penetration of points that don't override it.
+   * @param points The points to update.
+   *
+   * @return true if every parameter and value is valid, false otherwise.
+   */
+  auto parse_sweep_points(const RuleSet &rules,
+                          double penetration,
+                          std::vector<SweepPoint> &points) const -> bool;
+
+  /**
+   * @brief Reads the bankroll simulation options from the options.
+   *
+   * @param bankroll_options The options to update.
+   *
+   * @return true if all bankroll options are valid, false otherwise.
+   */
+  auto parse_bankroll_options(BankrollOptions &bankroll_options) const -> bool;
+
+  /**
+   * @brief Reads the casino floor simulation options from the options.
+   *
+   * @param floor_options The options to update.
+   *
+   * @return true if all floor options are valid, false otherwise.
+   */
+  auto parse_floor_options(FloorOptions &floor_options) const -> bool;
+
+  /**
+   * @brief Reads the rare event simulation options from the options.
+   *
+   * @param rare_event_options The options to update.
+   *
+   * @return true if all rare event options are valid, false otherwise.
+   */
+  auto parse_rare_event_options(RareEventOptions &rare_event_options) const
+      -> bool;
+
+  /**
+   * @brief Reads the weights of a rank tilt option, a comma separated weight
+   * for each card type from A to K used in every deal state of a hand.
+   *
+   * @param name The name of the option without '--'.
+   * @param hand The hand the weights are for, either PLAYER or BANKER.
+   * @param rank_tilt The tilt to update, unchanged if the option was not
+   * given.
+   *
+   * @return true if the option is missing or valid, false otherwise.
+   */
+  auto get_rank_tilt_option(const std::string &name,
+                            BetType hand,
+                            RankTilt &rank_tilt) const -> bool;
+
+  /**
+   * @brief Reads the simulation options from the options.
+   *
+   * @param simulation_options The options to update.
+   *
+   * @return true if all simulation options are valid, false otherwise.
+   */
+  auto parse_simulation_options(SimulationOptions &simulation_options) const
+      -> bool;
+
+  /**
+   * @brief Reads the shuffle option, a shuffle model optionally followed by
+   * the number of passes, e.g. 'riffle' or 'strip:6'.
+   *
+   * @param simulation_options The options to update, unchanged if the option
+   * was not given.
+   *
+   * @return true if the option is missing or valid, false otherwise.
+   */
+  auto parse_shuffle_option(SimulationOptions &simulation_options) const
+      -> bool;
+
+  /**
+   * @brief Reads the shard options of a batch or compare simulation.
+   *
+   * @param simulation_options The options to update.
+   *
+   * @return true if the options are valid, false otherwise.
+   */
+  auto parse_shard_options(SimulationOptions &simulation_options) const
+      -> bool;
+
+  /**
+   * @brief Reads whether a batch or compare simulation deals packed shoes.
+   *
+   * @param rules The table rules, used for the number of decks.
+   * @param simulation_options The options to update.
+   *
+   * @return true if the shoes can be packed or the option was not given,
+   * false otherwise.
+   */
+  auto parse_packed_option(const RuleSet &rules,
+                           SimulationOptions &simulation_options) const
+      -> bool;
+
+  /**
+   * @brief Reads the configurations to simulate from the positional arguments.
+   *
+   * @details A configuration is a strategy optionally followed by rule
+   * overrides, e.g. 'flat:tie,tie-payout=9'. If no configuration is given, a
+   * flat bet on each of PLAYER, BANKER and TIE is simulated.
+   *
+   * @param rules The table rules that the configurations override.
+   * @param configs The configurations to update.
+   *
+   * @return true if all configurations are valid, false otherwise.
+   */
+  auto parse_simulation_configs(const RuleSet &rules,
+                                std::vector<SimulationConfig> &configs) const
+      -> bool;
+
+  /**
+   * @brief Reads the table rules from the options.
+   *
+   * @param rules The rules to update, options that are not given keep their
+   * current value.
+   *
+   * @return true if all rule options are valid, false otherwise.
+   */
+  auto parse_rule_set(RuleSet &rules) const -> bool;
+
+  /**
+   * @brief Checks that the subcommand reads every option given.
+   *
+   * @details An option the subcommand does not read, e.g. a misspelled
+   * '--shoe', would otherwise be silently ignored.
+   *
+   * @return true if every option is read by the subcommand, false otherwise.
+   */
+  [[nodiscard]] auto check_options() const -> bool;
+
+  /**
+   * @brief Determines if an option or flag was given.
+   *
+   * @param name The name of the option without '--'.
+   *
+   * @return true if the option was given, false otherwise.
+   */
+  [[nodiscard]] auto has_option(const std::string &name) const -> bool;
+
+  /**
+   * @brief Reads an integer option.
+   *
+   * @param name The name of the option without '--'.
+   * @param value The value to update, unchanged if the option was not given.
+   *
+   * @return true if the option is missing or valid, false otherwise.
+   */
+  auto get_option(const std::string &name, int &value) const -> bool;
+
+  /**
+   * @brief Reads an unsigned 64 bit integer option.
+   *
+   * @param name The name of the option without '--'.
+   * @param value The value to update, unchanged if the option was not given.
+   *
+   * @return true if the option is missing or valid, false otherwise.
+   */
+  auto get_option(const std::string &name, std::uint64_t &value) const -> bool;
+
+  /**
+   * @brief Reads a floating point option.
+   *
+   * @param name The name of the option without '--'.
+   * @param value The value to update, unchanged if the option was not given.
+   *
+   * @return true if the option is missing or valid, false otherwise.
+   */
+  auto get_option(const std::string &name, double &value) const -> bool;
+
+  /**
+   * @brief Reads a string option.
+   *
+   * @param name The name of the option without '--'.
+   * @param value The value to update, unchanged if the option was not given.
+   *
+   * @return true if the option is missing or valid, false otherwise.
+   */
+  auto get_option(const std::string &name, std::string &value) const -> bool;
+};
+
+} // namespace BACCARAT
+
+#endif // COMMAND_LINE_H
@@ -0,0 +1,103 @@
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief A class to schedule timed events of a discrete event simulation.
+ *
+ * @details Events are kept in a binary heap ordered by their time, so
+ * scheduling and taking the next event both take logarithmic time in the
+ * number of pending events. Events scheduled for the same time are taken in
+ * the order they were scheduled, so a simulation is reproducible.
+ *
+ * @tparam Event The type of the events, copied into the queue.
+ */
+template <typename Event>
+class EventQueue
+{
+public:
+  /**
+   * @brief Schedules an event.
+   *
+   * @param time The time the event happens.
+   * @param event The event.
+   */
+  void schedule(double time, const Event &event)
+  {
+    scheduled_events.push({time, next_sequence_number++, event});
+  }
+
+  /**
+   * @brief Determines if every scheduled event has been taken.
+   *
+   * @return true if no event is pending.
+   */
+  [[nodiscard]] auto is_empty() const -> bool
+  {
+    return scheduled_events.empty();
+  }
+
+  /**
+   * @brief Get the time of the next event.
+   *
+   * @return The time, the queue must not be empty.
+   */
+  [[nodiscard]] auto get_next_time() const -> double
+  {
+    return scheduled_events.top().time;
+  }
+
+  /**
+   * @brief Takes the next event off the queue.
+   *
+   * @param time The time of the event.
+   *
+   * @return The event, the queue must not be empty.
+   */
+  auto take_next(double &time) -> Event
+  {
+    ScheduledEvent scheduled_event = scheduled_events.top();
+    scheduled_events.pop();
+    time = scheduled_event.time;
+    return scheduled_event.event;
+  }
+
+private:
+  /**
+   * @brief An event and the time it happens.
+   */
+  struct ScheduledEvent
+  {
+    /// @brief The time the event happens.
+    double time = 0.0;
+    /// @brief The number of events scheduled before this one.
+    std::uint64_t sequence_number = 0;
+    /// @brief The event.
+    Event event;
+
+    auto operator>(const ScheduledEvent &other) const -> bool
+    {
+      return time != other.time ? time > other.time
+                                : sequence_number > other.sequence_number;
+    }
+  };
+
+  /// @brief The pending events, the earliest on top.
+  std::priority_queue<ScheduledEvent, std::vector<ScheduledEvent>,
+                      std::greater<>>
+      scheduled_events;
+
+  /// @brief The sequence number of the next event scheduled.
+  std::uint64_t next_sequence_number = 0;
+};
+
+} // namespace BACCARAT
+
+#endif // EVENT_QUEUE_H
@@ -0,0 +1,454 @@
+#include "floor_simulator.h"
+#include "chunk_runner.h"
+#include "results_table.h"
+#include "simulation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+
+namespace BACCARAT
+{
+
+// CONSTRUCTORS
+
+FloorSimulator::FloorSimulator(const RuleSet &rules,
+                               const BetStrategy &strategy,
+                               const FloorOptions &options)
+    : rules(rules), strategy(strategy), options(options)
+{
+}
+
+FloorSimulator::Table::Table(const RuleSet &rules, ShoeMode shoe_mode)
+    : card_dealer(rules, shoe_mode)
+{
+}
+
+// PUBLIC METHODS
+
+void FloorSimulator::run(FloorResult &result) const
+{
+  auto start_time = std::chrono::steady_clock::now();
+  int num_of_chunks =
+      (options.num_of_tables + TABLES_PER_CHUNK - 1) / TABLES_PER_CHUNK;
+
+  result = FloorResult();
+  run_chunks_in_order<std::vector<FloorTableResult>>(
+      0, num_of_chunks, options.num_of_threads,
+      [&](std::uint64_t chunk_index)
+      {
+        int first_table_index =
+            static_cast<int>(chunk_index) * TABLES_PER_CHUNK;
+        return simulate_tables(
+            first_table_index,
+            std::min(first_table_index + TABLES_PER_CHUNK,
+                     options.num_of_tables));
+      },
+      [&](std::uint64_t /*chunk_index*/,
+          const std::vector<FloorTableResult> &chunk_result)
+      {
+        result.tables.insert(result.tables.end(), chunk_result.begin(),
+                             chunk_result.end());
+      });
+
+  std::chrono::duration<double> elapsed_time =
+      std::chrono::steady_clock::now() - start_time;
+  result.elapsed_seconds = elapsed_time.count();
+}
+
+void FloorSimulator::print_result(const FloorResult &result) const
+{
+  printf("\n--- Casino Floor Simulation ---\n\n");
+  printf("Strategy: %s\n", strategy.to_string().c_str());
+  printf("Tables: %d with %d seats\nOpen: %.2f hours\n", options.num_of_tables,
+         options.seats_per_table, options.hours);
+  printf("Arrivals: %.2f per table per hour, staying %.2f minutes\n",
+         options.arrivals_per_hour, options.stay_minutes);
+  printf("Dealer: %.2f s per card, %.2f s squeeze, %.2f s per bet settled, "
+         "%.2f s shuffle\n\n",
+         options.card_seconds, options.squeeze_seconds,
+         options.settle_seconds, options.shuffle_seconds);
+
+  double seat_seconds =
+      options.hours * SECONDS_PER_HOUR * options.seats_per_table;
+  printf("%6s %11s %13s %13s %10s %8s %8s %9s\n", "TABLE", "HANDS/HOUR",
+         "WAGERED/HOUR", "REVENUE/HOUR", "OCCUPANCY", "SEATED", "AWAY",
+         "SHUFFLING");
+
+  FloorTableResult floor;
+  for (std::size_t i = 0; i < result.tables.size(); ++i)
+  {
+    const FloorTableResult &table = result.tables[i];
+    printf("%6zu %11.2f %13.2f %+13.2f %9.2f%% %8llu %8llu %8.2f%%\n", i + 1,
+           static_cast<double>(table.num_of_rounds) / options.hours,
+           table.total_wagered / options.hours, table.revenue / options.hours,
+           100.0 * table.occupied_seat_seconds / seat_seconds,
+           static_cast<unsigned long long>(table.num_of_players_seated),
+           static_cast<unsigned long long>(table.num_of_players_turned_away),
+           100.0 * table.shuffling_seconds /
+               (options.hours * SECONDS_PER_HOUR));
+
+    floor.num_of_rounds += table.num_of_rounds;
+    floor.num_of_shuffles += table.num_of_shuffles;
+    floor.num_of_players_seated += table.num_of_players_seated;
+    floor.num_of_players_turned_away += table.num_of_players_turned_away;
+    floor.num_of_players_ruined += table.num_of_players_ruined;
+    floor.num_of_events += table.num_of_events;
+    floor.total_wagered += table.total_wagered;
+    floor.revenue += table.revenue;
+    floor.occupied_seat_seconds += table.occupied_seat_seconds;
+    floor.shuffling_seconds += table.shuffling_seconds;
+  }
+
+  auto num_of_tables =
+      static_cast<double>(std::max<std::size_t>(result.tables.size(), 1));
+  printf("\nFloor:\n");
+  printf("  Hands/Hour:   %12.2f (%.2f per table)\n",
+         static_cast<double>(floor.num_of_rounds) / options.hours,
+         static_cast<double>(floor.num_of_rounds) / options.hours /
+             num_of_tables);
+  printf("  Revenue/Hour: %+12.2f (%+.2f per table)\n",
+         floor.revenue / options.hours,
+         floor.revenue / options.hours / num_of_tables);
+  printf("  Hold:         %12.4f%% of %.2f wagered\n",
+         floor.total_wagered > 0.0
+             ? 100.0 * floor.revenue / floor.total_wagered
+             : 0.0,
+         floor.total_wagered);
+  printf("  Occupancy:    %12.2f%%\n",
+         100.0 * floor.occupied_seat_seconds / seat_seconds / num_of_tables);
+  printf("  Players:      %12llu seated, %llu turned away, %llu ruined\n",
+         static_cast<unsigned long long>(floor.num_of_players_seated),
+         static_cast<unsigned long long>(floor.num_of_players_turned_away),
+         static_cast<unsigned long long>(floor.num_of_players_ruined));
+  printf("  Shuffles:     %12llu\n",
+         static_cast<unsigned long long>(floor.num_of_shuffles));
+  printf("\nEvents: %llu in %.3f s (%.0f events/s)\n\n",
+         static_cast<unsigned long long>(floor.num_of_events),
+         result.elapsed_seconds,
+         static_cast<double>(floor.num_of_events) /
+             std::max(result.elapsed_seconds, 1e-9));
+}
+
+auto FloorSimulator::write_result(const FloorResult &result,
+                                  const std::string &path) const -> bool
+{
+  ResultsTable results_table;
+  for (const char *name :
+       {"table", "hands", "hands_per_hour", "wagered_per_hour",
+        "revenue_per_hour", "occupancy", "players_seated",
+        "players_turned_away", "players_ruined", "shuffles",
+        "shuffling_fraction"})
+  {
+    results_table.add_number_column(name);
+  }
+
+  double seat_seconds =
+      options.hours * SECONDS_PER_HOUR * options.seats_per_table;
+  for (std::size_t i = 0; i < result.tables.size(); ++i)
+  {
+    const FloorTableResult &table = result.tables[i];
+    results_table.add_row(
+        {static_cast<double>(i + 1), static_cast<double>(table.num_of_rounds),
+         static_cast<double>(table.num_of_rounds) / options.hours,
+         table.total_wagered / options.hours, table.revenue / options.hours,
+         table.occupied_seat_seconds / seat_seconds,
+         static_cast<double>(table.num_of_players_seated),
+         static_cast<double>(table.num_of_players_turned_away),
+         static_cast<double>(table.num_of_players_ruined),
+         static_cast<double>(table.num_of_shuffles),
+         table.shuffling_seconds / (options.hours * SECONDS_PER_HOUR)},
+        {});
+  }
+
+  bool is_csv =
+      path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+  bool written = is_csv ? results_table.write_csv(path)
+                        : results_table.write_columnar(path);
+  if (!written)
+  {
+    printf("Failed to write results to '%s'.\n", path.c_str());
+    return false;
+  }
+  printf("Results written to '%s'.\n\n", path.c_str());
+  return true;
+}
+
+// PRIVATE METHODS
+
+auto FloorSimulator::simulate_tables(int first_table_index,
+                                     int last_table_index) const
+    -> std::vector<FloorTableResult>
+{
+  double closing_time = options.hours * SECONDS_PER_HOUR;
+  FloorEventQueue event_queue;
+
+  std::vector<Table> tables;
+  tables.reserve(last_table_index - first_table_index);
+  for (int table_index = first_table_index; table_index < last_table_index;
+       ++table_index)
+  {
+    Table &table = tables.emplace_back(rules, options.shoe_mode);
+    table.card_dealer.set_continuous_shuffle_delay(
+        options.continuous_shuffle_delay);
+    table.card_dealer.set_shuffle_model(options.shuffle_model,
+                                        options.num_of_shuffle_passes);
+    table.table_seed = Simulation::get_shoe_seed(options.seed, table_index);
+    table.gen.seed(table.table_seed);
+    table.seats.resize(options.seats_per_table);
+
+    // The floor opens with a shuffled shoe at every table.
+    table.card_dealer.reset_deck(
+        Simulation::get_shoe_seed(table.table_seed, table.shoe_index));
+
+    FloorEvent arrival;
+    arrival.type = FloorEventType::PLAYER_ARRIVES;
+    arrival.table = table_index - first_table_index;
+    event_queue.schedule(
+        draw_exponential_seconds(table,
+                                 SECONDS_PER_HOUR / options.arrivals_per_hour),
+        arrival);
+  }
+
+  while (!event_queue.is_empty() &&
+         event_queue.get_next_time() <= closing_time)
+  {
+    double time = 0.0;
+    FloorEvent event = event_queue.take_next(time);
+    Table &table = tables[event.table];
+    ++table.result.num_of_events;
+
+    switch (event.type)
+    {
+    case FloorEventType::PLAYER_ARRIVES:
+      seat_player(table, event.table, time, event_queue);
+      break;
+    case FloorEventType::PLAYER_LEAVES:
+      unseat_player(table, event, time);
+      break;
+    case FloorEventType::SHUFFLE_DONE:
+      table.is_shuffling = false;
+      table.result.shuffling_seconds += time - table.shuffle_start_time;
+      start_round(table, event.table, time, event_queue);
+      break;
+    case FloorEventType::ROUND_DONE:
+      finish_round(table, event.table, time, event_queue);
+      break;
+    }
+  }
+
+  // Players still seated and a shoe still being shuffled are counted up to
+  // the closing time, rounds still being dealt are not settled.
+  std::vector<FloorTableResult> results;
+  for (Table &table : tables)
+  {
+    for (Seat &seat : table.seats)
+    {
+      if (seat.is_taken)
+      {
+        free_seat(seat, closing_time, table.result);
+      }
+    }
+    if (table.is_shuffling)
+    {
+      table.result.shuffling_seconds +=
+          closing_time - table.shuffle_start_time;
+    }
+    results.push_back(table.result);
+  }
+  return results;
+}
+
+void FloorSimulator::seat_player(Table &table,
+                                 int table_index,
+                                 double time,
+                                 FloorEventQueue &event_queue) const
+{
+  FloorEvent arrival;
+  arrival.type = FloorEventType::PLAYER_ARRIVES;
+  arrival.table = table_index;
+  event_queue.schedule(
+      time + draw_exponential_seconds(
+                 table, SECONDS_PER_HOUR / options.arrivals_per_hour),
+      arrival);
+
+  auto seat = std::find_if(table.seats.begin(), table.seats.end(),
+                           [](const Seat &seat) { return !seat.is_taken; });
+  if (seat == table.seats.end())
+  {
+    ++table.result.num_of_players_turned_away;
+    return;
+  }
+
+  seat->is_taken = true;
+  seat->is_leaving = false;
+  seat->player_id = ++table.num_of_players;
+  seat->seated_time = time;
+  seat->player = CasinoPlayer(options.starting_balance, false);
+  seat->strategy = strategy;
+  seat->strategy.reset_state();
+  ++table.result.num_of_players_seated;
+
+  FloorEvent departure;
+  departure.type = FloorEventType::PLAYER_LEAVES;
+  departure.table = table_index;
+  departure.seat = static_cast<int>(seat - table.seats.begin());
+  departure.player_id = seat->player_id;
+  event_queue.schedule(
+      time + draw_exponential_seconds(
+                 table, SECONDS_PER_MINUTE * options.stay_minutes),
+      departure);
+
+  start_round(table, table_index, time, event_queue);
+}
+
+void FloorSimulator::unseat_player(Table &table,
+                                   const FloorEvent &event,
+                                   double time) const
+{
+  Seat &seat = table.seats[event.seat];
+  if (!seat.is_taken || seat.player_id != event.player_id)
+  {
+    return;
+  }
+
+  if (table.is_dealing &&
+      seat.player.get_current_bet_type() != BetType::NONE)
+  {
+    seat.is_leaving = true;
+  }
+  else
+  {
+    free_seat(seat, time, table.result);
+  }
+}
+
+void FloorSimulator::free_seat(Seat &seat,
+                               double time,
+                               FloorTableResult &result)
+{
+  result.occupied_seat_seconds += time - seat.seated_time;
+  seat.is_taken = false;
+  seat.is_leaving = false;
+}
+
+void FloorSimulator::start_round(Table &table,
+                                 int table_index,
+                                 double time,
+                                 FloorEventQueue &event_queue) const
+{
+  if (table.is_dealing || table.is_shuffling)
+  {
+    return;
+  }
+
+  // The bets are kept within the table limits, and a player that can't cover
+  // the bet stakes their remaining balance.
+  double table_max = options.table_max > 0.0
+                         ? options.table_max
+                         : std::numeric_limits<double>::max();
+  int num_of_bets = 0;
+  for (Seat &seat : table.seats)
+  {
+    if (!seat.is_taken)
+    {
+      continue;
+    }
+    double bet_amount = std::min(
+        {std::max(seat.strategy.get_next_bet_amount(), options.table_min),
+         table_max, seat.player.check_balance()});
+    seat.player.place_bet(seat.strategy.get_next_bet_type(), bet_amount);
+    ++num_of_bets;
+  }
+  if (num_of_bets == 0)
+  {
+    return;
+  }
+
+  table.card_dealer.deal_round(table.round_result);
+  int num_of_cards = table.round_result.num_of_player_cards +
+                     table.round_result.num_of_banker_cards;
+  table.num_of_cards_dealt += num_of_cards;
+  table.is_dealing = true;
+
+  FloorEvent round_done;
+  round_done.type = FloorEventType::ROUND_DONE;
+  round_done.table = table_index;
+  event_queue.schedule(
+      time + options.card_seconds * num_of_cards +
+          draw_exponential_seconds(table, options.squeeze_seconds) +
+          options.settle_seconds * num_of_bets,
+      round_done);
+}
+
+void FloorSimulator::finish_round(Table &table,
+                                  int table_index,
+                                  double time,
+                                  FloorEventQueue &event_queue) const
+{
+  BetType outcome = table.round_result.outcome;
+  for (Seat &seat : table.seats)
+  {
+    if (!seat.is_taken ||
+        seat.player.get_current_bet_type() == BetType::NONE)
+    {
+      continue;
+    }
+
+    BetType bet_type = seat.player.get_current_bet_type();
+    double bet_amount = seat.player.get_current_bet_amount();
+    double payout_multiplier =
+        CardDealer::get_payout_multiplier(outcome, bet_type, rules);
+    CardDealer::pay_out_bets(outcome, seat.player, rules);
+    seat.strategy.record_result(outcome, payout_multiplier);
+    table.result.total_wagered += bet_amount;
+    table.result.revenue += bet_amount * (1.0 - payout_multiplier);
+
+    double balance = seat.player.check_balance();
+    bool is_ruined = balance < options.table_min || balance <= 0.0;
+    if (is_ruined || seat.is_leaving)
+    {
+      table.result.num_of_players_ruined += is_ruined ? 1 : 0;
+      free_seat(seat, time, table.result);
+    }
+  }
+  ++table.result.num_of_rounds;
+  table.is_dealing = false;
+
+  // Only a finite shoe is shuffled by the dealer, the other shoes never run
+  // out.
+  int total_cards_in_deck = CardDealer::CARDS_PER_DECK * rules.num_of_decks;
+  auto cut_card_position =
+      static_cast<int>(options.penetration * total_cards_in_deck);
+  if (options.shoe_mode == ShoeMode::FINITE_SHOE &&
+      (table.num_of_cards_dealt >= cut_card_position ||
+       table.num_of_cards_dealt + MAX_CARDS_IN_ROUND > total_cards_in_deck))
+  {
+    table.card_dealer.reset_deck(
+        Simulation::get_shoe_seed(table.table_seed, ++table.shoe_index));
+    table.num_of_cards_dealt = 0;
+    table.is_shuffling = true;
+    table.shuffle_start_time = time;
+    ++table.result.num_of_shuffles;
+
+    FloorEvent shuffle_done;
+    shuffle_done.type = FloorEventType::SHUFFLE_DONE;
+    shuffle_done.table = table_index;
+    event_queue.schedule(time + options.shuffle_seconds, shuffle_done);
+    return;
+  }
+  start_round(table, table_index, time, event_queue);
+}
+
+auto FloorSimulator::draw_exponential_seconds(Table &table,
+                                              double mean_seconds) -> double
+{
+  if (mean_seconds <= 0.0)
+  {
+    return 0.0;
+  }
+  return std::exponential_distribution<double>(1.0 / mean_seconds)(table.gen);
+}
+
+} // namespace BACCARAT
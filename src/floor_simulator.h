@@ -0,0 +1,400 @@
+#ifndef FLOOR_SIMULATOR_H
+#define FLOOR_SIMULATOR_H
+
+#include "bet_strategy.h"
+#include "card_dealer.h"
+#include "casino_player.h"
+#include "event_queue.h"
+#include "rule_set.h"
+#include "shoe_mode.h"
+#include "shuffle_model.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief The options of a casino floor simulation.
+ */
+struct FloorOptions
+{
+  /// @brief The number of tables on the floor.
+  int num_of_tables = 100;
+
+  /// @brief The number of seats at every table.
+  int seats_per_table = 7;
+
+  /// @brief The number of hours the floor is open.
+  double hours = 8.0;
+
+  /// @brief The master seed, every table is seeded from it and its index.
+  std::uint64_t seed = 1;
+
+  /// @brief The fraction of the shoe dealt before the cut card is reached.
+  double penetration = 0.9;
+
+  /// @brief How cards are drawn from the shoe. Only a FINITE_SHOE is ever
+  /// shuffled by the dealer.
+  ShoeMode shoe_mode = ShoeMode::FINITE_SHOE;
+
+  /// @brief The number of rounds before the cards of a round are returned to
+  /// a CONTINUOUS_SHUFFLE shoe.
+  int continuous_shuffle_delay = 0;
+
+  /// @brief How the dealer shuffles a FINITE_SHOE, see
+  /// CardDealer::set_shuffle_model.
+  ShuffleModel shuffle_model = ShuffleModel::RANDOM;
+
+  /// @brief The number of riffles, strip cuts or passes through the machine
+  /// of every shuffle.
+  int num_of_shuffle_passes = 0;
+
+  /// @brief The number of worker threads, 0 to use every core.
+  int num_of_threads = 0;
+
+  /// @brief The seconds the dealer takes to shuffle a new shoe.
+  double shuffle_seconds = 300.0;
+
+  /// @brief The seconds the dealer takes to deal a card.
+  double card_seconds = 2.0;
+
+  /// @brief The mean seconds spent squeezing the cards of a round, the
+  /// squeeze of each round is exponentially distributed.
+  double squeeze_seconds = 10.0;
+
+  /// @brief The seconds the dealer takes to settle the bet of a seated player.
+  double settle_seconds = 2.0;
+
+  /// @brief The mean number of players arriving at a table every hour, a
+  /// player that finds no free seat walks away.
+  double arrivals_per_hour = 30.0;
+
+  /// @brief The mean minutes a player stays seated, unless they are ruined
+  /// first. A player in a round leaves once it is settled.
+  double stay_minutes = 45.0;
+
+  /// @brief The balance every player arrives with.
+  double starting_balance = 1000.0;
+
+  /// @brief The smallest bet allowed at a table. A player that cannot afford
+  /// the minimum bet leaves.
+  double table_min = 10.0;
+
+  /// @brief The largest bet allowed at a table, 0 for no limit.
+  double table_max = 0.0;
+};
+
+/**
+ * @brief The results of a single table of a casino floor simulation.
+ */
+struct FloorTableResult
+{
+  /// @brief The number of rounds settled.
+  std::uint64_t num_of_rounds = 0;
+
+  /// @brief The number of shoes shuffled by the dealer.
+  std::uint64_t num_of_shuffles = 0;
+
+  /// @brief The number of players that took a seat.
+  std::uint64_t num_of_players_seated = 0;
+
+  /// @brief The number of players that found every seat taken.
+  std::uint64_t num_of_players_turned_away = 0;
+
+  /// @brief The number of players that left because they could no longer
+  /// afford the minimum bet.
+  std::uint64_t num_of_players_ruined = 0;
+
+  /// @brief The number of events processed.
+  std::uint64_t num_of_events = 0;
+
+  /// @brief The sum of every bet settled.
+  double total_wagered = 0.0;
+
+  /// @brief The amount the house won, the bets settled minus the amount
+  /// returned to the players.
+  double revenue = 0.0;
+
+  /// @brief The sum of the seconds every seat was taken.
+  double occupied_seat_seconds = 0.0;
+
+  /// @brief The seconds the dealer spent shuffling.
+  double shuffling_seconds = 0.0;
+};
+
+/**
+ * @brief The results of a casino floor simulation.
+ */
+struct FloorResult
+{
+  /// @brief The results of every table, in table order.
+  std::vector<FloorTableResult> tables;
+
+  /// @brief The wall clock seconds the simulation took.
+  double elapsed_seconds = 0.0;
+};
+
+/**
+ * @brief A class to simulate the tables of a casino floor over time.
+ *
+ * @details Every table is a discrete event simulation: players arrive at
+ * random and take a free seat, bet with the betting strategy every round and
+ * leave after a random stay, and the dealer shuffles a new shoe at the cut
+ * card. The time of a round follows from the cards dealt, the squeeze and the
+ * bets settled. Rounds are dealt with CardDealer::deal_round and bets are
+ * settled with CardDealer::pay_out_bets, so the table rules are the same as
+ * every other simulation.
+ *
+ * @note Tables never interact, so they are split into chunks that are
+ * simulated by a pool of worker threads, each with its own event queue. Every
+ * table is seeded from its index, so the results do not depend on the number
+ * of threads.
+ */
+class FloorSimulator
+{
+public:
+  /**
+   * @brief Constructor for the FloorSimulator class.
+   *
+   * @param rules The table rules used to deal and settle the bets.
+   * @param strategy The betting strategy of every player.
+   * @param options The options of the simulation.
+   */
+  FloorSimulator(const RuleSet &rules,
+                 const BetStrategy &strategy,
+                 const FloorOptions &options);
+
+  /**
+   * @brief Runs the simulation.
+   *
+   * @param result The results of the simulation.
+   */
+  void run(FloorResult &result) const;
+
+  /**
+   * @brief Prints the hands and revenue per hour of every table and of the
+   * whole floor.
+   *
+   * @param result The results of the simulation.
+   */
+  void print_result(const FloorResult &result) const;
+
+  /**
+   * @brief Writes the results of every table to a results table.
+   *
+   * @param result The results of the simulation.
+   * @param path The path of the table, CSV if it ends in '.csv', otherwise
+   * columnar binary.
+   *
+   * @return true if the table was written, false otherwise.
+   */
+  [[nodiscard]] auto write_result(const FloorResult &result,
+                                  const std::string &path) const -> bool;
+
+private:
+  /// @brief The number of tables in a chunk of work given to a worker.
+  static constexpr int TABLES_PER_CHUNK = 8;
+
+  /// @brief The most cards that can be dealt in a single round.
+  static constexpr int MAX_CARDS_IN_ROUND = 6;
+
+  /// @brief The number of seconds in a minute.
+  static constexpr double SECONDS_PER_MINUTE = 60.0;
+
+  /// @brief The number of seconds in an hour.
+  static constexpr double SECONDS_PER_HOUR = 3600.0;
+
+  /**
+   * @brief Enum class to represent the events at a table.
+   */
+  enum class FloorEventType : std::uint8_t
+  {
+    /// @brief A player arrives at the table.
+    PLAYER_ARRIVES,
+    /// @brief A seated player wants to leave.
+    PLAYER_LEAVES,
+    /// @brief The dealer finishes shuffling a new shoe.
+    SHUFFLE_DONE,
+    /// @brief The cards of a round have been dealt and squeezed, and the bets
+    /// are settled.
+    ROUND_DONE
+  };
+
+  /**
+   * @brief An event at a table.
+   */
+  struct FloorEvent
+  {
+    /// @brief What happens.
+    FloorEventType type = FloorEventType::PLAYER_ARRIVES;
+    /// @brief The index of the table in its chunk.
+    int table = 0;
+    /// @brief The seat of a PLAYER_LEAVES event.
+    int seat = 0;
+    /// @brief The player of a PLAYER_LEAVES event, so an event of a player
+    /// that already left is ignored.
+    std::uint64_t player_id = 0;
+  };
+
+  /**
+   * @brief A seat at a table.
+   */
+  struct Seat
+  {
+    /// @brief Whether a player is seated.
+    bool is_taken = false;
+    /// @brief Whether the player leaves once the round is settled.
+    bool is_leaving = false;
+    /// @brief The seated player, unique within the table.
+    std::uint64_t player_id = 0;
+    /// @brief The time the player sat down.
+    double seated_time = 0.0;
+    /// @brief The balance and bet of the player.
+    CasinoPlayer player;
+    /// @brief The betting strategy of the player.
+    BetStrategy strategy;
+  };
+
+  /**
+   * @brief The state of a table.
+   */
+  struct Table
+  {
+    /// @brief The dealer of the table.
+    CardDealer card_dealer;
+    /// @brief The random number generator of the arrival, stay and squeeze
+    /// times.
+    std::mt19937_64 gen;
+    /// @brief The seed of every shoe of the table.
+    std::uint64_t table_seed = 0;
+    /// @brief The number of shoes started.
+    std::uint64_t shoe_index = 0;
+    /// @brief The number of cards dealt from the shoe.
+    int num_of_cards_dealt = 0;
+    /// @brief Whether a round is being dealt.
+    bool is_dealing = false;
+    /// @brief Whether the dealer is shuffling.
+    bool is_shuffling = false;
+    /// @brief The time the dealer started shuffling.
+    double shuffle_start_time = 0.0;
+    /// @brief The number of players that have sat down.
+    std::uint64_t num_of_players = 0;
+    /// @brief The seats of the table.
+    std::vector<Seat> seats;
+    /// @brief The round being dealt.
+    RoundResult round_result;
+    /// @brief The results of the table.
+    FloorTableResult result;
+
+    /**
+     * @brief Constructor for the Table struct.
+     *
+     * @param rules The table rules.
+     * @param shoe_mode How cards are drawn from the shoe.
+     */
+    Table(const RuleSet &rules, ShoeMode shoe_mode);
+  };
+
+  /// @brief An event queue of a chunk of tables.
+  using FloorEventQueue = EventQueue<FloorEvent>;
+
+  /// @brief The table rules used to deal and settle the bets.
+  RuleSet rules;
+
+  /// @brief The betting strategy of every player.
+  BetStrategy strategy;
+
+  /// @brief The options of the simulation.
+  FloorOptions options;
+
+  /**
+   * @brief Simulates a chunk of tables until the floor closes.
+   *
+   * @param first_table_index The index of the first table.
+   * @param last_table_index The index one past the last table.
+   *
+   * @return The results of the tables.
+   */
+  [[nodiscard]] auto simulate_tables(int first_table_index,
+                                     int last_table_index) const
+      -> std::vector<FloorTableResult>;
+
+  /**
+   * @brief Seats an arriving player if a seat is free, and schedules the next
+   * arrival.
+   *
+   * @param table The table.
+   * @param table_index The index of the table in its chunk.
+   * @param time The current time.
+   * @param event_queue The event queue of the table.
+   */
+  void seat_player(Table &table,
+                   int table_index,
+                   double time,
+                   FloorEventQueue &event_queue) const;
+
+  /**
+   * @brief Frees the seat of a player that leaves, or marks them as leaving
+   * if they have a bet in the current round.
+   *
+   * @param table The table.
+   * @param event The PLAYER_LEAVES event.
+   * @param time The current time.
+   */
+  void unseat_player(Table &table, const FloorEvent &event, double time) const;
+
+  /**
+   * @brief Frees a seat.
+   *
+   * @param seat The seat.
+   * @param time The current time.
+   * @param result The results of the table.
+   */
+  static void free_seat(Seat &seat, double time, FloorTableResult &result);
+
+  /**
+   * @brief Starts a round if the dealer is free and a player is seated.
+   *
+   * @param table The table.
+   * @param table_index The index of the table in its chunk.
+   * @param time The current time.
+   * @param event_queue The event queue of the table.
+   */
+  void start_round(Table &table,
+                   int table_index,
+                   double time,
+                   FloorEventQueue &event_queue) const;
+
+  /**
+   * @brief Settles the bets of a round, then shuffles a new shoe if the cut
+   * card was reached or starts the next round.
+   *
+   * @param table The table.
+   * @param table_index The index of the table in its chunk.
+   * @param time The current time.
+   * @param event_queue The event queue of the table.
+   */
+  void finish_round(Table &table,
+                    int table_index,
+                    double time,
+                    FloorEventQueue &event_queue) const;
+
+  /**
+   * @brief Draws an exponentially distributed time.
+   *
+   * @param table The table whose random number generator is used.
+   * @param mean_seconds The mean of the time.
+   *
+   * @return The time in seconds, 0 if the mean is not positive.
+   */
+  static auto draw_exponential_seconds(Table &table,
+                                       double mean_seconds) -> double;
+};
+
+} // namespace BACCARAT
+
+#endif // FLOOR_SIMULATOR_H
@@ -0,0 +1,264 @@
+#include "live_stats.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace BACCARAT
+{
+
+static_assert(std::is_trivially_copyable_v<LiveStats>,
+              "LiveStats is copied word for word");
+static_assert(sizeof(LiveStats) % sizeof(std::uint64_t) == 0,
+              "LiveStats must be a whole number of words");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "The seqlock needs lock free 64 bit atomics");
+
+/**
+ * @brief The layout of a live stats segment.
+ *
+ * @details The stats are stored as atomic words, so a reader copying them
+ * while the writer updates them is not a data race, the sequence number just
+ * tells the reader to try again.
+ */
+struct LiveStatsSegment
+{
+  /// @brief Identifies a live stats segment, the ASCII string "BACLIVE1".
+  static constexpr std::uint64_t MAGIC = 0x314556494C434142ULL;
+
+  /// @brief The number of words in the stats.
+  static constexpr std::size_t NUM_OF_WORDS =
+      sizeof(LiveStats) / sizeof(std::uint64_t);
+
+  /// @brief The magic number, written last once the segment is initialized.
+  std::atomic<std::uint64_t> magic;
+
+  /// @brief The size of the stats, so readers built with a different layout
+  /// are rejected.
+  std::atomic<std::uint64_t> version;
+
+  /// @brief Odd while the writer is updating the stats, even otherwise.
+  std::atomic<std::uint64_t> sequence;
+
+  /// @brief The stats.
+  std::array<std::atomic<std::uint64_t>, NUM_OF_WORDS> words;
+};
+
+/**
+ * @brief Maps a named shared memory segment.
+ *
+ * @param name The name of the segment.
+ * @param create If true, create or recreate the segment for writing,
+ * otherwise open an existing segment for reading.
+ * @param mapping_handle The handle of the mapping on Windows, unused elsewhere.
+ *
+ * @return The mapped segment, nullptr if it could not be mapped.
+ */
+static auto map_segment(const std::string &name, bool create,
+                        void *&mapping_handle) -> LiveStatsSegment *
+{
+#ifdef _WIN32
+  std::string mapping_name = "Local\\baccarat-" + name;
+  HANDLE handle =
+      create ? CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr,
+                                  PAGE_READWRITE, 0, sizeof(LiveStatsSegment),
+                                  mapping_name.c_str())
+             : OpenFileMappingA(FILE_MAP_READ, FALSE, mapping_name.c_str());
+  if (handle == nullptr)
+  {
+    return nullptr;
+  }
+  void *view = MapViewOfFile(handle, create ? FILE_MAP_WRITE : FILE_MAP_READ,
+                             0, 0, sizeof(LiveStatsSegment));
+  if (view == nullptr)
+  {
+    CloseHandle(handle);
+    return nullptr;
+  }
+  mapping_handle = handle;
+  return static_cast<LiveStatsSegment *>(view);
+#else
+  // Shared memory objects are named like files in the root directory.
+  std::string shm_name = "/baccarat-" + name;
+  int fd = create ? shm_open(shm_name.c_str(), O_CREAT | O_RDWR, 0644)
+                  : shm_open(shm_name.c_str(), O_RDONLY, 0);
+  if (fd < 0)
+  {
+    return nullptr;
+  }
+
+  // A reader must not map a segment that is too small, e.g. while the writer
+  // is still creating it.
+  struct stat segment_stat = {};
+  if ((create && ftruncate(fd, sizeof(LiveStatsSegment)) != 0) ||
+      fstat(fd, &segment_stat) != 0 ||
+      static_cast<std::size_t>(segment_stat.st_size) <
+          sizeof(LiveStatsSegment))
+  {
+    close(fd);
+    return nullptr;
+  }
+
+  void *view = mmap(nullptr, sizeof(LiveStatsSegment),
+                    create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED,
+                    fd, 0);
+  close(fd);
+  mapping_handle = nullptr;
+  return view == MAP_FAILED ? nullptr : static_cast<LiveStatsSegment *>(view);
+#endif
+}
+
+/**
+ * @brief Unmaps a segment mapped by map_segment.
+ *
+ * @param segment The mapped segment, nothing is done if it is nullptr.
+ * @param mapping_handle The handle of the mapping on Windows.
+ */
+static void unmap_segment(void *segment, void *mapping_handle)
+{
+  if (segment == nullptr)
+  {
+    return;
+  }
+#ifdef _WIN32
+  UnmapViewOfFile(segment);
+  CloseHandle(static_cast<HANDLE>(mapping_handle));
+#else
+  (void)mapping_handle;
+  munmap(segment, sizeof(LiveStatsSegment));
+#endif
+}
+
+// CONSTRUCTORS
+
+LiveStatsWriter::LiveStatsWriter(const std::string &name)
+{
+  if (name.empty())
+  {
+    return;
+  }
+
+  LiveStatsSegment *live_stats_segment =
+      map_segment(name, true, mapping_handle);
+  if (live_stats_segment == nullptr)
+  {
+    printf("Failed to create the live stats segment '%s'.\n", name.c_str());
+    return;
+  }
+
+  // Readers ignore the segment until the magic number is written, so a
+  // segment left by an older build is never read half initialized.
+  live_stats_segment->magic.store(0, std::memory_order_relaxed);
+  live_stats_segment->version.store(sizeof(LiveStats),
+                                    std::memory_order_relaxed);
+  live_stats_segment->sequence.store(0, std::memory_order_relaxed);
+  for (std::atomic<std::uint64_t> &word : live_stats_segment->words)
+  {
+    word.store(0, std::memory_order_relaxed);
+  }
+  live_stats_segment->magic.store(LiveStatsSegment::MAGIC,
+                                  std::memory_order_release);
+  segment = live_stats_segment;
+}
+
+LiveStatsWriter::~LiveStatsWriter() { unmap_segment(segment, mapping_handle); }
+
+LiveStatsReader::~LiveStatsReader() { unmap_segment(segment, mapping_handle); }
+
+// PUBLIC METHODS
+
+auto LiveStatsWriter::is_enabled() const -> bool { return segment != nullptr; }
+
+void LiveStatsWriter::publish(const LiveStats &live_stats)
+{
+  if (segment == nullptr)
+  {
+    return;
+  }
+
+  std::array<std::uint64_t, LiveStatsSegment::NUM_OF_WORDS> words = {};
+  std::memcpy(words.data(), &live_stats, sizeof(LiveStats));
+
+  // There is a single writer, so the sequence number is only made odd while
+  // the words are stored and even again once they all are.
+  auto *live_stats_segment = static_cast<LiveStatsSegment *>(segment);
+  std::uint64_t sequence =
+      live_stats_segment->sequence.load(std::memory_order_relaxed);
+  live_stats_segment->sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (std::size_t i = 0; i < words.size(); ++i)
+  {
+    live_stats_segment->words[i].store(words[i], std::memory_order_relaxed);
+  }
+  live_stats_segment->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+auto LiveStatsReader::open(const std::string &name) -> bool
+{
+  unmap_segment(segment, mapping_handle);
+  segment = nullptr;
+
+  LiveStatsSegment *live_stats_segment =
+      map_segment(name, false, mapping_handle);
+  if (live_stats_segment == nullptr)
+  {
+    return false;
+  }
+  if (live_stats_segment->magic.load(std::memory_order_acquire) !=
+          LiveStatsSegment::MAGIC ||
+      live_stats_segment->version.load(std::memory_order_relaxed) !=
+          sizeof(LiveStats))
+  {
+    unmap_segment(live_stats_segment, mapping_handle);
+    return false;
+  }
+  segment = live_stats_segment;
+  return true;
+}
+
+auto LiveStatsReader::read(LiveStats &live_stats) const -> bool
+{
+  if (segment == nullptr)
+  {
+    return false;
+  }
+
+  const auto *live_stats_segment = static_cast<LiveStatsSegment *>(segment);
+  std::array<std::uint64_t, LiveStatsSegment::NUM_OF_WORDS> words = {};
+  for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt)
+  {
+    std::uint64_t sequence =
+        live_stats_segment->sequence.load(std::memory_order_acquire);
+    if (sequence % 2 != 0)
+    {
+      continue;
+    }
+    for (std::size_t i = 0; i < words.size(); ++i)
+    {
+      words[i] = live_stats_segment->words[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (live_stats_segment->sequence.load(std::memory_order_relaxed) ==
+        sequence)
+    {
+      // LiveStats is trivially copyable, copying its bytes rather than the
+      // struct keeps -Wclass-memaccess quiet about its member initializers.
+      std::memcpy(reinterpret_cast<unsigned char *>(&live_stats), words.data(),
+                  sizeof(LiveStats));
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace BACCARAT
@@ -0,0 +1,180 @@
+#ifndef LIVE_STATS_H
+#define LIVE_STATS_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief The running results of a single configuration, see LiveStats.
+ */
+struct LiveConfigStats
+{
+  /// @brief The name of the configuration, truncated and null terminated.
+  std::array<char, 32> name = {};
+
+  /// @brief The expected profit of the player per round dealt.
+  double ev_per_round = 0.0;
+
+  /// @brief The half width of the 95% confidence interval of ev_per_round.
+  double ev_per_round_confidence_interval = 0.0;
+
+  /// @brief The expected profit of the player per unit wagered.
+  double ev_per_unit_wagered = 0.0;
+};
+
+/**
+ * @brief The running counters of a simulation, published while it runs.
+ *
+ * @note The struct is copied word for word into shared memory, so it must
+ * only hold fixed size values and keep a size that is a multiple of 8 bytes.
+ */
+struct LiveStats
+{
+  /// @brief The most configurations published, the rest are left out.
+  static constexpr std::size_t MAX_CONFIGS = 16;
+
+  /// @brief The number of shoes dealt. Every shoe starts from a reset deck.
+  std::uint64_t num_of_shoes = 0;
+
+  /// @brief The number of shoes the simulation will deal in total.
+  std::uint64_t num_of_shoes_to_deal = 0;
+
+  /// @brief The number of rounds dealt.
+  std::uint64_t num_of_rounds = 0;
+
+  /// @brief The number of rounds won by the PLAYER, BANKER and TIE.
+  std::array<std::uint64_t, 3> outcome_counts = {};
+
+  /// @brief The number of cards of each type dealt, from A to K.
+  std::array<std::uint64_t, 13> card_counts = {};
+
+  /// @brief The number of seconds since the simulation started.
+  double elapsed_seconds = 0.0;
+
+  /// @brief The number of rounds dealt per second since the simulation
+  /// started.
+  double rounds_per_second = 0.0;
+
+  /// @brief 1 once the simulation has finished, 0 while it is running.
+  std::uint64_t finished = 0;
+
+  /// @brief The number of configurations published.
+  std::uint64_t num_of_configs = 0;
+
+  /// @brief The running results of each configuration.
+  std::array<LiveConfigStats, MAX_CONFIGS> configs = {};
+};
+
+/**
+ * @brief A class to publish LiveStats to a named shared memory segment.
+ *
+ * @details The segment is a seqlock: the writer makes the sequence number odd,
+ * copies the stats in and makes it even again. Readers never take a lock and
+ * never write to the segment, they copy the stats and retry if the sequence
+ * number was odd or changed while copying. A simulation thread publishing its
+ * stats is therefore never blocked or slowed down by readers.
+ *
+ * @note The segment stays after the simulation ends, so the final stats can
+ * still be read, and is recreated by the next writer with the same name. On
+ * Windows it is removed once the writer and every reader have closed it.
+ */
+class LiveStatsWriter
+{
+public:
+  /**
+   * @brief Constructor for the LiveStatsWriter class.
+   *
+   * @param name The name of the segment, empty to disable publishing.
+   */
+  explicit LiveStatsWriter(const std::string &name);
+
+  LiveStatsWriter(const LiveStatsWriter &) = delete;
+  auto operator=(const LiveStatsWriter &) -> LiveStatsWriter & = delete;
+
+  /**
+   * @brief Destructor for the LiveStatsWriter class, unmaps the segment.
+   */
+  ~LiveStatsWriter();
+
+  /**
+   * @brief Determines if the segment was created.
+   *
+   * @return true if stats are published, false otherwise.
+   */
+  [[nodiscard]] auto is_enabled() const -> bool;
+
+  /**
+   * @brief Publishes the stats, replacing the stats published before.
+   *
+   * @param live_stats The stats to publish.
+   */
+  void publish(const LiveStats &live_stats);
+
+private:
+  /// @brief The mapped segment, nullptr if publishing is disabled.
+  void *segment = nullptr;
+
+  /// @brief The handle of the mapping on Windows, unused elsewhere.
+  void *mapping_handle = nullptr;
+};
+
+/**
+ * @brief A class to read LiveStats from a named shared memory segment.
+ *
+ * @details See LiveStatsWriter for how a consistent copy is read without
+ * blocking the writer.
+ */
+class LiveStatsReader
+{
+public:
+  /**
+   * @brief Default Constructor for the LiveStatsReader class.
+   */
+  LiveStatsReader() = default;
+
+  LiveStatsReader(const LiveStatsReader &) = delete;
+  auto operator=(const LiveStatsReader &) -> LiveStatsReader & = delete;
+
+  /**
+   * @brief Destructor for the LiveStatsReader class, unmaps the segment.
+   */
+  ~LiveStatsReader();
+
+  /**
+   * @brief Opens a segment created by a LiveStatsWriter.
+   *
+   * @param name The name of the segment.
+   *
+   * @return true if the segment exists and has the same version, false
+   * otherwise.
+   */
+  auto open(const std::string &name) -> bool;
+
+  /**
+   * @brief Reads a consistent copy of the stats.
+   *
+   * @param live_stats The stats to update.
+   *
+   * @return true if the stats were read, false if the writer kept updating
+   * them while they were copied.
+   */
+  auto read(LiveStats &live_stats) const -> bool;
+
+private:
+  /// @brief The number of times a read is retried before giving up.
+  static constexpr int MAX_READ_ATTEMPTS = 1000;
+
+  /// @brief The mapped segment, nullptr if no segment is open.
+  void *segment = nullptr;
+
+  /// @brief The handle of the mapping on Windows, unused elsewhere.
+  void *mapping_handle = nullptr;
+};
+
+} // namespace BACCARAT
+
+#endif // LIVE_STATS_H
@@ -1,9 +1,21 @@
 #include "baccarat.h"
+#include "command_line.h"
 
-auto main() -> int
+#include <string>
+#include <vector>
+
+auto main(int argc, char *argv[]) -> int
 {
+  // Run a subcommand if one was given, otherwise start the interactive game.
+  if (argc > 1)
+  {
+    BACCARAT::CommandLine command_line(
+        std::vector<std::string>(argv + 1, argv + argc));
+    return command_line.run();
+  }
+
   BACCARAT::Baccarat game;
   game.state_machine();
 
   return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,119 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace BACCARAT
+{
+
+// CONSTRUCTORS
+
+MappedFile::~MappedFile() { close(); }
+
+// PUBLIC METHODS
+
+auto MappedFile::open(const std::string &path) -> bool
+{
+  close();
+
+#ifdef _WIN32
+  HANDLE file_handle =
+      CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file_handle == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+  LARGE_INTEGER file_size = {};
+  if (!GetFileSizeEx(file_handle, &file_size))
+  {
+    CloseHandle(file_handle);
+    return false;
+  }
+  size = static_cast<std::size_t>(file_size.QuadPart);
+  if (size == 0)
+  {
+    // An empty file cannot be mapped, but is still a valid file.
+    CloseHandle(file_handle);
+    return true;
+  }
+
+  HANDLE handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0,
+                                     0, nullptr);
+  CloseHandle(file_handle);
+  if (handle == nullptr)
+  {
+    size = 0;
+    return false;
+  }
+  void *view = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+  if (view == nullptr)
+  {
+    CloseHandle(handle);
+    size = 0;
+    return false;
+  }
+  mapping_handle = handle;
+  data = static_cast<const std::uint8_t *>(view);
+  return true;
+#else
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return false;
+  }
+  struct stat file_stat = {};
+  if (fstat(fd, &file_stat) != 0)
+  {
+    ::close(fd);
+    return false;
+  }
+  size = static_cast<std::size_t>(file_stat.st_size);
+  if (size == 0)
+  {
+    // An empty file cannot be mapped, but is still a valid file.
+    ::close(fd);
+    return true;
+  }
+
+  void *view = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (view == MAP_FAILED)
+  {
+    size = 0;
+    return false;
+  }
+  data = static_cast<const std::uint8_t *>(view);
+  return true;
+#endif
+}
+
+auto MappedFile::get_data() const -> const std::uint8_t * { return data; }
+
+auto MappedFile::get_size() const -> std::size_t { return size; }
+
+// PRIVATE METHODS
+
+void MappedFile::close()
+{
+  if (data != nullptr)
+  {
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle(static_cast<HANDLE>(mapping_handle));
+#else
+    munmap(const_cast<std::uint8_t *>(data), size);
+#endif
+  }
+  data = nullptr;
+  size = 0;
+  mapping_handle = nullptr;
+}
+
+} // namespace BACCARAT
@@ -0,0 +1,78 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief A class to map a whole file into memory for reading.
+ *
+ * @details The pages of the file are only read from disk when they are first
+ * touched, so a large file can be opened instantly and only the parts that
+ * are used are ever read.
+ *
+ * @note The mapping starts at a page boundary, so values stored at offsets
+ * aligned to their size can be read in place.
+ */
+class MappedFile
+{
+public:
+  /**
+   * @brief Default Constructor for the MappedFile class.
+   */
+  MappedFile() = default;
+
+  MappedFile(const MappedFile &) = delete;
+  auto operator=(const MappedFile &) -> MappedFile & = delete;
+
+  /**
+   * @brief Destructor for the MappedFile class, unmaps the file.
+   */
+  ~MappedFile();
+
+  /**
+   * @brief Maps a file, unmapping the file mapped before.
+   *
+   * @param path The path of the file.
+   *
+   * @return true if the file was mapped, false otherwise.
+   */
+  auto open(const std::string &path) -> bool;
+
+  /**
+   * @brief Get the bytes of the file.
+   *
+   * @return The bytes, nullptr if no file is mapped or the file is empty.
+   */
+  [[nodiscard]] auto get_data() const -> const std::uint8_t *;
+
+  /**
+   * @brief Get the size of the file.
+   *
+   * @return The number of bytes in the file.
+   */
+  [[nodiscard]] auto get_size() const -> std::size_t;
+
+private:
+  /// @brief The mapped bytes, nullptr if no file is mapped.
+  const std::uint8_t *data = nullptr;
+
+  /// @brief The number of bytes in the file.
+  std::size_t size = 0;
+
+  /// @brief The handle of the mapping on Windows, unused elsewhere.
+  void *mapping_handle = nullptr;
+
+  /**
+   * @brief Unmaps the file, if one is mapped.
+   */
+  void close();
+};
+
+} // namespace BACCARAT
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,193 @@
+#include "packed_shoe.h"
+#include "card_dealer.h"
+
+namespace BACCARAT
+{
+
+static_assert(sizeof(PackedShoe) == 32, "A packed shoe should be 32 bytes.");
+
+// CONSTRUCTORS
+
+PackedShoeBatch::PackedShoeBatch(const RuleSet &rules, double penetration)
+    : max_draws_per_card(CardDealer::CARDS_OF_EACH_TYPE_PER_DECK *
+                         rules.num_of_decks),
+      total_cards_in_deck(CardDealer::CARDS_PER_DECK * rules.num_of_decks),
+      cut_card_position(static_cast<int>(penetration * total_cards_in_deck))
+{
+}
+
+// PUBLIC METHODS
+
+void PackedShoeBatch::clear()
+{
+  shoes.clear();
+  shoes_in_play.clear();
+}
+
+void PackedShoeBatch::add_shoe(std::uint64_t shoe_seed)
+{
+  PackedShoe shoe;
+  for (int i = 0; i < CardDealer::NUM_OF_UNIQUE_CARDS; ++i)
+  {
+    shoe.remaining_cards[i / COUNTS_PER_WORD] |=
+        static_cast<std::uint64_t>(max_draws_per_card)
+        << (BITS_PER_COUNT * (i % COUNTS_PER_WORD));
+  }
+  shoe.key = shoe_seed;
+  shoe.num_of_cards_remaining = static_cast<std::uint16_t>(total_cards_in_deck);
+
+  if (is_in_play(shoe))
+  {
+    shoes_in_play.push_back(static_cast<std::uint32_t>(shoes.size()));
+  }
+  shoes.push_back(shoe);
+}
+
+auto PackedShoeBatch::get_num_of_shoes() const -> std::size_t
+{
+  return shoes.size();
+}
+
+void PackedShoeBatch::deal_next_rounds(std::vector<std::uint32_t> &shoe_indexes,
+                                       std::vector<RoundResult> &round_results)
+{
+  shoe_indexes.resize(shoes_in_play.size());
+  round_results.resize(shoes_in_play.size());
+
+  // The shoes still in play are kept in order as the finished ones drop out.
+  std::size_t num_of_shoes_in_play = 0;
+  for (std::size_t i = 0; i < shoe_indexes.size(); ++i)
+  {
+    std::uint32_t shoe_index = shoes_in_play[i];
+    PackedShoe &shoe = shoes[shoe_index];
+    deal_round(shoe, round_results[i]);
+    shoe_indexes[i] = shoe_index;
+    if (is_in_play(shoe))
+    {
+      shoes_in_play[num_of_shoes_in_play++] = shoe_index;
+    }
+  }
+  shoes_in_play.resize(num_of_shoes_in_play);
+}
+
+void PackedShoeBatch::deal_round(PackedShoe &shoe, RoundResult &round_result)
+{
+  auto deal_a_card = [&shoe](std::array<int, 3> &cards, int &num_of_cards,
+                             int &hand_value)
+  {
+    int card_type = draw_card(shoe);
+    cards[num_of_cards++] = card_type;
+    hand_value = (hand_value + CardDealer::get_card_value(card_type)) %
+                 HAND_VALUE_MODULO;
+    return card_type;
+  };
+
+  round_result.num_of_player_cards = 0;
+  round_result.num_of_banker_cards = 0;
+  round_result.player_hand_value = 0;
+  round_result.banker_hand_value = 0;
+
+  deal_a_card(round_result.player_cards, round_result.num_of_player_cards,
+              round_result.player_hand_value);
+  deal_a_card(round_result.player_cards, round_result.num_of_player_cards,
+              round_result.player_hand_value);
+  deal_a_card(round_result.banker_cards, round_result.num_of_banker_cards,
+              round_result.banker_hand_value);
+  deal_a_card(round_result.banker_cards, round_result.num_of_banker_cards,
+              round_result.banker_hand_value);
+
+  if (!CardDealer::player_or_banker_has_natural_hand(
+          round_result.player_hand_value, round_result.banker_hand_value))
+  {
+    int player_third_card = -1;
+    if (CardDealer::player_can_draw_third_card(round_result.player_hand_value))
+    {
+      player_third_card = deal_a_card(round_result.player_cards,
+                                      round_result.num_of_player_cards,
+                                      round_result.player_hand_value);
+    }
+    if (CardDealer::banker_can_draw_third_card(round_result.banker_hand_value,
+                                               player_third_card))
+    {
+      deal_a_card(round_result.banker_cards, round_result.num_of_banker_cards,
+                  round_result.banker_hand_value);
+    }
+  }
+
+  if (round_result.player_hand_value > round_result.banker_hand_value)
+  {
+    round_result.outcome = BetType::PLAYER;
+  }
+  else if (round_result.banker_hand_value > round_result.player_hand_value)
+  {
+    round_result.outcome = BetType::BANKER;
+  }
+  else
+  {
+    round_result.outcome = BetType::TIE;
+  }
+}
+
+// PRIVATE METHODS
+
+auto PackedShoeBatch::is_in_play(const PackedShoe &shoe) const -> bool
+{
+  int num_of_cards_dealt = total_cards_in_deck - shoe.num_of_cards_remaining;
+  return num_of_cards_dealt < cut_card_position &&
+         num_of_cards_dealt + MAX_CARDS_IN_ROUND <= total_cards_in_deck;
+}
+
+auto PackedShoeBatch::draw_card(PackedShoe &shoe) -> int
+{
+  constexpr std::uint64_t COUNT_MASK = (1ULL << BITS_PER_COUNT) - 1;
+
+  // Pick one of the remaining cards uniformly with Lemire's multiply and
+  // shift method, see CardDealer::draw_uniform_position.
+  std::uint32_t range = shoe.num_of_cards_remaining;
+  std::uint64_t product = (draw_random_bits(shoe) >> 32U) * range;
+  auto low_bits = static_cast<std::uint32_t>(product);
+  if (low_bits < range)
+  {
+    std::uint32_t threshold = (0U - range) % range;
+    while (low_bits < threshold)
+    {
+      product = (draw_random_bits(shoe) >> 32U) * range;
+      low_bits = static_cast<std::uint32_t>(product);
+    }
+  }
+  auto card_position = static_cast<std::uint32_t>(product >> 32U);
+
+  // Walk the counts until the position falls within a card type.
+  int card_type = 0;
+  for (; card_type < CardDealer::NUM_OF_UNIQUE_CARDS - 1; ++card_type)
+  {
+    auto count = static_cast<std::uint32_t>(
+        (shoe.remaining_cards[card_type / COUNTS_PER_WORD] >>
+         (BITS_PER_COUNT * (card_type % COUNTS_PER_WORD))) &
+        COUNT_MASK);
+    if (card_position < count)
+    {
+      break;
+    }
+    card_position -= count;
+  }
+
+  shoe.remaining_cards[card_type / COUNTS_PER_WORD] -=
+      1ULL << (BITS_PER_COUNT * (card_type % COUNTS_PER_WORD));
+  --shoe.num_of_cards_remaining;
+  return card_type;
+}
+
+auto PackedShoeBatch::draw_random_bits(PackedShoe &shoe) -> std::uint64_t
+{
+  // SplitMix64 of the key offset by the counter, the same mix as
+  // Simulation::get_shoe_seed.
+  std::uint64_t hash =
+      shoe.key + (static_cast<std::uint64_t>(++shoe.counter) *
+                  0x9E3779B97F4A7C15ULL);
+  hash = (hash ^ (hash >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+  hash = (hash ^ (hash >> 27U)) * 0x94D049BB133111EBULL;
+  return hash ^ (hash >> 31U);
+}
+
+} // namespace BACCARAT
@@ -0,0 +1,169 @@
+#ifndef PACKED_SHOE_H
+#define PACKED_SHOE_H
+
+#include "round_result.h"
+#include "rule_set.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief The state of a shoe packed into 32 bytes.
+ *
+ * @details The number of cards of each type remaining is a 6 bit field, the
+ * first 10 card types in the first word and the last 3 in the second. Cards
+ * are drawn with a counter based generator, the SplitMix64 stream of the key,
+ * so the generator state is the key and the number of draws.
+ */
+struct PackedShoe
+{
+  /// @brief The number of cards of each type remaining, 6 bits each.
+  std::array<std::uint64_t, 2> remaining_cards = {};
+
+  /// @brief The key of the random number stream, the shoe seed.
+  std::uint64_t key = 0;
+
+  /// @brief The number of random numbers drawn from the stream.
+  std::uint32_t counter = 0;
+
+  /// @brief The number of cards remaining in the shoe.
+  std::uint16_t num_of_cards_remaining = 0;
+};
+
+/**
+ * @brief A class to deal many packed shoes in lockstep.
+ *
+ * @details Every call to deal_next_rounds deals a round from each shoe that
+ * has not reached its cut card, so the shoes of a batch are dealt side by
+ * side instead of one after the other. A shoe only takes sizeof(PackedShoe)
+ * bytes, against the kilobytes of a CardDealer and its Mersenne Twister, so
+ * millions of shoes fit in memory and a batch of them stays in the cache.
+ *
+ * @note Only a FINITE_SHOE with a random shuffle can be packed, and a shoe
+ * holds at most MAX_DECKS decks. The cards are drawn from a different random
+ * number stream than a CardDealer with the same seed, so a packed shoe deals
+ * different cards with the same odds.
+ */
+class PackedShoeBatch
+{
+public:
+  /**
+   * @brief Constructor for the PackedShoeBatch class.
+   *
+   * @param rules The table rules, used for the number of decks in a shoe.
+   * @param penetration The fraction of a shoe dealt before the cut card is
+   * reached.
+   */
+  PackedShoeBatch(const RuleSet &rules, double penetration);
+
+  /**
+   * @brief Removes every shoe from the batch.
+   */
+  void clear();
+
+  /**
+   * @brief Adds a full shoe to the batch.
+   *
+   * @param shoe_seed The seed of the shoe, the same seed always deals the
+   * same shoe.
+   */
+  void add_shoe(std::uint64_t shoe_seed);
+
+  /**
+   * @brief Get the number of shoes in the batch.
+   *
+   * @return The number of shoes added since the batch was last cleared.
+   */
+  [[nodiscard]] auto get_num_of_shoes() const -> std::size_t;
+
+  /**
+   * @brief Deals the next round of every shoe that has not reached its cut
+   * card.
+   *
+   * @param shoe_indexes The index of every shoe dealt, in the order the shoes
+   * were added. Empty once every shoe has reached its cut card.
+   * @param round_results The round dealt from each of those shoes.
+   */
+  void deal_next_rounds(std::vector<std::uint32_t> &shoe_indexes,
+                        std::vector<RoundResult> &round_results);
+
+  /**
+   * @brief Deals a round of Baccarat from a packed shoe.
+   *
+   * @details The cards are dealt with the same rules as
+   * CardDealer::deal_round.
+   *
+   * @param shoe The shoe, which must hold enough cards for a round.
+   * @param round_result The cards, hand values and outcome of the round.
+   */
+  static void deal_round(PackedShoe &shoe, RoundResult &round_result);
+
+  /// @brief The most decks in a shoe, the most cards of a type that fit in a
+  /// 6 bit field is 63.
+  static constexpr int MAX_DECKS = 15;
+
+private:
+  /// @brief The number of bits of a count of remaining cards.
+  static constexpr int BITS_PER_COUNT = 6;
+
+  /// @brief The number of counts in a word of remaining cards.
+  static constexpr int COUNTS_PER_WORD = 10;
+
+  /// @brief The most cards that can be dealt in a single round.
+  static constexpr int MAX_CARDS_IN_ROUND = 6;
+
+  /// @brief The modulo value used to calculate the hand value.
+  static constexpr int HAND_VALUE_MODULO = 10;
+
+  /// @brief The number of cards of each type in a full shoe.
+  int max_draws_per_card = 0;
+
+  /// @brief The number of cards in a full shoe.
+  int total_cards_in_deck = 0;
+
+  /// @brief The number of cards dealt before the cut card is reached.
+  int cut_card_position = 0;
+
+  /// @brief The shoes of the batch.
+  std::vector<PackedShoe> shoes;
+
+  /// @brief The indexes of the shoes that have not reached their cut card,
+  /// in the order they were added.
+  std::vector<std::uint32_t> shoes_in_play;
+
+  /**
+   * @brief Determines if the next round of a shoe is dealt.
+   *
+   * @param shoe The shoe.
+   *
+   * @return true if the cut card has not been reached and a full round can
+   * be dealt, false otherwise.
+   */
+  [[nodiscard]] auto is_in_play(const PackedShoe &shoe) const -> bool;
+
+  /**
+   * @brief Draws a card from a packed shoe.
+   *
+   * @param shoe The shoe, which must not be empty.
+   *
+   * @return The card type drawn.
+   */
+  static auto draw_card(PackedShoe &shoe) -> int;
+
+  /**
+   * @brief Draws the next random number of the stream of a shoe.
+   *
+   * @param shoe The shoe.
+   *
+   * @return 64 random bits.
+   */
+  static auto draw_random_bits(PackedShoe &shoe) -> std::uint64_t;
+};
+
+} // namespace BACCARAT
+
+#endif // PACKED_SHOE_H
@@ -0,0 +1,126 @@
+#include "parameter_sweep.h"
+#include "results_table.h"
+
+#include <cstdio>
+#include <map>
+#include <utility>
+
+namespace BACCARAT
+{
+
+// CONSTRUCTORS
+
+ParameterSweep::ParameterSweep(std::vector<SweepPoint> points,
+                               SimulationOptions options)
+    : points(std::move(points)), options(std::move(options))
+{
+  // A sweep is a set of short runs, so it is not checkpointed.
+  this->options.checkpoint = CheckpointOptions();
+}
+
+// PUBLIC METHODS
+
+auto ParameterSweep::run(const std::string &output_path) -> bool
+{
+  // Group the points that deal the same shoes, in the order they first
+  // appear in the grid.
+  std::vector<std::vector<std::size_t>> groups;
+  std::map<std::pair<int, double>, std::size_t> group_indexes;
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    std::pair<int, double> shoe_key = {points[i].rules.num_of_decks,
+                                       points[i].penetration};
+    auto group_index = group_indexes.find(shoe_key);
+    if (group_index == group_indexes.end())
+    {
+      group_index = group_indexes.emplace(shoe_key, groups.size()).first;
+      groups.emplace_back();
+    }
+    groups[group_index->second].push_back(i);
+  }
+
+  std::vector<SimulationResult> group_results(groups.size());
+  std::vector<std::pair<std::size_t, std::size_t>> point_results(
+      points.size());
+  for (std::size_t group_index = 0; group_index < groups.size();
+       ++group_index)
+  {
+    const std::vector<std::size_t> &group = groups[group_index];
+    const SweepPoint &first_point = points[group[0]];
+    printf("Dealing shoes %zu of %zu: %d decks, %.4g penetration, %zu "
+           "configurations\n",
+           group_index + 1, groups.size(), first_point.rules.num_of_decks,
+           first_point.penetration, group.size());
+
+    std::vector<SimulationConfig> configs;
+    for (std::size_t i = 0; i < group.size(); ++i)
+    {
+      const SweepPoint &point = points[group[i]];
+      configs.push_back({point.name, point.rules, point.strategy});
+      point_results[group[i]] = {group_index, i};
+    }
+
+    SimulationOptions group_options = options;
+    group_options.penetration = first_point.penetration;
+    Simulation simulation(configs, group_options);
+    if (!simulation.run(group_results[group_index]))
+    {
+      return false;
+    }
+  }
+
+  ResultsTable results_table;
+  results_table.add_string_column("point");
+  results_table.add_string_column("strategy");
+  for (const char *column_name :
+       {"decks", "penetration", "player_payout", "banker_payout",
+        "banker_commission", "tie_payout", "push_on_tie", "shoes", "rounds",
+        "p_player", "p_banker", "p_tie", "ev_per_round", "ev_per_round_ci",
+        "ev_per_wagered", "ev_per_wagered_ci"})
+  {
+    results_table.add_number_column(column_name);
+  }
+
+  printf("\n%-60s %13s %11s\n", "POINT", "EV/ROUND", "95% CI");
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    const SweepPoint &point = points[i];
+    const SimulationResult &result = group_results[point_results[i].first];
+    const ConfigResult &config_result =
+        result.config_results[point_results[i].second];
+
+    auto num_of_rounds = static_cast<double>(result.num_of_rounds);
+    results_table.add_row(
+        {static_cast<double>(point.rules.num_of_decks), point.penetration,
+         point.rules.payout_player, point.rules.payout_banker,
+         point.rules.banker_commission, point.rules.payout_tie,
+         point.rules.push_on_tie ? 1.0 : 0.0,
+         static_cast<double>(result.num_of_shoes), num_of_rounds,
+         static_cast<double>(result.outcome_counts[0]) / num_of_rounds,
+         static_cast<double>(result.outcome_counts[1]) / num_of_rounds,
+         static_cast<double>(result.outcome_counts[2]) / num_of_rounds,
+         config_result.ev_per_round.get_ratio(),
+         config_result.ev_per_round.get_confidence_interval(),
+         config_result.ev_per_unit_wagered.get_ratio(),
+         config_result.ev_per_unit_wagered.get_confidence_interval()},
+        {point.name, point.strategy.to_string()});
+
+    printf("%-60s %+13.8f %11.8f\n", point.name.c_str(),
+           config_result.ev_per_round.get_ratio(),
+           config_result.ev_per_round.get_confidence_interval());
+  }
+
+  bool is_csv = output_path.size() >= 4 &&
+                output_path.compare(output_path.size() - 4, 4, ".csv") == 0;
+  bool written = is_csv ? results_table.write_csv(output_path)
+                        : results_table.write_columnar(output_path);
+  if (!written)
+  {
+    printf("Failed to write results to '%s'.\n", output_path.c_str());
+    return false;
+  }
+  printf("\nResults written to '%s'.\n\n", output_path.c_str());
+  return true;
+}
+
+} // namespace BACCARAT
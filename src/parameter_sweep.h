@@ -0,0 +1,72 @@
+#ifndef PARAMETER_SWEEP_H
+#define PARAMETER_SWEEP_H
+
+#include "bet_strategy.h"
+#include "rule_set.h"
+#include "simulation.h"
+
+#include <string>
+#include <vector>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief A single point of a parameter sweep.
+ */
+struct SweepPoint
+{
+  /// @brief The parameter values of the point, e.g. 'decks=6 tie-payout=9'.
+  std::string name;
+
+  /// @brief The table rules of the point.
+  RuleSet rules;
+
+  /// @brief The betting strategy of the point.
+  BetStrategy strategy;
+
+  /// @brief The fraction of the shoe dealt before the cut card is reached.
+  double penetration = 0.9;
+};
+
+/**
+ * @brief A class to simulate a grid of configurations and write a single
+ * table of results.
+ *
+ * @details Points that deal the same shoes, i.e. that only differ in payouts
+ * or betting strategy, are grouped into a single Simulation so every shoe is
+ * dealt once and settled for every point in the group. Each group is dealt
+ * across the whole thread pool.
+ */
+class ParameterSweep
+{
+public:
+  /**
+   * @brief Constructor for the ParameterSweep class.
+   *
+   * @param points The points of the grid.
+   * @param options The simulation options shared by every point.
+   */
+  ParameterSweep(std::vector<SweepPoint> points, SimulationOptions options);
+
+  /**
+   * @brief Runs the sweep and writes the results table.
+   *
+   * @param output_path The path of the results table. A path ending in '.csv'
+   * is written as CSV, any other path as a columnar binary file.
+   *
+   * @return true if the sweep finished and the table was written.
+   */
+  auto run(const std::string &output_path) -> bool;
+
+private:
+  /// @brief The points of the grid.
+  std::vector<SweepPoint> points;
+
+  /// @brief The simulation options shared by every point.
+  SimulationOptions options;
+};
+
+} // namespace BACCARAT
+
+#endif // PARAMETER_SWEEP_H
@@ -0,0 +1,131 @@
+#ifndef RANK_SAMPLER_H
+#define RANK_SAMPLER_H
+
+#include <array>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief A class to sample card types in proportion to their weights.
+ *
+ * @details The weights are stored in a Fenwick tree, so a weight can be
+ * updated and a card type found from a position in the cumulative weights in
+ * O(log 13) steps. With the number of cards remaining as the weights, every
+ * draw is exactly proportional to the cards left in the shoe.
+ *
+ * @tparam Weight The type of the weights, int for card counts or double for
+ * tilted weights.
+ */
+template <typename Weight> class RankSampler
+{
+public:
+  /**
+   * @brief Sets every card type to the same weight.
+   *
+   * @param weight The weight of each card type.
+   */
+  void fill(Weight weight)
+  {
+    std::array<Weight, NUM_OF_UNIQUE_CARDS> weights;
+    weights.fill(weight);
+    assign(weights);
+  }
+
+  /**
+   * @brief Sets the weight of every card type.
+   *
+   * @param weights The weight of each card type.
+   */
+  void assign(const std::array<Weight, 13> &weights)
+  {
+    tree.fill(Weight());
+    total_weight = Weight();
+    for (int i = 1; i <= NUM_OF_UNIQUE_CARDS; ++i)
+    {
+      tree[i] += weights[i - 1];
+      total_weight += weights[i - 1];
+
+      // Build the tree in linear time by pushing each node into its parent.
+      int parent = i + (i & -i);
+      if (parent <= TREE_SIZE)
+      {
+        tree[parent] += tree[i];
+      }
+    }
+    for (int i = NUM_OF_UNIQUE_CARDS + 1; i <= TREE_SIZE; ++i)
+    {
+      int parent = i + (i & -i);
+      if (parent <= TREE_SIZE)
+      {
+        tree[parent] += tree[i];
+      }
+    }
+  }
+
+  /**
+   * @brief Adds to the weight of a card type.
+   *
+   * @param card_type The card type.
+   * @param delta The amount to add, negative to remove.
+   */
+  void add(int card_type, Weight delta)
+  {
+    total_weight += delta;
+    for (int i = card_type + 1; i <= TREE_SIZE; i += i & -i)
+    {
+      tree[i] += delta;
+    }
+  }
+
+  /**
+   * @brief Get the sum of every weight.
+   *
+   * @return The total weight.
+   */
+  [[nodiscard]] auto get_total_weight() const -> Weight { return total_weight; }
+
+  /**
+   * @brief Finds the card type at a position in the cumulative weights.
+   *
+   * @param position The position, from 0 up to but excluding the total weight.
+   *
+   * @return The card type whose weight covers the position.
+   */
+  [[nodiscard]] auto find(Weight position) const -> int
+  {
+    // Descend the tree, skipping every subtree whose weight is not larger
+    // than the remaining position.
+    int index = 0;
+    for (int step = TREE_SIZE; step > 0; step /= 2)
+    {
+      if (index + step <= TREE_SIZE && tree[index + step] <= position)
+      {
+        index += step;
+        position -= tree[index];
+      }
+    }
+
+    // Guard against rounding with floating point weights.
+    return index < NUM_OF_UNIQUE_CARDS ? index : NUM_OF_UNIQUE_CARDS - 1;
+  }
+
+private:
+  /// @brief The number of unique cards in a standard deck used in Baccarat.
+  static constexpr int NUM_OF_UNIQUE_CARDS = 13;
+
+  /// @brief The size of the tree, the next power of two above the number of
+  /// card types so it can be descended in a fixed number of steps.
+  static constexpr int TREE_SIZE = 16;
+
+  /// @brief The Fenwick tree, index i covers the card types from
+  /// i - (i & -i) up to i - 1.
+  std::array<Weight, TREE_SIZE + 1> tree = {};
+
+  /// @brief The sum of every weight.
+  Weight total_weight = Weight();
+};
+
+} // namespace BACCARAT
+
+#endif // RANK_SAMPLER_H
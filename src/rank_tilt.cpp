@@ -0,0 +1,33 @@
+#include "rank_tilt.h"
+
+namespace BACCARAT
+{
+
+// PUBLIC METHODS
+
+auto RankTilt::get_deal_state(BetType hand,
+                              int num_of_cards,
+                              int player_hand_value,
+                              int banker_hand_value) -> int
+{
+  int hand_index = hand == BetType::PLAYER ? 0 : 1;
+  return (((hand_index * NUM_OF_CARDS_HELD) + num_of_cards) *
+              NUM_OF_HAND_VALUES +
+          player_hand_value) *
+             NUM_OF_HAND_VALUES +
+         banker_hand_value;
+}
+
+void RankTilt::set_hand_weights(BetType hand,
+                                const std::array<double, 13> &hand_weights)
+{
+  // The deal states of the player come before those of the banker.
+  int num_of_hand_states = NUM_OF_DEAL_STATES / 2;
+  int first_state = hand == BetType::PLAYER ? 0 : num_of_hand_states;
+  for (int i = first_state; i < first_state + num_of_hand_states; ++i)
+  {
+    weights[i] = hand_weights;
+  }
+}
+
+} // namespace BACCARAT
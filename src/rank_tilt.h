@@ -0,0 +1,73 @@
+#ifndef RANK_TILT_H
+#define RANK_TILT_H
+
+#include "bet_type.h"
+
+#include <array>
+#include <vector>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief The weights that tilt the card types drawn towards a rare event.
+ *
+ * @details A tilted card type is drawn in proportion to its weight multiplied
+ * by the number of cards of that type remaining, so a weight of 2 makes a card
+ * type twice as likely as in a fair shoe with the same composition. Every card
+ * of a round has its own weights for each deal state, the hand it is dealt
+ * to, the number of cards that hand already holds and the values of both
+ * hands so far. Whether a round ends in e.g. a BANKER win depends on how the
+ * cards of both hands add up, so a tilt can only make it likely if the banker
+ * cards are drawn knowing what the player holds.
+ *
+ * @note Every weight must be positive, so every card that can be dealt from a
+ * fair shoe can still be dealt from a tilted shoe.
+ */
+struct RankTilt
+{
+  /// @brief The number of card counts a hand can have when a card is dealt to
+  /// it, 0, 1 or 2 cards.
+  static constexpr int NUM_OF_CARDS_HELD = 3;
+
+  /// @brief The number of hand values, 0 to 9.
+  static constexpr int NUM_OF_HAND_VALUES = 10;
+
+  /// @brief The number of deal states, see get_deal_state.
+  static constexpr int NUM_OF_DEAL_STATES =
+      2 * NUM_OF_CARDS_HELD * NUM_OF_HAND_VALUES * NUM_OF_HAND_VALUES;
+
+  /// @brief The weight of each card type in each deal state.
+  std::vector<std::array<double, 13>> weights =
+      std::vector<std::array<double, 13>>(
+          NUM_OF_DEAL_STATES,
+          {1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0});
+
+  /**
+   * @brief Gets the deal state of the next card of a round.
+   *
+   * @param hand The hand the card is dealt to, either PLAYER or BANKER.
+   * @param num_of_cards The number of cards the hand already holds.
+   * @param player_hand_value The value of the player hand so far.
+   * @param banker_hand_value The value of the banker hand so far.
+   *
+   * @return The deal state, from 0 to NUM_OF_DEAL_STATES - 1.
+   */
+  [[nodiscard]] static auto get_deal_state(BetType hand,
+                                           int num_of_cards,
+                                           int player_hand_value,
+                                           int banker_hand_value) -> int;
+
+  /**
+   * @brief Sets the weights of every deal state of a hand.
+   *
+   * @param hand The hand, either PLAYER or BANKER.
+   * @param hand_weights The weight of each card type dealt to the hand.
+   */
+  void set_hand_weights(BetType hand,
+                        const std::array<double, 13> &hand_weights);
+};
+
+} // namespace BACCARAT
+
+#endif // RANK_TILT_H
@@ -0,0 +1,152 @@
+#include "rare_event.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <stdexcept>
+
+namespace BACCARAT
+{
+
+// CONSTRUCTORS
+
+RareEvent::RareEvent() = default;
+
+RareEvent::RareEvent(RareEventType event_type, int target)
+    : event_type(event_type), target(target)
+{
+}
+
+// PUBLIC METHODS
+
+auto RareEvent::from_string(const std::string &event_string,
+                            RareEvent &event) -> bool
+{
+  static const std::array<std::string, 5> EVENT_TYPE_STRINGS = {
+      "banker-streak", "player-streak", "tie-streak", "dragon7", "panda8"};
+
+  std::string lower_event_string = event_string;
+  std::transform(lower_event_string.begin(), lower_event_string.end(),
+                 lower_event_string.begin(),
+                 [](unsigned char event_char)
+                 { return std::tolower(event_char); });
+
+  // Split the string into TYPE and TARGET.
+  std::size_t pos = lower_event_string.find(':');
+  auto event_type_string =
+      std::find(EVENT_TYPE_STRINGS.begin(), EVENT_TYPE_STRINGS.end(),
+                lower_event_string.substr(0, pos));
+  if (event_type_string == EVENT_TYPE_STRINGS.end())
+  {
+    return false;
+  }
+
+  int target = 1;
+  if (pos != std::string::npos)
+  {
+    try
+    {
+      std::size_t num_of_chars_read = 0;
+      target = std::stoi(lower_event_string.substr(pos + 1),
+                         &num_of_chars_read);
+      if (num_of_chars_read != lower_event_string.size() - pos - 1)
+      {
+        return false;
+      }
+    }
+    catch (const std::logic_error &e)
+    {
+      return false;
+    }
+    if (target <= 0)
+    {
+      return false;
+    }
+  }
+
+  event = RareEvent(
+      static_cast<RareEventType>(
+          std::distance(EVENT_TYPE_STRINGS.begin(), event_type_string)),
+      target);
+  return true;
+}
+
+auto RareEvent::to_string() const -> std::string
+{
+  static const std::array<std::string, 5> EVENT_TYPE_STRINGS = {
+      "banker-streak", "player-streak", "tie-streak", "dragon7", "panda8"};
+
+  return EVENT_TYPE_STRINGS[static_cast<std::size_t>(event_type)] + ":" +
+         std::to_string(target);
+}
+
+auto RareEvent::get_description() const -> std::string
+{
+  std::string target_string = std::to_string(target) + " or more ";
+  switch (event_type)
+  {
+  case RareEventType::BANKER_STREAK:
+    return target_string + "BANKER wins in a row";
+  case RareEventType::PLAYER_STREAK:
+    return target_string + "PLAYER wins in a row";
+  case RareEventType::TIE_STREAK:
+    return target_string + "TIE rounds in a row";
+  case RareEventType::DRAGON_SEVEN:
+    return target_string + "Dragon 7s in a row";
+  case RareEventType::PANDA_EIGHT:
+    return target_string + "Panda 8s in a row";
+  default:
+    return "";
+  }
+}
+
+auto RareEvent::get_target() const -> int { return target; }
+
+auto RareEvent::get_streak_length() const -> int { return streak_length; }
+
+void RareEvent::record_round(const RoundResult &round_result)
+{
+  if (extends_streak(round_result))
+  {
+    ++streak_length;
+  }
+  else if (!keeps_streak(round_result))
+  {
+    streak_length = 0;
+  }
+}
+
+auto RareEvent::extends_streak(const RoundResult &round_result) const -> bool
+{
+  switch (event_type)
+  {
+  case RareEventType::BANKER_STREAK:
+    return round_result.outcome == BetType::BANKER;
+  case RareEventType::PLAYER_STREAK:
+    return round_result.outcome == BetType::PLAYER;
+  case RareEventType::TIE_STREAK:
+    return round_result.outcome == BetType::TIE;
+  case RareEventType::DRAGON_SEVEN:
+    return round_result.outcome == BetType::BANKER &&
+           round_result.num_of_banker_cards == THREE_CARDS &&
+           round_result.banker_hand_value == DRAGON_SEVEN_HAND_VALUE;
+  case RareEventType::PANDA_EIGHT:
+    return round_result.outcome == BetType::PLAYER &&
+           round_result.num_of_player_cards == THREE_CARDS &&
+           round_result.player_hand_value == PANDA_EIGHT_HAND_VALUE;
+  default:
+    return false;
+  }
+}
+
+auto RareEvent::keeps_streak(const RoundResult &round_result) const -> bool
+{
+  // Ties neither extend nor break a BANKER or PLAYER streak.
+  return (event_type == RareEventType::BANKER_STREAK ||
+          event_type == RareEventType::PLAYER_STREAK) &&
+         round_result.outcome == BetType::TIE;
+}
+
+void RareEvent::reset_state() { streak_length = 0; }
+
+} // namespace BACCARAT
\ No newline at end of file
@@ -0,0 +1,152 @@
+#ifndef RARE_EVENT_H
+#define RARE_EVENT_H
+
+#include "round_result.h"
+
+#include <cstdint>
+#include <string>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief Enum class to represent the streaks of rounds that can be estimated.
+ */
+enum class RareEventType : std::uint8_t
+{
+  /// @brief BANKER wins in a row, ties neither extend nor break the streak.
+  BANKER_STREAK,
+  /// @brief PLAYER wins in a row, ties neither extend nor break the streak.
+  PLAYER_STREAK,
+  /// @brief Ties in a row.
+  TIE_STREAK,
+  /// @brief Dragon 7s in a row, where the banker wins with a three card 7.
+  DRAGON_SEVEN,
+  /// @brief Panda 8s in a row, where the player wins with a three card 8.
+  PANDA_EIGHT
+};
+
+/**
+ * @brief A class to track a streak of rounds that is rarely long.
+ *
+ * @details Every round either extends the streak, breaks it, or for BANKER
+ * and PLAYER streaks leaves it unchanged on a tie. The event is reached when
+ * the streak reaches the target length. The state is reset with reset_state
+ * at the start of every shoe.
+ *
+ * @note An event is written as TYPE:TARGET, e.g. 'banker-streak:12' or
+ * 'dragon7:3'. TYPE is banker-streak, player-streak, tie-streak, dragon7 or
+ * panda8 and the target defaults to 1.
+ */
+class RareEvent
+{
+public:
+  /**
+   * @brief Default Constructor for the RareEvent class, a streak of 12 BANKER
+   * wins.
+   */
+  RareEvent();
+
+  /**
+   * @brief Constructor for the RareEvent class.
+   *
+   * @param event_type The type of streak.
+   * @param target The length at which the event is reached.
+   */
+  RareEvent(RareEventType event_type, int target);
+
+  /**
+   * @brief Creates an event from its string representation.
+   *
+   * @param event_string The event, e.g. 'banker-streak:12'.
+   * @param event The event to update.
+   *
+   * @return true if the string is a valid event, false otherwise.
+   */
+  static auto from_string(const std::string &event_string,
+                          RareEvent &event) -> bool;
+
+  /**
+   * @brief Converts the event to its string representation.
+   *
+   * @return The string representation, e.g. 'banker-streak:12'.
+   */
+  [[nodiscard]] auto to_string() const -> std::string;
+
+  /**
+   * @brief Describes the event in words.
+   *
+   * @return The description, e.g. '12 or more BANKER wins in a row'.
+   */
+  [[nodiscard]] auto get_description() const -> std::string;
+
+  /**
+   * @brief Get the length at which the event is reached.
+   *
+   * @return The target length.
+   */
+  [[nodiscard]] auto get_target() const -> int;
+
+  /**
+   * @brief Get the length of the current streak.
+   *
+   * @return The length, 0 if no streak is in progress.
+   */
+  [[nodiscard]] auto get_streak_length() const -> int;
+
+  /**
+   * @brief Updates the streak with the outcome of a round.
+   *
+   * @param round_result The round that was just dealt.
+   */
+  void record_round(const RoundResult &round_result);
+
+  /**
+   * @brief Determines if a round extends the streak.
+   *
+   * @param round_result The round.
+   *
+   * @return true if the round adds one to the streak, false otherwise.
+   */
+  [[nodiscard]] auto
+  extends_streak(const RoundResult &round_result) const -> bool;
+
+  /**
+   * @brief Determines if a round leaves the streak as it is.
+   *
+   * @param round_result The round.
+   *
+   * @return true if the round neither extends nor breaks the streak, false
+   * otherwise.
+   */
+  [[nodiscard]] auto
+  keeps_streak(const RoundResult &round_result) const -> bool;
+
+  /**
+   * @brief Resets the streak, e.g. at the start of a new shoe.
+   */
+  void reset_state();
+
+private:
+  /// @brief The hand value of a Dragon 7.
+  static constexpr int DRAGON_SEVEN_HAND_VALUE = 7;
+
+  /// @brief The hand value of a Panda 8.
+  static constexpr int PANDA_EIGHT_HAND_VALUE = 8;
+
+  /// @brief The number of cards in a Dragon 7 or Panda 8 hand.
+  static constexpr int THREE_CARDS = 3;
+
+  /// @brief The type of streak.
+  RareEventType event_type = RareEventType::BANKER_STREAK;
+
+  /// @brief The length at which the event is reached.
+  int target = 12;
+
+  /// @brief The length of the current streak.
+  int streak_length = 0;
+};
+
+} // namespace BACCARAT
+
+#endif // RARE_EVENT_H
\ No newline at end of file
@@ -0,0 +1,682 @@
+#include "rare_event_simulation.h"
+#include "chunk_runner.h"
+#include "simulation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+namespace BACCARAT
+{
+
+// CONSTRUCTORS
+
+RareEventSimulation::RareEventSimulation(const RareEvent &event,
+                                         const RuleSet &rules,
+                                         const RareEventOptions &options)
+    : event(event), rules(rules), options(options),
+      rank_tilt(options.rank_tilt)
+{
+}
+
+// PUBLIC METHODS
+
+void RareEventResult::merge(const RareEventResult &other)
+{
+  num_of_shoes += other.num_of_shoes;
+  num_of_hits += other.num_of_hits;
+  streaks_per_shoe.merge(other.streaks_per_shoe);
+  sum_hit_weights += other.sum_hit_weights;
+  sum_squared_hit_weights += other.sum_squared_hit_weights;
+  for (std::size_t i = 0; i < length_counts.size(); ++i)
+  {
+    length_counts[i] += other.length_counts[i];
+  }
+  for (std::size_t i = 0; i < length_card_counts.size(); ++i)
+  {
+    length_deal_counts[i] += other.length_deal_counts[i];
+    for (std::size_t j = 0; j < length_card_counts[i].size(); ++j)
+    {
+      length_card_counts[i][j] += other.length_card_counts[i][j];
+    }
+  }
+  for (std::size_t hand = 0; hand < tilted_card_counts.size(); ++hand)
+  {
+    for (std::size_t i = 0; i < tilted_card_counts[hand].size(); ++i)
+    {
+      tilted_card_counts[hand][i] += other.tilted_card_counts[hand][i];
+    }
+  }
+}
+
+auto RareEventResult::get_length_index(int length,
+                                       int deal_state) -> std::size_t
+{
+  return (static_cast<std::size_t>(length) * RankTilt::NUM_OF_DEAL_STATES) +
+         deal_state;
+}
+
+void RareEventSimulation::run(RareEventResult &result)
+{
+  if (options.exact_tilt)
+  {
+    set_exact_tilt();
+  }
+  for (int i = 0; i < options.num_of_pilot_runs; ++i)
+  {
+    // The pilot runs deal different shoes from the estimate, so the tuned
+    // tilt does not depend on the shoes it is used on.
+    RareEventResult pilot_result = create_empty_result();
+    std::uint64_t pilot_seed = Simulation::get_shoe_seed(
+        options.seed, ~static_cast<std::uint64_t>(i));
+    run_shoes(pilot_seed, options.num_of_pilot_shoes, pilot_result);
+    int length = update_rank_tilt(pilot_result);
+    printf("Pilot run %d: %llu streaks reached the target in %llu shoes, "
+           "tilt tuned for length %d of %d.\n",
+           i + 1, static_cast<unsigned long long>(pilot_result.num_of_hits),
+           static_cast<unsigned long long>(pilot_result.num_of_shoes), length,
+           event.get_target());
+  }
+
+  result = create_empty_result();
+  run_shoes(options.seed, options.num_of_shoes, result);
+}
+
+void RareEventSimulation::print_result(const RareEventResult &result) const
+{
+  printf("\n--- Rare Event Simulation ---\n\n");
+  printf("Event: %s (%s)\n", event.to_string().c_str(),
+         event.get_description().c_str());
+  printf("Shoes: %llu\nSeed: %llu\nShoe Mode: %s\n",
+         static_cast<unsigned long long>(result.num_of_shoes),
+         static_cast<unsigned long long>(options.seed),
+         get_string_shoe_mode(options.shoe_mode).c_str());
+  if (options.shoe_mode == ShoeMode::CONTINUOUS_SHUFFLE)
+  {
+    printf("Continuous Shuffle Delay: %d rounds\n",
+           options.continuous_shuffle_delay);
+  }
+  printf("Pilot Runs: %d of %llu shoes\n\n", options.num_of_pilot_runs,
+         static_cast<unsigned long long>(options.num_of_pilot_shoes));
+
+  auto num_of_shoes =
+      static_cast<double>(std::max<std::uint64_t>(result.num_of_shoes, 1));
+  printf("Streaks at the target:        %llu (%.4f per shoe dealt)\n",
+         static_cast<unsigned long long>(result.num_of_hits),
+         static_cast<double>(result.num_of_hits) / num_of_shoes);
+  if (result.num_of_hits == 0)
+  {
+    printf("\nNo streak reached the target, deal more shoes or use more "
+           "pilot runs.\n\n");
+    return;
+  }
+
+  // The effective sample size is the number of equally weighted shoes with a
+  // streak that would give the same precision, and the plain Monte Carlo
+  // shoes are the number of fair shoes that would give the same confidence
+  // interval if the number of streaks per shoe is close to a Poisson count.
+  double streaks_per_shoe = result.streaks_per_shoe.get_ratio();
+  double standard_error = result.streaks_per_shoe.get_standard_error();
+  double confidence_interval =
+      result.streaks_per_shoe.get_confidence_interval();
+  double effective_sample_size = result.sum_hit_weights *
+                                 result.sum_hit_weights /
+                                 result.sum_squared_hit_weights;
+  printf("Streaks per shoe:             %.6e\n", streaks_per_shoe);
+  printf("Effective sample size:        %.1f\n", effective_sample_size);
+
+  // A handful of weighted streaks says little about the variance of the
+  // weights, so their standard error is no better than a guess.
+  if (static_cast<double>(result.num_of_hits) < MIN_SAMPLE_SIZE ||
+      effective_sample_size < MIN_SAMPLE_SIZE)
+  {
+    printf("\nToo few streaks reached the target for a confidence interval, "
+           "at least %.0f\nstreaks and an effective sample size of %.0f are "
+           "needed. Deal more shoes or\nuse more pilot runs.\n",
+           MIN_SAMPLE_SIZE, MIN_SAMPLE_SIZE);
+  }
+  else
+  {
+    printf("95%% CI:                       %.6e to %.6e\n",
+           streaks_per_shoe - confidence_interval,
+           streaks_per_shoe + confidence_interval);
+    printf("Relative error:               %.2f%%\n",
+           100.0 * standard_error / streaks_per_shoe);
+    if (standard_error > 0.0)
+    {
+      double num_of_plain_shoes =
+          streaks_per_shoe / (standard_error * standard_error);
+      printf("Plain Monte Carlo shoes:      %.3e (%.1fx)\n",
+             num_of_plain_shoes, num_of_plain_shoes / num_of_shoes);
+    }
+  }
+
+  // The tilt has weights for hundreds of deal states, so the cards it ends up
+  // dealing are printed instead, relative to a fair shoe.
+  printf("\nTilted %s\n", "     A     2     3     4     5     6     7     8"
+                           "     9    10     J     Q     K");
+  for (std::size_t hand = 0; hand < result.tilted_card_counts.size(); ++hand)
+  {
+    const RareEventResult::CardCounts &card_counts =
+        result.tilted_card_counts[hand];
+    double total_card_count = 0.0;
+    for (double card_count : card_counts)
+    {
+      total_card_count += card_count;
+    }
+    auto num_of_card_types = static_cast<double>(card_counts.size());
+    printf("%-6s ", hand == 0 ? "PLAYER" : "BANKER");
+    for (double card_count : card_counts)
+    {
+      printf("%6.2f", total_card_count > 0.0
+                          ? card_count * num_of_card_types / total_card_count
+                          : 1.0);
+    }
+    printf("\n");
+  }
+  printf("\n");
+}
+
+// PRIVATE METHODS
+
+void RareEventSimulation::run_shoes(std::uint64_t seed,
+                                    std::uint64_t num_of_shoes,
+                                    RareEventResult &result) const
+{
+  std::uint64_t num_of_chunks =
+      (num_of_shoes + SHOES_PER_CHUNK - 1) / SHOES_PER_CHUNK;
+  auto num_of_start_rounds =
+      static_cast<std::uint64_t>(get_num_of_start_rounds());
+
+  // Every chunk deals with the same tilt, which is only read while dealing.
+  auto shared_rank_tilt = std::make_shared<const RankTilt>(rank_tilt);
+
+  run_chunks_in_order<RareEventResult>(
+      0, num_of_chunks, options.num_of_threads,
+      [&](std::uint64_t chunk_index)
+      {
+        // Each chunk has its own dealer and event, so no state but the tilt
+        // is shared while dealing.
+        CardDealer card_dealer(rules, options.shoe_mode);
+        card_dealer.set_continuous_shuffle_delay(
+            options.continuous_shuffle_delay);
+        card_dealer.set_rank_tilt(shared_rank_tilt);
+        RareEvent rare_event = event;
+
+        RareEventResult chunk_result = create_empty_result();
+        std::uint64_t first_shoe_index = chunk_index * SHOES_PER_CHUNK;
+        std::uint64_t last_shoe_index =
+            std::min(first_shoe_index + SHOES_PER_CHUNK, num_of_shoes);
+        for (std::uint64_t shoe_index = first_shoe_index;
+             shoe_index < last_shoe_index; ++shoe_index)
+        {
+          // The start round of the tilted streak is drawn from a hash of the
+          // shoe seed, so it does not change the cards dealt.
+          std::uint64_t shoe_seed = Simulation::get_shoe_seed(seed, shoe_index);
+          auto start_round = static_cast<int>(
+              Simulation::get_shoe_seed(shoe_seed, 0) % num_of_start_rounds);
+
+          card_dealer.reset_deck(shoe_seed);
+          rare_event.reset_state();
+          simulate_shoe(card_dealer, rare_event, start_round, chunk_result);
+        }
+        return chunk_result;
+      },
+      [&](std::uint64_t /*chunk_index*/, const RareEventResult &chunk_result)
+      { result.merge(chunk_result); });
+}
+
+auto RareEventSimulation::get_num_of_start_rounds() const -> int
+{
+  int total_cards_in_deck = CardDealer::CARDS_PER_DECK * rules.num_of_decks;
+  auto cut_card_position =
+      static_cast<int>(options.penetration * total_cards_in_deck);
+  return std::max(1, (cut_card_position + MIN_CARDS_IN_ROUND - 1) /
+                         MIN_CARDS_IN_ROUND);
+}
+
+auto RareEventSimulation::create_empty_result() const -> RareEventResult
+{
+  // Length 0 is reached by every streak, so it is never used.
+  auto num_of_lengths = static_cast<std::size_t>(event.get_target()) + 1;
+
+  RareEventResult result;
+  result.length_counts.resize(num_of_lengths);
+  result.length_card_counts.resize(num_of_lengths *
+                                   RankTilt::NUM_OF_DEAL_STATES);
+  result.length_deal_counts.resize(num_of_lengths *
+                                   RankTilt::NUM_OF_DEAL_STATES);
+  return result;
+}
+
+void RareEventSimulation::simulate_shoe(CardDealer &card_dealer,
+                                        RareEvent &rare_event,
+                                        int start_round,
+                                        RareEventResult &result) const
+{
+  int total_cards_in_deck = CardDealer::CARDS_PER_DECK * rules.num_of_decks;
+  auto cut_card_position =
+      static_cast<int>(options.penetration * total_cards_in_deck);
+  int target = rare_event.get_target();
+
+  // The streak length before and after every round, and the log tilt ratio
+  // of the cards of every round.
+  std::vector<int> lengths_before;
+  std::vector<int> lengths_after;
+  std::vector<double> round_log_tilt_ratios;
+
+  // The index of the length and deal state of every card of the tilted
+  // streak and its card type, see RareEventResult::get_length_index. A card
+  // belongs to the next length the streak reaches, the cards after the last
+  // length reached are pending until the streak breaks.
+  std::vector<std::pair<std::size_t, int>> tilted_cards;
+  std::vector<std::pair<std::size_t, int>> pending_cards;
+  int tilted_length = 0;
+
+  RoundResult round_result;
+  int num_of_cards_dealt = 0;
+  int num_of_streaks = 0;
+  bool tilting = false;
+  card_dealer.set_rank_tilt_enabled(false);
+  while (num_of_cards_dealt < cut_card_position &&
+         num_of_cards_dealt + MAX_CARDS_IN_ROUND <= total_cards_in_deck)
+  {
+    // The tilted streak can only start at the start round if no streak is
+    // already in progress.
+    int round_index = static_cast<int>(lengths_before.size());
+    int length_before = rare_event.get_streak_length();
+    if (round_index == start_round && length_before == 0)
+    {
+      tilting = true;
+      card_dealer.set_rank_tilt_enabled(true);
+    }
+
+    double log_tilt_ratio_before = card_dealer.get_log_tilt_ratio();
+    card_dealer.deal_round(round_result);
+    num_of_cards_dealt +=
+        round_result.num_of_player_cards + round_result.num_of_banker_cards;
+    rare_event.record_round(round_result);
+    int length = rare_event.get_streak_length();
+
+    lengths_before.push_back(length_before);
+    lengths_after.push_back(length);
+    round_log_tilt_ratios.push_back(card_dealer.get_log_tilt_ratio() -
+                                    log_tilt_ratio_before);
+    if (length >= target && length_before < target)
+    {
+      ++num_of_streaks;
+    }
+
+    if (!tilting)
+    {
+      continue;
+    }
+
+    // Replay the deal of the round for the deal state of every card, in the
+    // order CardDealer::deal_round deals them.
+    RoundResult replayed_round;
+    auto replay_card = [&](BetType hand)
+    {
+      bool is_player = hand == BetType::PLAYER;
+      int num_of_cards = is_player ? replayed_round.num_of_player_cards
+                                   : replayed_round.num_of_banker_cards;
+      int card_type = is_player ? round_result.player_cards[num_of_cards]
+                                : round_result.banker_cards[num_of_cards];
+      int deal_state = RankTilt::get_deal_state(
+          hand, num_of_cards, replayed_round.player_hand_value,
+          replayed_round.banker_hand_value);
+      pending_cards.emplace_back(
+          RareEventResult::get_length_index(tilted_length + 1, deal_state),
+          card_type);
+      ++result.tilted_card_counts[is_player ? 0 : 1][card_type];
+      add_card(replayed_round, hand, card_type);
+    };
+    replay_card(BetType::PLAYER);
+    replay_card(BetType::PLAYER);
+    replay_card(BetType::BANKER);
+    replay_card(BetType::BANKER);
+    if (round_result.num_of_player_cards == 3)
+    {
+      replay_card(BetType::PLAYER);
+    }
+    if (round_result.num_of_banker_cards == 3)
+    {
+      replay_card(BetType::BANKER);
+    }
+
+    if (length > tilted_length)
+    {
+      tilted_length = length;
+      tilted_cards.insert(tilted_cards.end(), pending_cards.begin(),
+                          pending_cards.end());
+      pending_cards.clear();
+    }
+
+    // The tilt ends once the streak breaks, or never starts on a tie, or
+    // reaches the target.
+    if (length == 0 || length >= target)
+    {
+      tilting = false;
+      card_dealer.set_rank_tilt_enabled(false);
+    }
+  }
+
+  // The shoe was dealt from a mixture of tilted shoes, one for every start
+  // round. A start round where no streak could start deals the fair shoe,
+  // otherwise the rounds of the streak that starts there are tilted.
+  int num_of_start_rounds = get_num_of_start_rounds();
+  auto num_of_rounds = static_cast<int>(lengths_before.size());
+  double sum_of_tilt_ratios = 0.0;
+  for (int i = 0; i < num_of_start_rounds; ++i)
+  {
+    if (i >= num_of_rounds || lengths_before[i] != 0)
+    {
+      sum_of_tilt_ratios += 1.0;
+      continue;
+    }
+    double log_tilt_ratio = 0.0;
+    for (int j = i; j < num_of_rounds; ++j)
+    {
+      log_tilt_ratio += round_log_tilt_ratios[j];
+      if (lengths_after[j] == 0 || lengths_after[j] >= target)
+      {
+        break;
+      }
+    }
+    sum_of_tilt_ratios += std::exp(log_tilt_ratio);
+  }
+  double likelihood_ratio = num_of_start_rounds / sum_of_tilt_ratios;
+
+  // Record the cards of the tilted streak on the way to every length it
+  // reached, weighted by the likelihood ratio of the shoe.
+  for (int length = 1; length <= tilted_length; ++length)
+  {
+    ++result.length_counts[length];
+  }
+  for (const auto &[length_index, card_type] : tilted_cards)
+  {
+    result.length_card_counts[length_index][card_type] += likelihood_ratio;
+    ++result.length_deal_counts[length_index];
+  }
+
+  // Every streak that reached the target is weighted by the likelihood ratio.
+  double weight = num_of_streaks * likelihood_ratio;
+  ++result.num_of_shoes;
+  result.num_of_hits += num_of_streaks;
+  result.streaks_per_shoe.add(weight, 1.0);
+  result.sum_hit_weights += weight;
+  result.sum_squared_hit_weights += weight * weight;
+}
+
+void RareEventSimulation::set_exact_tilt()
+{
+  // A round that keeps the streak is worth the chance of extending the
+  // streak from there, the chance a round extends it given that it does not
+  // keep it.
+  RoundResult empty_round;
+  double extend_chance = get_round_value(empty_round, 0.0);
+  double keep_chance = get_round_value(empty_round, 1.0) - extend_chance;
+  double keep_value =
+      keep_chance < 1.0 ? extend_chance / (1.0 - keep_chance) : 0.0;
+
+  // A representative card of each hand value, the value itself or a 10.
+  auto get_card_type = [](int hand_value)
+  { return hand_value == 0 ? 9 : hand_value - 1; };
+  constexpr int TEN = 9;
+
+  for (BetType hand : {BetType::PLAYER, BetType::BANKER})
+  {
+    for (int num_of_cards = 0; num_of_cards < RankTilt::NUM_OF_CARDS_HELD;
+         ++num_of_cards)
+    {
+      for (int player_hand_value = 0;
+           player_hand_value < RankTilt::NUM_OF_HAND_VALUES;
+           ++player_hand_value)
+      {
+        for (int banker_hand_value = 0;
+             banker_hand_value < RankTilt::NUM_OF_HAND_VALUES;
+             ++banker_hand_value)
+        {
+          // The cards each hand holds when the next card goes to this hand,
+          // see CardDealer::deal_round. The banker draws its third card after
+          // the player has drawn one, unless the player stood on a 6 or 7.
+          bool is_player = hand == BetType::PLAYER;
+          int num_of_player_cards = num_of_cards;
+          int num_of_banker_cards = 0;
+          if (is_player)
+          {
+            num_of_banker_cards = num_of_cards == 2 ? 2 : 0;
+          }
+          else
+          {
+            num_of_banker_cards = num_of_cards;
+            num_of_player_cards =
+                num_of_cards == 2 && player_hand_value != 6 &&
+                        player_hand_value != 7
+                    ? 3
+                    : 2;
+          }
+          if ((num_of_player_cards == 0 && player_hand_value != 0) ||
+              (num_of_banker_cards == 0 && banker_hand_value != 0))
+          {
+            continue;
+          }
+
+          RoundResult round_result;
+          for (int i = 0; i < num_of_player_cards; ++i)
+          {
+            add_card(round_result, BetType::PLAYER,
+                     i == 0 ? get_card_type(player_hand_value) : TEN);
+          }
+          for (int i = 0; i < num_of_banker_cards; ++i)
+          {
+            add_card(round_result, BetType::BANKER,
+                     i == 0 ? get_card_type(banker_hand_value) : TEN);
+          }
+
+          // Weight each card type by the value of the round once it is dealt,
+          // against the value of the round before it.
+          std::array<double, 13> card_values = {};
+          double round_value = 0.0;
+          for (std::size_t i = 0; i < card_values.size(); ++i)
+          {
+            RoundResult next_round = round_result;
+            add_card(next_round, hand, static_cast<int>(i));
+            card_values[i] = get_round_value(next_round, keep_value);
+            round_value +=
+                card_values[i] / static_cast<double>(card_values.size());
+          }
+          if (round_value <= 0.0)
+          {
+            continue;
+          }
+          std::array<double, 13> &weights =
+              rank_tilt.weights[RankTilt::get_deal_state(
+                  hand, num_of_cards, player_hand_value, banker_hand_value)];
+          for (std::size_t i = 0; i < weights.size(); ++i)
+          {
+            weights[i] = std::clamp(card_values[i] / round_value,
+                                    MIN_TILT_WEIGHT, MAX_TILT_WEIGHT);
+          }
+        }
+      }
+    }
+  }
+}
+
+auto RareEventSimulation::get_round_value(const RoundResult &round_result,
+                                          double keep_value) const -> double
+{
+  // Find the hand the next card goes to, as CardDealer::deal_round deals it.
+  BetType hand = BetType::NONE;
+  if (round_result.num_of_player_cards < 2)
+  {
+    hand = BetType::PLAYER;
+  }
+  else if (round_result.num_of_banker_cards < 2)
+  {
+    hand = BetType::BANKER;
+  }
+  else if (!CardDealer::player_or_banker_has_natural_hand(
+               round_result.player_hand_value, round_result.banker_hand_value))
+  {
+    if (round_result.num_of_player_cards == 2 &&
+        CardDealer::player_can_draw_third_card(round_result.player_hand_value))
+    {
+      hand = BetType::PLAYER;
+    }
+    else if (round_result.num_of_banker_cards == 2 &&
+             CardDealer::banker_can_draw_third_card(
+                 round_result.banker_hand_value,
+                 round_result.num_of_player_cards == 3
+                     ? round_result.player_cards[2]
+                     : -1))
+    {
+      hand = BetType::BANKER;
+    }
+  }
+
+  if (hand == BetType::NONE)
+  {
+    RoundResult finished_round = round_result;
+    if (finished_round.player_hand_value > finished_round.banker_hand_value)
+    {
+      finished_round.outcome = BetType::PLAYER;
+    }
+    else if (finished_round.banker_hand_value >
+             finished_round.player_hand_value)
+    {
+      finished_round.outcome = BetType::BANKER;
+    }
+    else
+    {
+      finished_round.outcome = BetType::TIE;
+    }
+    if (event.extends_streak(finished_round))
+    {
+      return 1.0;
+    }
+    return event.keeps_streak(finished_round) ? keep_value : 0.0;
+  }
+
+  // Every card type is equally likely in an infinite deck.
+  double round_value = 0.0;
+  for (int i = 0; i < CardDealer::NUM_OF_UNIQUE_CARDS; ++i)
+  {
+    RoundResult next_round = round_result;
+    add_card(next_round, hand, i);
+    round_value += get_round_value(next_round, keep_value);
+  }
+  return round_value / CardDealer::NUM_OF_UNIQUE_CARDS;
+}
+
+void RareEventSimulation::add_card(RoundResult &round_result,
+                                   BetType hand,
+                                   int card_type)
+{
+  bool is_player = hand == BetType::PLAYER;
+  int &num_of_cards = is_player ? round_result.num_of_player_cards
+                                : round_result.num_of_banker_cards;
+  int &hand_value = is_player ? round_result.player_hand_value
+                              : round_result.banker_hand_value;
+  (is_player ? round_result.player_cards
+             : round_result.banker_cards)[num_of_cards] = card_type;
+  ++num_of_cards;
+  hand_value = (hand_value + CardDealer::get_card_value(card_type)) %
+               RankTilt::NUM_OF_HAND_VALUES;
+}
+
+auto RareEventSimulation::update_rank_tilt(
+    const RareEventResult &pilot_result) -> int
+{
+  // Tune for the longest length reached by the elite fraction of the tilted
+  // streaks, or the longest length reached at all if no length is reached
+  // that often.
+  double num_of_elite_streaks =
+      options.elite_fraction *
+      static_cast<double>(pilot_result.length_counts[1]);
+  int length = event.get_target();
+  while (length > 0 &&
+         static_cast<double>(pilot_result.length_counts[length]) <
+             num_of_elite_streaks)
+  {
+    --length;
+  }
+  while (length > 0 && pilot_result.length_counts[length] == 0)
+  {
+    --length;
+  }
+
+  // The elite length alone can stall well short of the target, so the length
+  // never falls and rises by one whenever enough streaks reach the next one.
+  int next_length = std::min(tuned_length + 1, event.get_target());
+  while (next_length > length &&
+         pilot_result.length_counts[next_length] < MIN_ELITE_STREAKS)
+  {
+    --next_length;
+  }
+  length = std::max(length, next_length);
+  if (length == 0)
+  {
+    return 0;
+  }
+
+  for (int deal_state = 0; deal_state < RankTilt::NUM_OF_DEAL_STATES;
+       ++deal_state)
+  {
+    // The cards on the way to the length are the cards of every length up to
+    // it.
+    RareEventResult::CardCounts card_counts = {};
+    std::uint64_t num_of_cards = 0;
+    for (int i = 1; i <= length; ++i)
+    {
+      std::size_t length_index =
+          RareEventResult::get_length_index(i, deal_state);
+      num_of_cards += pilot_result.length_deal_counts[length_index];
+      for (std::size_t j = 0; j < card_counts.size(); ++j)
+      {
+        card_counts[j] += pilot_result.length_card_counts[length_index][j];
+      }
+    }
+    double total_card_count = 0.0;
+    for (double card_count : card_counts)
+    {
+      total_card_count += card_count;
+    }
+    if (num_of_cards < MIN_DEAL_STATE_CARDS || total_card_count <= 0.0)
+    {
+      continue;
+    }
+
+    // A full shoe has the same number of cards of each type, so weights in
+    // proportion to the frequency of each card type in the streaks make the
+    // tilted shoe deal them with that frequency. The frequencies are shrunk
+    // towards the current weights as if PRIOR_DEAL_STATE_CARDS more cards
+    // had been dealt with them, so a deal state seen a few hundred times
+    // does not trade good weights for noise.
+    std::array<double, 13> &weights = rank_tilt.weights[deal_state];
+    double total_weight = 0.0;
+    for (double weight : weights)
+    {
+      total_weight += weight;
+    }
+    auto sample_size = static_cast<double>(num_of_cards);
+    for (std::size_t i = 0; i < weights.size(); ++i)
+    {
+      double frequency =
+          ((sample_size * card_counts[i] / total_card_count) +
+           (PRIOR_DEAL_STATE_CARDS * weights[i] / total_weight)) /
+          (sample_size + PRIOR_DEAL_STATE_CARDS);
+      double tuned_weight =
+          std::clamp(frequency * static_cast<double>(weights.size()),
+                     MIN_TILT_WEIGHT, MAX_TILT_WEIGHT);
+      weights[i] = (TILT_SMOOTHING * tuned_weight) +
+                   ((1.0 - TILT_SMOOTHING) * weights[i]);
+    }
+  }
+  tuned_length = length;
+  return length;
+}
+
+} // namespace BACCARAT
\ No newline at end of file
@@ -0,0 +1,326 @@
+#ifndef RARE_EVENT_SIMULATION_H
+#define RARE_EVENT_SIMULATION_H
+
+#include "card_dealer.h"
+#include "rank_tilt.h"
+#include "rare_event.h"
+#include "rule_set.h"
+#include "shoe_mode.h"
+#include "statistics.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief The options of a rare event simulation.
+ */
+struct RareEventOptions
+{
+  /// @brief The number of shoes dealt to estimate the probability.
+  std::uint64_t num_of_shoes = 100000;
+
+  /// @brief The master seed, every shoe is seeded from it and its index.
+  std::uint64_t seed = 1;
+
+  /// @brief The fraction of the shoe dealt before the cut card is reached.
+  double penetration = 0.9;
+
+  /// @brief How cards are drawn from the shoe.
+  ShoeMode shoe_mode = ShoeMode::FINITE_SHOE;
+
+  /// @brief The number of rounds before the cards of a round are returned to
+  /// a CONTINUOUS_SHUFFLE shoe.
+  int continuous_shuffle_delay = 0;
+
+  /// @brief The number of worker threads, 0 to use every core.
+  int num_of_threads = 0;
+
+  /// @brief The number of pilot runs that tune the tilt before the
+  /// probability is estimated, 0 to keep the initial tilt.
+  int num_of_pilot_runs = 5;
+
+  /// @brief The number of shoes dealt in every pilot run.
+  std::uint64_t num_of_pilot_shoes = 10000;
+
+  /// @brief The fraction of the tilted streaks that reach the longest lengths
+  /// and are used to tune the tilt.
+  double elite_fraction = 0.1;
+
+  /// @brief If true, the first pilot run starts from the exact tilt of an
+  /// infinite deck, see RareEventSimulation, otherwise from rank_tilt.
+  bool exact_tilt = true;
+
+  /// @brief The tilt of the first pilot run, or of the estimate if there are
+  /// no pilot runs, unless exact_tilt is set.
+  RankTilt rank_tilt;
+};
+
+/**
+ * @brief The results of a rare event simulation.
+ */
+struct RareEventResult
+{
+  /// @brief The number of cards of each type.
+  using CardCounts = std::array<double, 13>;
+
+  /// @brief The number of shoes dealt.
+  std::uint64_t num_of_shoes = 0;
+
+  /// @brief The number of streaks in the tilted shoes that reached the target
+  /// length.
+  std::uint64_t num_of_hits = 0;
+
+  /// @brief The expected number of streaks in a fair shoe that reach the
+  /// target length, estimated from the number of streaks in every tilted shoe
+  /// weighted by its likelihood ratio.
+  RatioEstimator streaks_per_shoe;
+
+  /// @brief The sum of the weighted number of streaks of every shoe.
+  double sum_hit_weights = 0.0;
+
+  /// @brief The sum of the squared weighted number of streaks of every shoe.
+  double sum_squared_hit_weights = 0.0;
+
+  /// @brief The number of tilted streaks that reached each length.
+  std::vector<std::uint64_t> length_counts;
+
+  /// @brief The card types dealt in each deal state of the tilted streaks on
+  /// the way from the length before to each length, weighted by the
+  /// likelihood ratio of the shoe, see get_length_index.
+  std::vector<CardCounts> length_card_counts;
+
+  /// @brief The number of cards dealt in each deal state of the tilted
+  /// streaks on the way from the length before to each length, see
+  /// get_length_index.
+  std::vector<std::uint64_t> length_deal_counts;
+
+  /// @brief The card types dealt to the player and banker in the tilted
+  /// rounds.
+  std::array<CardCounts, 2> tilted_card_counts = {};
+
+  /**
+   * @brief Gets the index of a length and deal state in length_card_counts
+   * and length_deal_counts.
+   *
+   * @param length The streak length.
+   * @param deal_state The deal state, see RankTilt::get_deal_state.
+   *
+   * @return The index.
+   */
+  [[nodiscard]] static auto get_length_index(int length,
+                                             int deal_state) -> std::size_t;
+
+  /**
+   * @brief Adds the results of another simulation to this result.
+   *
+   * @param other The result to merge.
+   */
+  void merge(const RareEventResult &other);
+};
+
+/**
+ * @brief A class to estimate the probability of rare events with importance
+ * sampling.
+ *
+ * @details The estimate is the expected number of streaks per shoe that reach
+ * the target length, which is close to the probability that a shoe has such
+ * a streak when the event is rare. Every shoe picks a start round at random
+ * and only the streak that starts at that round is dealt from a tilted shoe
+ * where it is far more likely to grow, see RankTilt. The rest of the shoe is
+ * dealt fairly. The shoe is then weighted by its likelihood ratio against the
+ * mixture over every start round, so a streak is weighted by how likely it is
+ * to be tilted from any of its rounds and not just the one picked. The
+ * estimate is unbiased for a fair shoe, and tilting a single streak keeps the
+ * weights from growing with the length of the shoe.
+ *
+ * The tilt starts out as the fair deal of an infinite deck given that the
+ * round extends the streak, worked out exactly for every deal state: each card
+ * type is weighted by the chance that the round extends the streak once it is
+ * dealt, so e.g. the banker of a TIE streak is dealt the cards that match the
+ * player hand. A tie in a BANKER or PLAYER streak is weighted by the chance of
+ * extending the streak from there, so ties are dealt as often as in the
+ * streaks that reach the target.
+ *
+ * The tilt is then tuned to the finite shoe with the cross entropy method:
+ * each pilot run deals shoes with the current tilt, picks the longest streak
+ * length reached by the elite fraction of the tilted streaks, and moves the
+ * weights of every deal state towards the weighted frequency of each card
+ * type dealt in that state in the streaks that reached that length, as far as
+ * the number of those cards allows. The length rises by at least one with
+ * every pilot run that has enough streaks at the next length, so the tilt is
+ * tuned for the target itself within a few runs.
+ *
+ * @note The shoes are dealt in chunks by a pool of worker threads and merged
+ * in order, so the result only depends on the seed and not on the number of
+ * threads.
+ */
+class RareEventSimulation
+{
+public:
+  /**
+   * @brief Constructor for the RareEventSimulation class.
+   *
+   * @param event The event to estimate the probability of.
+   * @param rules The table rules, used for the number of decks in the shoe.
+   * @param options The options of the simulation.
+   */
+  RareEventSimulation(const RareEvent &event,
+                      const RuleSet &rules,
+                      const RareEventOptions &options);
+
+  /**
+   * @brief Tunes the tilt with the pilot runs and estimates the probability.
+   *
+   * @param result The results of the estimate.
+   */
+  void run(RareEventResult &result);
+
+  /**
+   * @brief Prints the results of the simulation.
+   *
+   * @param result The results of the estimate.
+   */
+  void print_result(const RareEventResult &result) const;
+
+private:
+  /// @brief The number of shoes in a chunk of work given to a worker thread.
+  static constexpr std::uint64_t SHOES_PER_CHUNK = 256;
+
+  /// @brief The most cards that can be dealt in a single round.
+  static constexpr int MAX_CARDS_IN_ROUND = 6;
+
+  /// @brief The fewest cards that can be dealt in a single round.
+  static constexpr int MIN_CARDS_IN_ROUND = 4;
+
+  /// @brief The smallest weight of a tuned tilt, so every card type can still
+  /// be dealt.
+  static constexpr double MIN_TILT_WEIGHT = 0.05;
+
+  /// @brief The largest weight of a tuned tilt.
+  static constexpr double MAX_TILT_WEIGHT = 20.0;
+
+  /// @brief The fraction of a tuned tilt taken from the pilot run, the rest
+  /// is kept from the previous tilt so the tilt does not jump around.
+  static constexpr double TILT_SMOOTHING = 0.7;
+
+  /// @brief The fewest cards dealt in a deal state of the elite streaks for
+  /// its weights to be tuned, fewer would tune them to noise.
+  static constexpr std::uint64_t MIN_DEAL_STATE_CARDS = 20;
+
+  /// @brief The number of cards the current weights of a deal state count as
+  /// when its weights are tuned.
+  static constexpr double PRIOR_DEAL_STATE_CARDS = 10000.0;
+
+  /// @brief The fewest tilted streaks at the next length for the tuned
+  /// length to rise to it.
+  static constexpr std::uint64_t MIN_ELITE_STREAKS = 10;
+
+  /// @brief The fewest streaks at the target, and the smallest effective
+  /// sample size, for a confidence interval and speed-up to be printed.
+  static constexpr double MIN_SAMPLE_SIZE = 30.0;
+
+  /// @brief The event to estimate the probability of.
+  RareEvent event;
+
+  /// @brief The table rules, used for the number of decks in the shoe.
+  RuleSet rules;
+
+  /// @brief The options of the simulation.
+  RareEventOptions options;
+
+  /// @brief The current tilt.
+  RankTilt rank_tilt;
+
+  /// @brief The streak length the current tilt was tuned for, 0 if it was
+  /// not tuned.
+  int tuned_length = 0;
+
+  /**
+   * @brief Deals shoes with the current tilt.
+   *
+   * @param seed The seed the shoes are seeded from.
+   * @param num_of_shoes The number of shoes to deal.
+   * @param result The results of the shoes.
+   */
+  void run_shoes(std::uint64_t seed,
+                 std::uint64_t num_of_shoes,
+                 RareEventResult &result) const;
+
+  /**
+   * @brief Gets the number of rounds a tilted streak can start at, every
+   * round that can be dealt before the cut card.
+   *
+   * @return The number of start rounds.
+   */
+  [[nodiscard]] auto get_num_of_start_rounds() const -> int;
+
+  /**
+   * @brief Creates an empty result with an entry for every length.
+   *
+   * @return The empty result.
+   */
+  [[nodiscard]] auto create_empty_result() const -> RareEventResult;
+
+  /**
+   * @brief Deals a single shoe, tilting the streak that starts at the start
+   * round until it breaks or reaches the target length.
+   *
+   * @param card_dealer The dealer used to deal the shoe, already reset.
+   * @param rare_event The event, updated with the rounds dealt.
+   * @param start_round The round the tilted streak starts at.
+   * @param result The result to update.
+   */
+  void simulate_shoe(CardDealer &card_dealer,
+                     RareEvent &rare_event,
+                     int start_round,
+                     RareEventResult &result) const;
+
+  /**
+   * @brief Sets the tilt of every deal state to the fair deal of an infinite
+   * deck given that the round extends the streak.
+   */
+  void set_exact_tilt();
+
+  /**
+   * @brief Works out the chance that a round dealt from an infinite deck goes
+   * the way of the streak.
+   *
+   * @param round_result The cards dealt so far, in the order
+   * CardDealer::deal_round deals them.
+   * @param keep_value The value of a round that keeps the streak, against 1
+   * for a round that extends it.
+   *
+   * @return The expected value of the round once every card is dealt.
+   */
+  [[nodiscard]] auto get_round_value(const RoundResult &round_result,
+                                     double keep_value) const -> double;
+
+  /**
+   * @brief Adds a card to a hand of a round being dealt.
+   *
+   * @param round_result The round, the cards and hand value of the hand are
+   * updated.
+   * @param hand The hand, either PLAYER or BANKER.
+   * @param card_type The card type.
+   */
+  static void
+  add_card(RoundResult &round_result, BetType hand, int card_type);
+
+  /**
+   * @brief Tunes the tilt with the results of a pilot run.
+   *
+   * @param pilot_result The results of the pilot run.
+   *
+   * @return The streak length the tilt was tuned for, 0 if no tilted streak
+   * started.
+   */
+  auto update_rank_tilt(const RareEventResult &pilot_result) -> int;
+};
+
+} // namespace BACCARAT
+
+#endif // RARE_EVENT_SIMULATION_H
\ No newline at end of file
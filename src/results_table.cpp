@@ -0,0 +1,115 @@
+#include "results_table.h"
+#include "binary_io.h"
+
+#include <fstream>
+#include <iomanip>
+
+namespace BACCARAT
+{
+
+// PUBLIC METHODS
+
+void ResultsTable::add_number_column(const std::string &name)
+{
+  Column column;
+  column.name = name;
+  columns.push_back(column);
+}
+
+void ResultsTable::add_string_column(const std::string &name)
+{
+  Column column;
+  column.name = name;
+  column.is_string = true;
+  columns.push_back(column);
+}
+
+void ResultsTable::add_row(const std::vector<double> &numbers,
+                           const std::vector<std::string> &strings)
+{
+  std::size_t number_index = 0;
+  std::size_t string_index = 0;
+  for (Column &column : columns)
+  {
+    if (column.is_string)
+    {
+      column.strings.push_back(strings.at(string_index++));
+    }
+    else
+    {
+      column.numbers.push_back(numbers.at(number_index++));
+    }
+  }
+  ++num_of_rows;
+}
+
+auto ResultsTable::write_csv(const std::string &path) const -> bool
+{
+  std::ofstream file(path, std::ios::trunc);
+  file << std::setprecision(CSV_PRECISION);
+
+  for (std::size_t i = 0; i < columns.size(); ++i)
+  {
+    file << (i > 0 ? "," : "") << columns[i].name;
+  }
+  file << "\n";
+
+  for (std::uint64_t row = 0; row < num_of_rows; ++row)
+  {
+    for (std::size_t i = 0; i < columns.size(); ++i)
+    {
+      file << (i > 0 ? "," : "");
+      if (columns[i].is_string)
+      {
+        // Strings are quoted, as strategies and rules may contain commas,
+        // and a quote within a string is doubled.
+        file << '"';
+        for (char character : columns[i].strings[row])
+        {
+          if (character == '"')
+          {
+            file << '"';
+          }
+          file << character;
+        }
+        file << '"';
+      }
+      else
+      {
+        file << columns[i].numbers[row];
+      }
+    }
+    file << "\n";
+  }
+  return static_cast<bool>(file);
+}
+
+auto ResultsTable::write_columnar(const std::string &path) const -> bool
+{
+  BinaryWriter writer;
+  writer.write_u64(COLUMNAR_MAGIC);
+  writer.write_u64(num_of_rows);
+  writer.write_u64(columns.size());
+  for (const Column &column : columns)
+  {
+    writer.write_string(column.name);
+    writer.write_u64(column.is_string ? 1 : 0);
+    if (column.is_string)
+    {
+      for (const std::string &value : column.strings)
+      {
+        writer.write_string(value);
+      }
+    }
+    else
+    {
+      for (double value : column.numbers)
+      {
+        writer.write_double(value);
+      }
+    }
+  }
+  return write_file_atomically(path, writer.get_buffer());
+}
+
+} // namespace BACCARAT
@@ -0,0 +1,97 @@
+#ifndef RESULTS_TABLE_H
+#define RESULTS_TABLE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief A class to collect a table of results and write it to a file.
+ *
+ * @details The table can be written as CSV, or as a columnar binary file where
+ * the values of each column are stored together, so a reader can load a single
+ * column without parsing the whole table.
+ *
+ * @note The columnar file is little endian, and laid out as:
+ * magic "BACCOL01", number of rows, number of columns, then for each column
+ * its name, its type (0 for double, 1 for string) and its values. Strings are
+ * prefixed by their length.
+ */
+class ResultsTable
+{
+public:
+  /**
+   * @brief Adds a column of numbers.
+   *
+   * @param name The name of the column.
+   */
+  void add_number_column(const std::string &name);
+
+  /**
+   * @brief Adds a column of strings.
+   *
+   * @param name The name of the column.
+   */
+  void add_string_column(const std::string &name);
+
+  /**
+   * @brief Adds a row to the table.
+   *
+   * @param numbers The values of the number columns, in the order the columns
+   * were added.
+   * @param strings The values of the string columns, in the order the columns
+   * were added.
+   */
+  void add_row(const std::vector<double> &numbers,
+               const std::vector<std::string> &strings);
+
+  /**
+   * @brief Writes the table as CSV.
+   *
+   * @param path The path of the file.
+   *
+   * @return true if the file was written, false otherwise.
+   */
+  [[nodiscard]] auto write_csv(const std::string &path) const -> bool;
+
+  /**
+   * @brief Writes the table as a columnar binary file.
+   *
+   * @param path The path of the file.
+   *
+   * @return true if the file was written, false otherwise.
+   */
+  [[nodiscard]] auto write_columnar(const std::string &path) const -> bool;
+
+private:
+  /// @brief Identifies a columnar results file, the ASCII string "BACCOL01".
+  static constexpr std::uint64_t COLUMNAR_MAGIC = 0x31304C4F43434142ULL;
+
+  /// @brief The number of significant digits of numbers written to CSV.
+  /// @note The columnar file stores every number exactly.
+  static constexpr int CSV_PRECISION = 15;
+
+  /**
+   * @brief A single column of the table.
+   */
+  struct Column
+  {
+    std::string name;
+    bool is_string = false;
+    std::vector<double> numbers;
+    std::vector<std::string> strings;
+  };
+
+  /// @brief The columns of the table.
+  std::vector<Column> columns;
+
+  /// @brief The number of rows in the table.
+  std::uint64_t num_of_rows = 0;
+};
+
+} // namespace BACCARAT
+
+#endif // RESULTS_TABLE_H
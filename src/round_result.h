@@ -0,0 +1,43 @@
+#ifndef ROUND_RESULT_H
+#define ROUND_RESULT_H
+
+#include "bet_type.h"
+
+#include <array>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief The cards and outcome of a single round of Baccarat.
+ *
+ * @note Cards are stored as card types, see CardDealer::get_string_card_type
+ * for more information.
+ */
+struct RoundResult
+{
+  /// @brief The cards dealt to the player, in the order they were dealt.
+  std::array<int, 3> player_cards = {};
+
+  /// @brief The cards dealt to the banker, in the order they were dealt.
+  std::array<int, 3> banker_cards = {};
+
+  /// @brief The number of cards dealt to the player, either 2 or 3.
+  int num_of_player_cards = 0;
+
+  /// @brief The number of cards dealt to the banker, either 2 or 3.
+  int num_of_banker_cards = 0;
+
+  /// @brief The final value of the player's hand.
+  int player_hand_value = 0;
+
+  /// @brief The final value of the banker's hand.
+  int banker_hand_value = 0;
+
+  /// @brief The winner of the round.
+  BetType outcome = BetType::NONE;
+};
+
+} // namespace BACCARAT
+
+#endif // ROUND_RESULT_H
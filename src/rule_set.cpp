@@ -0,0 +1,36 @@
+#include "rule_set.h"
+
+#include <cstdint>
+
+namespace BACCARAT
+{
+
+// PUBLIC METHODS
+
+void RuleSet::serialize(BinaryWriter &writer) const
+{
+  writer.write_i64(num_of_decks);
+  writer.write_double(payout_player);
+  writer.write_double(payout_banker);
+  writer.write_double(banker_commission);
+  writer.write_double(payout_tie);
+  writer.write_u64(push_on_tie ? 1 : 0);
+}
+
+auto RuleSet::deserialize(BinaryReader &reader) -> bool
+{
+  std::int64_t decks = 0;
+  std::uint64_t push = 0;
+  if (!reader.read_i64(decks) || !reader.read_double(payout_player) ||
+      !reader.read_double(payout_banker) ||
+      !reader.read_double(banker_commission) ||
+      !reader.read_double(payout_tie) || !reader.read_u64(push))
+  {
+    return false;
+  }
+  num_of_decks = static_cast<int>(decks);
+  push_on_tie = push != 0;
+  return true;
+}
+
+} // namespace BACCARAT
@@ -0,0 +1,55 @@
+#ifndef RULE_SET_H
+#define RULE_SET_H
+
+#include "binary_io.h"
+
+namespace BACCARAT
+{
+
+/**
+ * @brief The table rules used to deal and settle a game of Baccarat.
+ *
+ * @details The defaults match a standard 8 deck table where the Banker bet
+ * pays 1:1 less a 5% commission and the Tie bet pays 8:1.
+ */
+struct RuleSet
+{
+  /// @brief The number of decks in the shoe.
+  int num_of_decks = 8;
+
+  /// @brief The payout for a player bet.
+  double payout_player = 1.0;
+
+  /// @brief The payout for a banker bet.
+  double payout_banker = 1.0;
+
+  /// @brief The commission taken from a winning banker bet.
+  double banker_commission = 0.05;
+
+  /// @brief The payout for a tie bet.
+  double payout_tie = 8.0;
+
+  /// @brief If true, PLAYER and BANKER bets are returned when the round is a
+  /// tie. Otherwise they lose.
+  bool push_on_tie = false;
+
+  /**
+   * @brief Writes the rules to a binary buffer.
+   *
+   * @param writer The writer to write to.
+   */
+  void serialize(BinaryWriter &writer) const;
+
+  /**
+   * @brief Reads rules written by serialize.
+   *
+   * @param reader The reader to read from.
+   *
+   * @return true if the rules were read, false otherwise.
+   */
+  auto deserialize(BinaryReader &reader) -> bool;
+};
+
+} // namespace BACCARAT
+
+#endif // RULE_SET_H
@@ -0,0 +1,193 @@
+#include "shoe_analysis.h"
+#include "card_dealer.h"
+
+#include <cstdio>
+
+namespace BACCARAT
+{
+
+// PUBLIC METHODS
+
+auto ShoeAnalysis::compute_outcome_probabilities(const RuleSet &rules,
+                                                 ShoeMode shoe_mode)
+    -> OutcomeProbabilities
+{
+  EnumerationShoe shoe;
+  shoe.remaining_cards.fill(CardDealer::CARDS_OF_EACH_TYPE_PER_DECK *
+                            rules.num_of_decks);
+  shoe.total_remaining_cards = CardDealer::CARDS_PER_DECK * rules.num_of_decks;
+  shoe.deplete = shoe_mode == ShoeMode::FINITE_SHOE;
+
+  OutcomeProbabilities probabilities;
+  enumerate_round(shoe, EnumerationRound(), 1.0, probabilities);
+  return probabilities;
+}
+
+auto ShoeAnalysis::compute_house_edges(
+    const OutcomeProbabilities &probabilities,
+    const RuleSet &rules) -> HouseEdges
+{
+  // The expected return of a bet is the sum of the amount returned for each
+  // outcome, weighted by the probability of the outcome.
+  auto expected_return = [&](BetType bet_type)
+  {
+    return (probabilities.player * CardDealer::get_payout_multiplier(
+                                       BetType::PLAYER, bet_type, rules)) +
+           (probabilities.banker * CardDealer::get_payout_multiplier(
+                                       BetType::BANKER, bet_type, rules)) +
+           (probabilities.tie * CardDealer::get_payout_multiplier(
+                                    BetType::TIE, bet_type, rules));
+  };
+
+  HouseEdges house_edges;
+  house_edges.player = 1.0 - expected_return(BetType::PLAYER);
+  house_edges.banker = 1.0 - expected_return(BetType::BANKER);
+  house_edges.tie = 1.0 - expected_return(BetType::TIE);
+  return house_edges;
+}
+
+void ShoeAnalysis::print_comparison_report(const RuleSet &rules)
+{
+  OutcomeProbabilities finite_shoe =
+      compute_outcome_probabilities(rules, ShoeMode::FINITE_SHOE);
+  OutcomeProbabilities infinite_deck =
+      compute_outcome_probabilities(rules, ShoeMode::INFINITE_DECK);
+
+  HouseEdges finite_shoe_edges = compute_house_edges(finite_shoe, rules);
+  HouseEdges infinite_deck_edges = compute_house_edges(infinite_deck, rules);
+
+  auto print_row = [](const char *name, double finite, double infinite)
+  {
+    printf("%-14s %14.10f %14.10f %+14.10f\n", name, finite, infinite,
+           infinite - finite);
+  };
+
+  printf("\n--- Finite Shoe vs Infinite Deck (%d decks) ---\n\n",
+         rules.num_of_decks);
+  printf("%-14s %14s %14s %14s\n", "", "FINITE_SHOE", "INFINITE_DECK",
+         "DIFFERENCE");
+  print_row("P(PLAYER)", finite_shoe.player, infinite_deck.player);
+  print_row("P(BANKER)", finite_shoe.banker, infinite_deck.banker);
+  print_row("P(TIE)", finite_shoe.tie, infinite_deck.tie);
+  print_row("EDGE PLAYER", finite_shoe_edges.player,
+            infinite_deck_edges.player);
+  print_row("EDGE BANKER", finite_shoe_edges.banker,
+            infinite_deck_edges.banker);
+  print_row("EDGE TIE", finite_shoe_edges.tie, infinite_deck_edges.tie);
+  printf("\nFinite shoe probabilities are for a round dealt off the top of a "
+         "full shoe.\n\n");
+}
+
+// PRIVATE METHODS
+
+void ShoeAnalysis::enumerate_round(EnumerationShoe &shoe,
+                                   const EnumerationRound &round,
+                                   double probability,
+                                   OutcomeProbabilities &probabilities)
+{
+  NextCard next_card = get_next_card(round);
+
+  if (next_card == NextCard::ROUND_OVER)
+  {
+    if (round.player_hand_value > round.banker_hand_value)
+    {
+      probabilities.player += probability;
+    }
+    else if (round.banker_hand_value > round.player_hand_value)
+    {
+      probabilities.banker += probability;
+    }
+    else
+    {
+      probabilities.tie += probability;
+    }
+    return;
+  }
+
+  for (int card_type = 0; card_type < CardDealer::NUM_OF_UNIQUE_CARDS;
+       ++card_type)
+  {
+    if (shoe.remaining_cards[card_type] == 0)
+    {
+      continue;
+    }
+
+    double card_probability =
+        static_cast<double>(shoe.remaining_cards[card_type]) /
+        shoe.total_remaining_cards;
+
+    EnumerationRound next_round = round;
+    ++next_round.num_of_cards_dealt;
+    if (next_card == NextCard::PLAYER)
+    {
+      next_round.player_hand_value =
+          (round.player_hand_value + CardDealer::get_card_value(card_type)) %
+          HAND_VALUE_MODULO;
+      if (round.num_of_cards_dealt == NUM_OF_INITIAL_CARDS)
+      {
+        next_round.player_third_card = card_type;
+      }
+    }
+    else
+    {
+      next_round.banker_hand_value =
+          (round.banker_hand_value + CardDealer::get_card_value(card_type)) %
+          HAND_VALUE_MODULO;
+    }
+
+    if (shoe.deplete)
+    {
+      --shoe.remaining_cards[card_type];
+      --shoe.total_remaining_cards;
+    }
+
+    enumerate_round(shoe, next_round, probability * card_probability,
+                    probabilities);
+
+    if (shoe.deplete)
+    {
+      ++shoe.remaining_cards[card_type];
+      ++shoe.total_remaining_cards;
+    }
+  }
+}
+
+auto ShoeAnalysis::get_next_card(const EnumerationRound &round) -> NextCard
+{
+  // Two cards are dealt to the player, then two to the banker.
+  if (round.num_of_cards_dealt < NUM_OF_INITIAL_CARDS)
+  {
+    return round.num_of_cards_dealt < NUM_OF_INITIAL_CARDS / 2
+               ? NextCard::PLAYER
+               : NextCard::BANKER;
+  }
+
+  if (round.num_of_cards_dealt == NUM_OF_INITIAL_CARDS)
+  {
+    if (CardDealer::player_or_banker_has_natural_hand(round.player_hand_value,
+                                                      round.banker_hand_value))
+    {
+      return NextCard::ROUND_OVER;
+    }
+    if (CardDealer::player_can_draw_third_card(round.player_hand_value))
+    {
+      return NextCard::PLAYER;
+    }
+    return CardDealer::banker_can_draw_third_card(round.banker_hand_value, -1)
+               ? NextCard::BANKER
+               : NextCard::ROUND_OVER;
+  }
+
+  // If the player stood, the fifth card was the banker's third card and the
+  // round is over. Otherwise the banker may draw after the player's third.
+  if (round.num_of_cards_dealt == NUM_OF_INITIAL_CARDS + 1 &&
+      round.player_third_card >= 0 &&
+      CardDealer::banker_can_draw_third_card(round.banker_hand_value,
+                                             round.player_third_card))
+  {
+    return NextCard::BANKER;
+  }
+  return NextCard::ROUND_OVER;
+}
+
+} // namespace BACCARAT
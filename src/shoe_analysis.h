@@ -0,0 +1,152 @@
+#ifndef SHOE_ANALYSIS_H
+#define SHOE_ANALYSIS_H
+
+#include "rule_set.h"
+#include "shoe_mode.h"
+
+#include <array>
+#include <cstdint>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief The probability of each outcome of a round of Baccarat.
+ */
+struct OutcomeProbabilities
+{
+  double player = 0.0;
+  double banker = 0.0;
+  double tie = 0.0;
+};
+
+/**
+ * @brief The house edge of each bet, as a fraction of the amount staked.
+ */
+struct HouseEdges
+{
+  double player = 0.0;
+  double banker = 0.0;
+  double tie = 0.0;
+};
+
+/**
+ * @brief A class to compute the exact outcome probabilities of Baccarat.
+ *
+ * @details The probabilities are computed by enumerating every possible
+ * sequence of cards for a single round, using the drawing rules of the
+ * CardDealer. For a FINITE_SHOE the round is dealt off the top of a full shoe
+ * and cards are not replaced, for an INFINITE_DECK every draw is independent.
+ *
+ * @note This allows the accuracy lost by the faster INFINITE_DECK mode to be
+ * measured against the finite shoe for a given RuleSet.
+ */
+class ShoeAnalysis
+{
+public:
+  /**
+   * @brief Computes the exact probability of each outcome of a round.
+   *
+   * @param rules The table rules, used for the number of decks in the shoe.
+   * @param shoe_mode How cards are drawn from the shoe.
+   *
+   * @return The probability of a player win, banker win and tie.
+   */
+  [[nodiscard]] static auto
+  compute_outcome_probabilities(const RuleSet &rules,
+                                ShoeMode shoe_mode) -> OutcomeProbabilities;
+
+  /**
+   * @brief Computes the house edge of each bet from the outcome probabilities.
+   *
+   * @param probabilities The probability of each outcome.
+   * @param rules The table rules used to settle the bets.
+   *
+   * @return The house edge of the PLAYER, BANKER and TIE bets.
+   */
+  [[nodiscard]] static auto
+  compute_house_edges(const OutcomeProbabilities &probabilities,
+                      const RuleSet &rules) -> HouseEdges;
+
+  /**
+   * @brief Prints the outcome probabilities and house edges of the finite shoe
+   * and the infinite deck side by side.
+   *
+   * @param rules The table rules to compare.
+   */
+  static void print_comparison_report(const RuleSet &rules);
+
+private:
+  /// @brief The number of cards dealt before any third card is drawn.
+  static constexpr int NUM_OF_INITIAL_CARDS = 4;
+
+  /// @brief The modulo value used to calculate the hand value in Baccarat.
+  static constexpr int HAND_VALUE_MODULO = 10;
+
+  /**
+   * @brief The remaining cards used while enumerating a round.
+   */
+  struct EnumerationShoe
+  {
+    /// @brief The number of cards remaining of each card type.
+    std::array<int, 13> remaining_cards = {};
+
+    /// @brief The total number of cards remaining.
+    int total_remaining_cards = 0;
+
+    /// @brief If true, drawn cards are removed from the shoe.
+    bool deplete = true;
+  };
+
+  /**
+   * @brief The hands dealt so far while enumerating a round.
+   */
+  struct EnumerationRound
+  {
+    int player_hand_value = 0;
+    int banker_hand_value = 0;
+    int num_of_cards_dealt = 0;
+
+    /// @brief The card type of the player's third card, -1 if not drawn.
+    int player_third_card = -1;
+  };
+
+  /**
+   * @brief Who receives the next card of a round being enumerated.
+   */
+  enum class NextCard : std::uint8_t
+  {
+    PLAYER,
+    BANKER,
+    ROUND_OVER
+  };
+
+  /**
+   * @brief Recursively deals the next card of the round for every card type.
+   *
+   * @param shoe The remaining cards in the shoe.
+   * @param round The hands dealt so far.
+   * @param probability The probability of the cards dealt so far.
+   * @param probabilities The accumulated outcome probabilities.
+   */
+  static void enumerate_round(EnumerationShoe &shoe,
+                              const EnumerationRound &round,
+                              double probability,
+                              OutcomeProbabilities &probabilities);
+
+  /**
+   * @brief Determines who receives the next card, using the CardDealer rules.
+   *
+   * @details Cards are dealt in the same order as CardDealer, two to the
+   * player, two to the banker, then the player's and banker's third cards.
+   *
+   * @param round The hands dealt so far.
+   *
+   * @return Who receives the next card, or ROUND_OVER.
+   */
+  static auto get_next_card(const EnumerationRound &round) -> NextCard;
+};
+
+} // namespace BACCARAT
+
+#endif // SHOE_ANALYSIS_H
@@ -0,0 +1,401 @@
+#include "shoe_index.h"
+#include "binary_io.h"
+#include "card_dealer.h"
+#include "rare_event.h"
+#include "shoe_log.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+
+namespace BACCARAT
+{
+
+// PUBLIC METHODS
+
+auto ShoeIndex::build(const std::string &log_path,
+                      const std::string &index_path) -> bool
+{
+  ShoeLogReader shoe_log_reader;
+  if (!shoe_log_reader.open(log_path))
+  {
+    printf("Failed to read shoe log '%s'.\n", log_path.c_str());
+    return false;
+  }
+
+  std::vector<std::string> feature_names = get_shoe_feature_names();
+  std::vector<std::string> bitmap_names = get_hand_bitmap_names();
+  std::vector<std::vector<std::uint32_t>> features(feature_names.size());
+  std::vector<std::vector<std::uint64_t>> bitmaps(bitmap_names.size());
+  std::vector<std::uint64_t> first_round_indexes = {0};
+  std::vector<std::uint8_t> cards;
+
+  std::array<RareEvent, 3> streaks = {
+      RareEvent(RareEventType::PLAYER_STREAK, 1),
+      RareEvent(RareEventType::BANKER_STREAK, 1),
+      RareEvent(RareEventType::TIE_STREAK, 1)};
+  RareEvent dragon_seven(RareEventType::DRAGON_SEVEN, 1);
+  RareEvent panda_eight(RareEventType::PANDA_EIGHT, 1);
+
+  std::uint64_t num_of_rounds = 0;
+  std::vector<RoundResult> rounds;
+  while (!shoe_log_reader.is_at_end())
+  {
+    if (!shoe_log_reader.read_shoe(rounds))
+    {
+      printf("Shoe log '%s' is corrupt at shoe %zu.\n", log_path.c_str(),
+             first_round_indexes.size());
+      return false;
+    }
+
+    // rounds, player-wins, banker-wins, ties, naturals, player-pairs,
+    // banker-pairs, dragon7s, panda8s, then the longest streaks.
+    std::array<std::uint32_t, NUM_OF_SHOE_FEATURES> shoe_features = {};
+    for (RareEvent &streak : streaks)
+    {
+      streak.reset_state();
+    }
+    dragon_seven.reset_state();
+    panda_eight.reset_state();
+
+    for (const RoundResult &round_result : rounds)
+    {
+      if (num_of_rounds % BITS_PER_WORD == 0)
+      {
+        for (std::vector<std::uint64_t> &bitmap : bitmaps)
+        {
+          bitmap.push_back(0);
+        }
+      }
+      std::uint64_t bit = 1ULL << (num_of_rounds % BITS_PER_WORD);
+      auto set_bit = [&bitmaps, bit](std::size_t bitmap_index)
+      { bitmaps[bitmap_index].back() |= bit; };
+
+      int player_total =
+          (CardDealer::get_card_value(round_result.player_cards[0]) +
+           CardDealer::get_card_value(round_result.player_cards[1])) %
+          HAND_VALUE_MODULO;
+      int banker_total =
+          (CardDealer::get_card_value(round_result.banker_cards[0]) +
+           CardDealer::get_card_value(round_result.banker_cards[1])) %
+          HAND_VALUE_MODULO;
+      dragon_seven.record_round(round_result);
+      panda_eight.record_round(round_result);
+
+      // The flags in the order of get_hand_bitmap_names.
+      std::array<bool, NUM_OF_HAND_FLAGS> flags = {
+          round_result.outcome == BetType::PLAYER,
+          round_result.outcome == BetType::BANKER,
+          round_result.outcome == BetType::TIE,
+          player_total >= NATURAL_HAND_VALUE,
+          banker_total >= NATURAL_HAND_VALUE,
+          round_result.num_of_player_cards == 3,
+          round_result.num_of_banker_cards == 3,
+          round_result.player_cards[0] == round_result.player_cards[1],
+          round_result.banker_cards[0] == round_result.banker_cards[1],
+          dragon_seven.get_streak_length() > 0,
+          panda_eight.get_streak_length() > 0};
+      for (std::size_t i = 0; i < flags.size(); ++i)
+      {
+        if (flags[i])
+        {
+          set_bit(i);
+        }
+      }
+
+      std::size_t valued_bitmap_index = NUM_OF_HAND_FLAGS;
+      set_bit(valued_bitmap_index + player_total);
+      valued_bitmap_index += MAX_CARD_VALUE + 1;
+      set_bit(valued_bitmap_index + banker_total);
+      valued_bitmap_index += MAX_CARD_VALUE + 1;
+      if (round_result.num_of_player_cards == 3)
+      {
+        set_bit(valued_bitmap_index +
+                CardDealer::get_card_value(round_result.player_cards[2]));
+      }
+      valued_bitmap_index += MAX_CARD_VALUE + 1;
+      if (round_result.num_of_banker_cards == 3)
+      {
+        set_bit(valued_bitmap_index +
+                CardDealer::get_card_value(round_result.banker_cards[2]));
+      }
+
+      ++shoe_features[0];
+      shoe_features[1] += flags[0] ? 1 : 0;
+      shoe_features[2] += flags[1] ? 1 : 0;
+      shoe_features[3] += flags[2] ? 1 : 0;
+      shoe_features[4] += (flags[3] || flags[4]) ? 1 : 0;
+      shoe_features[5] += flags[7] ? 1 : 0;
+      shoe_features[6] += flags[8] ? 1 : 0;
+      shoe_features[7] += flags[9] ? 1 : 0;
+      shoe_features[8] += flags[10] ? 1 : 0;
+      for (std::size_t i = 0; i < streaks.size(); ++i)
+      {
+        streaks[i].record_round(round_result);
+        auto streak_length =
+            static_cast<std::uint32_t>(streaks[i].get_streak_length());
+        shoe_features[9 + i] = std::max(shoe_features[9 + i], streak_length);
+      }
+
+      std::size_t position = cards.size();
+      cards.resize(position + ShoeLogWriter::BYTES_PER_ROUND);
+      ShoeLogWriter::encode_round(round_result, &cards[position]);
+      ++num_of_rounds;
+    }
+
+    for (std::size_t i = 0; i < features.size(); ++i)
+    {
+      features[i].push_back(shoe_features[i]);
+    }
+    first_round_indexes.push_back(num_of_rounds);
+  }
+  std::uint64_t num_of_shoes = first_round_indexes.size() - 1;
+  std::uint64_t num_of_bitmap_words =
+      (num_of_rounds + BITS_PER_WORD - 1) / BITS_PER_WORD;
+
+  // Lay the columns out after the header and directory, in the order they
+  // are written below.
+  std::size_t num_of_columns = 2 + features.size() + bitmaps.size();
+  auto align = [](std::uint64_t offset)
+  {
+    return (offset + sizeof(std::uint64_t) - 1) /
+           sizeof(std::uint64_t) * sizeof(std::uint64_t);
+  };
+  std::uint64_t offset =
+      align(HEADER_SIZE + COLUMN_ENTRY_SIZE * num_of_columns);
+  BinaryWriter directory_writer;
+  auto add_column = [&](const std::string &name, ColumnType type,
+                        std::uint64_t num_of_values, std::uint64_t num_of_bytes)
+  {
+    std::vector<std::uint8_t> name_bytes(COLUMN_NAME_SIZE, 0);
+    std::copy(name.begin(), name.end(), name_bytes.begin());
+    directory_writer.write_bytes(name_bytes);
+    directory_writer.write_u64(static_cast<std::uint64_t>(type));
+    directory_writer.write_u64(offset);
+    directory_writer.write_u64(num_of_values);
+    offset = align(offset + num_of_bytes);
+  };
+  add_column("first-round", ColumnType::UINT64, num_of_shoes + 1,
+             (num_of_shoes + 1) * sizeof(std::uint64_t));
+  add_column("cards", ColumnType::BYTES, cards.size(), cards.size());
+  for (const std::string &name : feature_names)
+  {
+    add_column(name, ColumnType::UINT32, num_of_shoes,
+               num_of_shoes * sizeof(std::uint32_t));
+  }
+  for (const std::string &name : bitmap_names)
+  {
+    add_column(name, ColumnType::BITMAP, num_of_bitmap_words,
+               num_of_bitmap_words * sizeof(std::uint64_t));
+  }
+
+  BinaryWriter writer;
+  auto pad = [&writer]()
+  {
+    while (writer.get_buffer().size() % sizeof(std::uint64_t) != 0)
+    {
+      writer.write_bytes({0});
+    }
+  };
+  writer.write_u64(INDEX_MAGIC);
+  writer.write_u64(num_of_shoes);
+  writer.write_u64(num_of_rounds);
+  writer.write_u64(num_of_columns);
+  writer.write_bytes(directory_writer.get_buffer());
+  pad();
+  for (std::uint64_t first_round_index : first_round_indexes)
+  {
+    writer.write_u64(first_round_index);
+  }
+  writer.write_bytes(cards);
+  pad();
+  for (const std::vector<std::uint32_t> &feature : features)
+  {
+    for (std::uint32_t value : feature)
+    {
+      writer.write_u32(value);
+    }
+    pad();
+  }
+  for (const std::vector<std::uint64_t> &bitmap : bitmaps)
+  {
+    for (std::uint64_t word : bitmap)
+    {
+      writer.write_u64(word);
+    }
+  }
+
+  if (!write_file_atomically(index_path, writer.get_buffer()))
+  {
+    printf("Failed to write index '%s'.\n", index_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+auto ShoeIndex::open(const std::string &path) -> bool
+{
+  columns.clear();
+  num_of_shoes = 0;
+  num_of_rounds = 0;
+  first_round_indexes = nullptr;
+  cards = nullptr;
+  if (!file.open(path) || file.get_size() < HEADER_SIZE)
+  {
+    return false;
+  }
+
+  // The index is read in place, so the magic only matches on a little endian
+  // host, which is also the only host the values can be read on.
+  const std::uint8_t *data = file.get_data();
+  std::size_t size = file.get_size();
+  const auto *header = reinterpret_cast<const std::uint64_t *>(data);
+  if (header[0] != INDEX_MAGIC)
+  {
+    return false;
+  }
+  num_of_shoes = header[1];
+  num_of_rounds = header[2];
+  std::uint64_t num_of_columns = header[3];
+  if (num_of_columns > (size - HEADER_SIZE) / COLUMN_ENTRY_SIZE ||
+      num_of_shoes >= size || num_of_rounds >= size)
+  {
+    return false;
+  }
+
+  for (std::uint64_t i = 0; i < num_of_columns; ++i)
+  {
+    const std::uint8_t *entry = data + HEADER_SIZE + i * COLUMN_ENTRY_SIZE;
+    const auto *fields =
+        reinterpret_cast<const std::uint64_t *>(entry + COLUMN_NAME_SIZE);
+    Column column = {static_cast<ColumnType>(fields[0]), fields[1], fields[2]};
+
+    std::uint64_t value_size = 0;
+    std::uint64_t num_of_values = 0;
+    switch (column.type)
+    {
+    case ColumnType::UINT32:
+      value_size = sizeof(std::uint32_t);
+      num_of_values = num_of_shoes;
+      break;
+    case ColumnType::UINT64:
+      value_size = sizeof(std::uint64_t);
+      num_of_values = num_of_shoes + 1;
+      break;
+    case ColumnType::BITMAP:
+      value_size = sizeof(std::uint64_t);
+      num_of_values = get_num_of_bitmap_words();
+      break;
+    case ColumnType::BYTES:
+      value_size = 1;
+      num_of_values = num_of_rounds * ShoeLogWriter::BYTES_PER_ROUND;
+      break;
+    default:
+      return false;
+    }
+    if (column.num_of_values != num_of_values ||
+        column.offset % sizeof(std::uint64_t) != 0 || column.offset > size ||
+        num_of_values > (size - column.offset) / value_size)
+    {
+      return false;
+    }
+
+    const char *name = reinterpret_cast<const char *>(entry);
+    columns[std::string(name, strnlen(name, COLUMN_NAME_SIZE))] = column;
+  }
+
+  first_round_indexes = reinterpret_cast<const std::uint64_t *>(
+      get_column("first-round", ColumnType::UINT64));
+  cards = get_column("cards", ColumnType::BYTES);
+  if (first_round_indexes == nullptr || cards == nullptr ||
+      first_round_indexes[0] != 0 ||
+      first_round_indexes[num_of_shoes] != num_of_rounds ||
+      !std::is_sorted(first_round_indexes,
+                      first_round_indexes + num_of_shoes + 1))
+  {
+    return false;
+  }
+  return true;
+}
+
+auto ShoeIndex::get_num_of_shoes() const -> std::uint64_t
+{
+  return num_of_shoes;
+}
+
+auto ShoeIndex::get_num_of_rounds() const -> std::uint64_t
+{
+  return num_of_rounds;
+}
+
+auto ShoeIndex::get_num_of_bitmap_words() const -> std::uint64_t
+{
+  return (num_of_rounds + BITS_PER_WORD - 1) / BITS_PER_WORD;
+}
+
+auto ShoeIndex::get_shoe_feature(const std::string &name) const
+    -> const std::uint32_t *
+{
+  return reinterpret_cast<const std::uint32_t *>(
+      get_column(name, ColumnType::UINT32));
+}
+
+auto ShoeIndex::get_hand_bitmap(const std::string &name) const
+    -> const std::uint64_t *
+{
+  return reinterpret_cast<const std::uint64_t *>(
+      get_column(name, ColumnType::BITMAP));
+}
+
+auto ShoeIndex::get_first_round_index(std::uint64_t shoe_index) const
+    -> std::uint64_t
+{
+  return first_round_indexes[shoe_index];
+}
+
+auto ShoeIndex::get_round(std::uint64_t round_index,
+                          RoundResult &round_result) const -> bool
+{
+  return ShoeLogReader::decode_round(
+      &cards[round_index * ShoeLogWriter::BYTES_PER_ROUND], round_result);
+}
+
+// PRIVATE METHODS
+
+auto ShoeIndex::get_shoe_feature_names() -> std::vector<std::string>
+{
+  return {"rounds",       "player-wins",   "banker-wins",   "ties",
+          "naturals",     "player-pairs",  "banker-pairs",  "dragon7s",
+          "panda8s",      "player-streak", "banker-streak", "tie-streak"};
+}
+
+auto ShoeIndex::get_hand_bitmap_names() -> std::vector<std::string>
+{
+  std::vector<std::string> names = {
+      "player-win",    "banker-win",  "tie",         "player-natural",
+      "banker-natural", "player-draw", "banker-draw", "player-pair",
+      "banker-pair",   "dragon7",     "panda8"};
+  for (const char *valued_name :
+       {"player-total=", "banker-total=", "player-third=", "banker-third="})
+  {
+    for (int value = 0; value <= MAX_CARD_VALUE; ++value)
+    {
+      names.push_back(valued_name + std::to_string(value));
+    }
+  }
+  return names;
+}
+
+auto ShoeIndex::get_column(const std::string &name, ColumnType type) const
+    -> const std::uint8_t *
+{
+  auto column = columns.find(name);
+  if (column == columns.end() || column->second.type != type)
+  {
+    return nullptr;
+  }
+  return file.get_data() + column->second.offset;
+}
+
+} // namespace BACCARAT
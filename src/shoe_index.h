@@ -0,0 +1,234 @@
+#ifndef SHOE_INDEX_H
+#define SHOE_INDEX_H
+
+#include "mapped_file.h"
+#include "round_result.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief A class to build and read a columnar index of a shoe log.
+ *
+ * @details The index stores summary features of every shoe, e.g. its longest
+ * PLAYER streak, as a column of 32 bit integers, and flags of every hand,
+ * e.g. whether the banker drew a third card, as a bitmap with one bit per
+ * hand. Queries only touch the columns and bitmaps they filter on, so they
+ * never decode the rounds of the log again.
+ *
+ * Shoe features: rounds, player-wins, banker-wins, ties, naturals,
+ * player-pairs, banker-pairs, dragon7s, panda8s, player-streak,
+ * banker-streak and tie-streak, where a streak is the longest in the shoe and
+ * ties neither extend nor break a PLAYER or BANKER streak.
+ *
+ * Hand bitmaps: player-win, banker-win, tie, player-natural, banker-natural,
+ * player-draw, banker-draw, player-pair, banker-pair, dragon7, panda8, and
+ * player-total=V, banker-total=V (the value of the first two cards),
+ * player-third=V and banker-third=V (the value of the third card) for V from
+ * 0 to 9.
+ *
+ * @note The index is little endian and is read in place from a memory
+ * mapping, laid out as: magic "BACIDX01", number of shoes, number of rounds,
+ * number of columns, then for each column its name (32 bytes, zero padded),
+ * type, byte offset and number of values, then the values of each column
+ * starting at offsets aligned to 8 bytes. The first-round column holds the
+ * index of the first round of every shoe plus the total number of rounds,
+ * and the cards column holds the 6 cards of every round as in the shoe log.
+ */
+class ShoeIndex
+{
+public:
+  /**
+   * @brief Builds the index of a shoe log.
+   *
+   * @param log_path The path of the shoe log, see ShoeLogWriter.
+   * @param index_path The path of the index.
+   *
+   * @return true if the index was written, false otherwise.
+   */
+  static auto build(const std::string &log_path,
+                    const std::string &index_path) -> bool;
+
+  /**
+   * @brief Opens an index.
+   *
+   * @param path The path of the index.
+   *
+   * @return true if the file is a valid index, false otherwise.
+   */
+  auto open(const std::string &path) -> bool;
+
+  /**
+   * @brief Get the number of shoes in the index.
+   *
+   * @return The number of shoes.
+   */
+  [[nodiscard]] auto get_num_of_shoes() const -> std::uint64_t;
+
+  /**
+   * @brief Get the number of rounds in the index.
+   *
+   * @return The number of rounds.
+   */
+  [[nodiscard]] auto get_num_of_rounds() const -> std::uint64_t;
+
+  /**
+   * @brief Get the number of words in a hand bitmap.
+   *
+   * @return The number of 64 bit words, the last one padded with zeros.
+   */
+  [[nodiscard]] auto get_num_of_bitmap_words() const -> std::uint64_t;
+
+  /**
+   * @brief Get the values of a shoe feature.
+   *
+   * @param name The name of the feature, e.g. 'player-streak'.
+   *
+   * @return A value for every shoe, nullptr if there is no such feature.
+   */
+  [[nodiscard]] auto
+  get_shoe_feature(const std::string &name) const -> const std::uint32_t *;
+
+  /**
+   * @brief Get a hand bitmap.
+   *
+   * @param name The name of the bitmap, e.g. 'banker-total=6'.
+   *
+   * @return The bits of every hand, bit i % 64 of word i / 64 for hand i, or
+   * nullptr if there is no such bitmap.
+   */
+  [[nodiscard]] auto
+  get_hand_bitmap(const std::string &name) const -> const std::uint64_t *;
+
+  /**
+   * @brief Get the index of the first round of a shoe.
+   *
+   * @param shoe_index The index of the shoe, or the number of shoes to get
+   * the number of rounds.
+   *
+   * @return The index of the round.
+   */
+  [[nodiscard]] auto
+  get_first_round_index(std::uint64_t shoe_index) const -> std::uint64_t;
+
+  /**
+   * @brief Reads the cards of a round.
+   *
+   * @param round_index The index of the round.
+   * @param round_result The round read.
+   *
+   * @return true if the cards are valid, false otherwise.
+   */
+  auto get_round(std::uint64_t round_index,
+                 RoundResult &round_result) const -> bool;
+
+private:
+  /// @brief Identifies an index, the ASCII string "BACIDX01".
+  static constexpr std::uint64_t INDEX_MAGIC = 0x3130584449434142ULL;
+
+  /// @brief The number of bytes of a column name, including padding.
+  static constexpr std::size_t COLUMN_NAME_SIZE = 32;
+
+  /// @brief The number of bytes of a column in the directory.
+  static constexpr std::size_t COLUMN_ENTRY_SIZE = COLUMN_NAME_SIZE + 24;
+
+  /// @brief The number of bytes of the header before the directory.
+  static constexpr std::size_t HEADER_SIZE = 32;
+
+  /// @brief The largest value of a card.
+  static constexpr int MAX_CARD_VALUE = 9;
+
+  /// @brief Hand values are the last digit of the sum of the card values.
+  static constexpr int HAND_VALUE_MODULO = 10;
+
+  /// @brief A two card hand of 8 or 9 is a natural.
+  static constexpr int NATURAL_HAND_VALUE = 8;
+
+  /// @brief The number of hands in a word of a bitmap.
+  static constexpr std::uint64_t BITS_PER_WORD = 64;
+
+  /// @brief The number of shoe features, see get_shoe_feature_names.
+  static constexpr std::size_t NUM_OF_SHOE_FEATURES = 12;
+
+  /// @brief The number of hand bitmaps before the bitmaps of hand values, see
+  /// get_hand_bitmap_names.
+  static constexpr std::size_t NUM_OF_HAND_FLAGS = 11;
+
+  /**
+   * @brief Enum class to represent the type of the values of a column.
+   */
+  enum class ColumnType : std::uint64_t
+  {
+    /// @brief 32 bit integers, one per shoe.
+    UINT32,
+    /// @brief 64 bit integers.
+    UINT64,
+    /// @brief A bitmap, stored as 64 bit words, one bit per hand.
+    BITMAP,
+    /// @brief Bytes.
+    BYTES
+  };
+
+  /**
+   * @brief The location of a column in the index.
+   */
+  struct Column
+  {
+    ColumnType type = ColumnType::BYTES;
+    std::uint64_t offset = 0;
+    std::uint64_t num_of_values = 0;
+  };
+
+  /// @brief The mapped index.
+  MappedFile file;
+
+  /// @brief The columns of the index by name.
+  std::map<std::string, Column> columns;
+
+  /// @brief The number of shoes in the index.
+  std::uint64_t num_of_shoes = 0;
+
+  /// @brief The number of rounds in the index.
+  std::uint64_t num_of_rounds = 0;
+
+  /// @brief The index of the first round of every shoe, and the number of
+  /// rounds.
+  const std::uint64_t *first_round_indexes = nullptr;
+
+  /// @brief The cards of every round.
+  const std::uint8_t *cards = nullptr;
+
+  /**
+   * @brief Gets the names of the shoe features, in the order they are built.
+   *
+   * @return The names.
+   */
+  static auto get_shoe_feature_names() -> std::vector<std::string>;
+
+  /**
+   * @brief Gets the names of the hand bitmaps, in the order they are built.
+   *
+   * @return The names.
+   */
+  static auto get_hand_bitmap_names() -> std::vector<std::string>;
+
+  /**
+   * @brief Gets the values of a column in the mapped index.
+   *
+   * @param name The name of the column.
+   * @param type The type the column must have.
+   *
+   * @return The values, nullptr if there is no such column.
+   */
+  [[nodiscard]] auto get_column(const std::string &name,
+                                ColumnType type) const -> const std::uint8_t *;
+};
+
+} // namespace BACCARAT
+
+#endif // SHOE_INDEX_H
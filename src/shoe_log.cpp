@@ -0,0 +1,218 @@
+#include "shoe_log.h"
+#include "binary_io.h"
+#include "card_dealer.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace BACCARAT
+{
+
+// CONSTRUCTORS
+
+ShoeLogWriter::ShoeLogWriter(const std::string &path)
+    : file(path, std::ios::binary | std::ios::trunc)
+{
+  BinaryWriter writer;
+  writer.write_u64(SHOE_LOG_MAGIC);
+  file.write(reinterpret_cast<const char *>(writer.get_buffer().data()),
+             static_cast<std::streamsize>(writer.get_buffer().size()));
+}
+
+// PUBLIC METHODS
+
+auto ShoeLogWriter::is_good() const -> bool { return file.good(); }
+
+void ShoeLogWriter::write_shoe(const std::vector<RoundResult> &rounds)
+{
+  BinaryWriter writer;
+  writer.write_u64(rounds.size());
+
+  std::vector<std::uint8_t> bytes(rounds.size() * BYTES_PER_ROUND);
+  for (std::size_t i = 0; i < rounds.size(); ++i)
+  {
+    encode_round(rounds[i], &bytes[i * BYTES_PER_ROUND]);
+  }
+  writer.write_bytes(bytes);
+
+  file.write(reinterpret_cast<const char *>(writer.get_buffer().data()),
+             static_cast<std::streamsize>(writer.get_buffer().size()));
+}
+
+void ShoeLogWriter::encode_round(const RoundResult &round_result,
+                                 std::uint8_t *bytes)
+{
+  for (std::size_t i = 0; i < BYTES_PER_ROUND; ++i)
+  {
+    bytes[i] = NO_CARD;
+  }
+  for (int i = 0; i < round_result.num_of_player_cards; ++i)
+  {
+    bytes[i] = static_cast<std::uint8_t>(round_result.player_cards[i]);
+  }
+  for (int i = 0; i < round_result.num_of_banker_cards; ++i)
+  {
+    bytes[3 + i] = static_cast<std::uint8_t>(round_result.banker_cards[i]);
+  }
+}
+
+auto ShoeLogWriter::record_shoes(const RuleSet &rules,
+                                 const SimulationOptions &options,
+                                 const std::string &path) -> bool
+{
+  ShoeLogWriter shoe_log_writer(path);
+  int total_cards_in_deck = CardDealer::CARDS_PER_DECK * rules.num_of_decks;
+  auto cut_card_position =
+      static_cast<int>(options.penetration * total_cards_in_deck);
+
+  // The shoes are dealt in the chunks of a batch run, each from a new dealer,
+  // so a shuffle model that carries the order of a shoe into the next starts
+  // each chunk from new decks exactly as the batch run does.
+  std::vector<RoundResult> rounds;
+  for (std::uint64_t first_shoe_index = 0;
+       first_shoe_index < options.num_of_shoes && shoe_log_writer.is_good();
+       first_shoe_index += Simulation::SHOES_PER_CHUNK)
+  {
+    CardDealer card_dealer(rules, options.shoe_mode);
+    card_dealer.set_continuous_shuffle_delay(options.continuous_shuffle_delay);
+    card_dealer.set_shuffle_model(options.shuffle_model,
+                                  options.num_of_shuffle_passes);
+
+    std::uint64_t last_shoe_index = std::min(
+        first_shoe_index + Simulation::SHOES_PER_CHUNK, options.num_of_shoes);
+    for (std::uint64_t shoe_index = first_shoe_index;
+         shoe_index < last_shoe_index && shoe_log_writer.is_good();
+         ++shoe_index)
+    {
+      card_dealer.reset_deck(
+          Simulation::get_shoe_seed(options.seed, shoe_index));
+
+      rounds.clear();
+      int num_of_cards_dealt = 0;
+      while (num_of_cards_dealt < cut_card_position &&
+             num_of_cards_dealt + MAX_CARDS_IN_ROUND <= total_cards_in_deck)
+      {
+        RoundResult &round_result = rounds.emplace_back();
+        card_dealer.deal_round(round_result);
+        num_of_cards_dealt += round_result.num_of_player_cards +
+                              round_result.num_of_banker_cards;
+      }
+      shoe_log_writer.write_shoe(rounds);
+    }
+  }
+
+  shoe_log_writer.file.close();
+  if (!shoe_log_writer.file)
+  {
+    printf("Failed to write shoe log '%s'.\n", path.c_str());
+    return false;
+  }
+  return true;
+}
+
+auto ShoeLogReader::open(const std::string &path) -> bool
+{
+  position = 0;
+  if (!file.open(path) || file.get_size() < sizeof(std::uint64_t))
+  {
+    return false;
+  }
+
+  std::uint64_t magic = 0;
+  for (std::size_t i = 0; i < sizeof(magic); ++i)
+  {
+    magic |= static_cast<std::uint64_t>(file.get_data()[i]) << (8U * i);
+  }
+  position = sizeof(magic);
+  return magic == ShoeLogWriter::SHOE_LOG_MAGIC;
+}
+
+auto ShoeLogReader::is_at_end() const -> bool
+{
+  return position >= file.get_size();
+}
+
+auto ShoeLogReader::read_shoe(std::vector<RoundResult> &rounds) -> bool
+{
+  const std::uint8_t *data = file.get_data();
+  std::size_t size = file.get_size();
+  if (size - position < sizeof(std::uint64_t))
+  {
+    return false;
+  }
+
+  std::uint64_t num_of_rounds = 0;
+  for (std::size_t i = 0; i < sizeof(num_of_rounds); ++i)
+  {
+    num_of_rounds |= static_cast<std::uint64_t>(data[position + i])
+                     << (8U * i);
+  }
+  position += sizeof(num_of_rounds);
+  if (num_of_rounds > (size - position) / ShoeLogWriter::BYTES_PER_ROUND)
+  {
+    return false;
+  }
+
+  rounds.resize(num_of_rounds);
+  for (RoundResult &round_result : rounds)
+  {
+    if (!decode_round(&data[position], round_result))
+    {
+      return false;
+    }
+    position += ShoeLogWriter::BYTES_PER_ROUND;
+  }
+  return true;
+}
+
+auto ShoeLogReader::decode_round(const std::uint8_t *bytes,
+                                 RoundResult &round_result) -> bool
+{
+  round_result = RoundResult();
+  for (int i = 0; i < 3; ++i)
+  {
+    for (bool is_player : {true, false})
+    {
+      std::uint8_t card = bytes[is_player ? i : 3 + i];
+      if (card == ShoeLogWriter::NO_CARD)
+      {
+        continue;
+      }
+      if (card >= CardDealer::NUM_OF_UNIQUE_CARDS)
+      {
+        return false;
+      }
+
+      int &num_of_cards = is_player ? round_result.num_of_player_cards
+                                    : round_result.num_of_banker_cards;
+      int &hand_value = is_player ? round_result.player_hand_value
+                                  : round_result.banker_hand_value;
+      (is_player ? round_result.player_cards
+                 : round_result.banker_cards)[num_of_cards] = card;
+      ++num_of_cards;
+      hand_value =
+          (hand_value + CardDealer::get_card_value(card)) % HAND_VALUE_MODULO;
+    }
+  }
+  if (round_result.num_of_player_cards < 2 ||
+      round_result.num_of_banker_cards < 2)
+  {
+    return false;
+  }
+
+  if (round_result.player_hand_value > round_result.banker_hand_value)
+  {
+    round_result.outcome = BetType::PLAYER;
+  }
+  else if (round_result.player_hand_value < round_result.banker_hand_value)
+  {
+    round_result.outcome = BetType::BANKER;
+  }
+  else
+  {
+    round_result.outcome = BetType::TIE;
+  }
+  return true;
+}
+
+} // namespace BACCARAT
@@ -0,0 +1,151 @@
+#ifndef SHOE_LOG_H
+#define SHOE_LOG_H
+
+#include "mapped_file.h"
+#include "round_result.h"
+#include "rule_set.h"
+#include "simulation.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief A class to archive dealt shoes to a binary shoe log.
+ *
+ * @details Only the cards of each round are stored, everything else about a
+ * round follows from its cards, see ShoeLogReader.
+ *
+ * @note The log is little endian, and laid out as: magic "BACLOG01", then for
+ * each shoe its number of rounds and 6 bytes per round, the three player
+ * cards then the three banker cards, where a card that was not drawn is 255.
+ */
+class ShoeLogWriter
+{
+public:
+  /// @brief Identifies a shoe log, the ASCII string "BACLOG01".
+  static constexpr std::uint64_t SHOE_LOG_MAGIC = 0x3130474F4C434142ULL;
+
+  /// @brief The number of bytes of a round in the log.
+  static constexpr std::size_t BYTES_PER_ROUND = 6;
+
+  /// @brief The byte of a card that was not drawn.
+  static constexpr std::uint8_t NO_CARD = 255;
+
+  /**
+   * @brief Constructor for the ShoeLogWriter class, creates the log.
+   *
+   * @param path The path of the log.
+   */
+  explicit ShoeLogWriter(const std::string &path);
+
+  /**
+   * @brief Determines if the log was created and every write succeeded.
+   *
+   * @return true if the log is good, false otherwise.
+   */
+  [[nodiscard]] auto is_good() const -> bool;
+
+  /**
+   * @brief Appends a shoe to the log.
+   *
+   * @param rounds The rounds of the shoe, in the order they were dealt.
+   */
+  void write_shoe(const std::vector<RoundResult> &rounds);
+
+  /**
+   * @brief Writes the cards of a round as they are stored in the log.
+   *
+   * @param round_result The round.
+   * @param bytes The BYTES_PER_ROUND bytes of the round.
+   */
+  static void encode_round(const RoundResult &round_result,
+                           std::uint8_t *bytes);
+
+  /**
+   * @brief Deals shoes and archives them to a shoe log.
+   *
+   * @details The shoes are dealt exactly like the shoes of a batch
+   * simulation with the same seed, so shoe i of the log is shoe i of the
+   * batch.
+   *
+   * @param rules The table rules, used for the number of decks in the shoe.
+   * @param options The number of shoes, seed, penetration and shoe mode.
+   * @param path The path of the log.
+   *
+   * @return true if the log was written, false otherwise.
+   */
+  static auto record_shoes(const RuleSet &rules,
+                           const SimulationOptions &options,
+                           const std::string &path) -> bool;
+
+private:
+  /// @brief The most cards that can be dealt in a single round.
+  static constexpr int MAX_CARDS_IN_ROUND = 6;
+
+  /// @brief The log file.
+  std::ofstream file;
+};
+
+/**
+ * @brief A class to read the shoes of a shoe log written by ShoeLogWriter.
+ */
+class ShoeLogReader
+{
+public:
+  /**
+   * @brief Opens a shoe log.
+   *
+   * @param path The path of the log.
+   *
+   * @return true if the file is a shoe log, false otherwise.
+   */
+  auto open(const std::string &path) -> bool;
+
+  /**
+   * @brief Determines if every shoe has been read.
+   *
+   * @return true if there are no more shoes in the log.
+   */
+  [[nodiscard]] auto is_at_end() const -> bool;
+
+  /**
+   * @brief Reads the next shoe.
+   *
+   * @param rounds The rounds of the shoe, with their hand values and outcome
+   * worked out from the cards.
+   *
+   * @return true if the shoe was read, false if the log is corrupt.
+   */
+  auto read_shoe(std::vector<RoundResult> &rounds) -> bool;
+
+  /**
+   * @brief Reads a round from its bytes in the log, or from the cards stored
+   * in a ShoeIndex.
+   *
+   * @param bytes The bytes of the round.
+   * @param round_result The round read.
+   *
+   * @return true if the cards are valid, false otherwise.
+   */
+  static auto decode_round(const std::uint8_t *bytes,
+                           RoundResult &round_result) -> bool;
+
+private:
+  /// @brief Hand values are the last digit of the sum of the card values.
+  static constexpr int HAND_VALUE_MODULO = 10;
+
+  /// @brief The mapped log.
+  MappedFile file;
+
+  /// @brief The position of the next shoe in the log.
+  std::size_t position = 0;
+};
+
+} // namespace BACCARAT
+
+#endif // SHOE_LOG_H
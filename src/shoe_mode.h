@@ -0,0 +1,42 @@
+#ifndef SHOE_MODE_H
+#define SHOE_MODE_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief Enum class to represent how the CardDealer draws cards.
+ */
+enum class ShoeMode : std::uint8_t
+{
+  /// @brief Cards are drawn from a depleting shoe until it is reset.
+  FINITE_SHOE,
+  /// @brief Every draw is independent, as if the shoe had infinite decks.
+  INFINITE_DECK,
+  /// @brief A continuous shuffling machine, the cards of each round are
+  /// returned to the shoe after a configurable delay.
+  CONTINUOUS_SHUFFLE
+};
+
+/**
+ * @brief Convert a ShoeMode enum to a string representation.
+ *
+ * @param shoe_mode The ShoeMode enum value.
+ *
+ * @return The string representation of the shoe mode.
+ */
+[[nodiscard]] static auto
+get_string_shoe_mode(const ShoeMode &shoe_mode) -> std::string
+{
+  static const std::array<std::string, 3> SHOE_MODE_STRINGS = {
+      "FINITE_SHOE", "INFINITE_DECK", "CONTINUOUS_SHUFFLE"};
+  return SHOE_MODE_STRINGS[static_cast<std::size_t>(shoe_mode)];
+}
+
+} // namespace BACCARAT
+
+#endif // SHOE_MODE_H
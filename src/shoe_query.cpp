@@ -0,0 +1,289 @@
+#include "shoe_query.h"
+#include "card_dealer.h"
+
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+
+namespace BACCARAT
+{
+
+// CONSTRUCTORS
+
+ShoeQuery::ShoeQuery(const ShoeIndex &shoe_index) : shoe_index(shoe_index) {}
+
+// PUBLIC METHODS
+
+auto ShoeQuery::add_filter(const std::string &filter) -> bool
+{
+  // Hand bitmaps are named in full, some of their names contain '='.
+  bool negated = filter.rfind("not:", 0) == 0;
+  const std::uint64_t *bitmap =
+      shoe_index.get_hand_bitmap(negated ? filter.substr(4) : filter);
+  if (bitmap != nullptr)
+  {
+    hand_filters.push_back({bitmap, negated});
+    return true;
+  }
+
+  static const std::vector<std::pair<std::string, Comparison>> COMPARISONS = {
+      {"<=", Comparison::LESS_EQUAL},
+      {">=", Comparison::GREATER_EQUAL},
+      {"<", Comparison::LESS},
+      {">", Comparison::GREATER},
+      {"=", Comparison::EQUAL}};
+
+  ShoeFilter shoe_filter;
+  std::size_t pos = filter.find_first_of("<>=");
+  if (pos == std::string::npos)
+  {
+    printf("Unknown hand bitmap '%s'.\n", filter.c_str());
+    return false;
+  }
+  shoe_filter.name = filter.substr(0, pos);
+  shoe_filter.values = shoe_index.get_shoe_feature(shoe_filter.name);
+  if (shoe_filter.values == nullptr)
+  {
+    printf("Unknown shoe feature '%s' in '%s'.\n", shoe_filter.name.c_str(),
+           filter.c_str());
+    return false;
+  }
+
+  for (const auto &[comparison_string, comparison] : COMPARISONS)
+  {
+    if (filter.compare(pos, comparison_string.size(), comparison_string) != 0)
+    {
+      continue;
+    }
+
+    std::string value_string = filter.substr(pos + comparison_string.size());
+    try
+    {
+      std::size_t num_of_chars_read = 0;
+      unsigned long value = std::stoul(value_string, &num_of_chars_read);
+      if (num_of_chars_read != value_string.size() ||
+          value_string[0] == '-' || value > UINT32_MAX)
+      {
+        break;
+      }
+      shoe_filter.comparison = comparison;
+      shoe_filter.value = static_cast<std::uint32_t>(value);
+    }
+    catch (const std::logic_error &e)
+    {
+      break;
+    }
+    shoe_filters.push_back(shoe_filter);
+    return true;
+  }
+
+  printf("Invalid shoe filter '%s'.\n", filter.c_str());
+  return false;
+}
+
+void ShoeQuery::run(std::uint64_t limit) const
+{
+  auto start_time = std::chrono::steady_clock::now();
+  if (hand_filters.empty())
+  {
+    run_shoe_query(limit);
+  }
+  else
+  {
+    run_hand_query(limit);
+  }
+  std::chrono::duration<double> elapsed_time =
+      std::chrono::steady_clock::now() - start_time;
+  printf("\nQuery took %.3f ms.\n", elapsed_time.count() * 1000.0);
+}
+
+// PRIVATE METHODS
+
+auto ShoeQuery::is_matching_shoe(std::uint64_t shoe) const -> bool
+{
+  for (const ShoeFilter &shoe_filter : shoe_filters)
+  {
+    std::uint32_t value = shoe_filter.values[shoe];
+    bool is_matching = false;
+    switch (shoe_filter.comparison)
+    {
+    case Comparison::LESS:
+      is_matching = value < shoe_filter.value;
+      break;
+    case Comparison::LESS_EQUAL:
+      is_matching = value <= shoe_filter.value;
+      break;
+    case Comparison::EQUAL:
+      is_matching = value == shoe_filter.value;
+      break;
+    case Comparison::GREATER_EQUAL:
+      is_matching = value >= shoe_filter.value;
+      break;
+    case Comparison::GREATER:
+      is_matching = value > shoe_filter.value;
+      break;
+    }
+    if (!is_matching)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ShoeQuery::run_shoe_query(std::uint64_t limit) const
+{
+  std::uint64_t num_of_shoes = shoe_index.get_num_of_shoes();
+  std::vector<std::uint64_t> listed_shoes;
+  std::uint64_t num_of_matching_shoes = 0;
+  for (std::uint64_t shoe = 0; shoe < num_of_shoes; ++shoe)
+  {
+    if (!is_matching_shoe(shoe))
+    {
+      continue;
+    }
+    ++num_of_matching_shoes;
+    if (listed_shoes.size() < limit)
+    {
+      listed_shoes.push_back(shoe);
+    }
+  }
+
+  printf("%llu of %llu shoes match.\n",
+         static_cast<unsigned long long>(num_of_matching_shoes),
+         static_cast<unsigned long long>(num_of_shoes));
+  for (std::uint64_t shoe : listed_shoes)
+  {
+    printf("  shoe %llu:", static_cast<unsigned long long>(shoe));
+    for (const ShoeFilter &shoe_filter : shoe_filters)
+    {
+      printf(" %s=%u", shoe_filter.name.c_str(), shoe_filter.values[shoe]);
+    }
+    printf("\n");
+  }
+}
+
+void ShoeQuery::run_hand_query(std::uint64_t limit) const
+{
+  constexpr std::uint64_t BITS_PER_WORD = 64;
+  std::uint64_t num_of_shoes = shoe_index.get_num_of_shoes();
+  std::uint64_t num_of_rounds = shoe_index.get_num_of_rounds();
+  std::uint64_t num_of_words = shoe_index.get_num_of_bitmap_words();
+
+  // Start with the hands of the matching shoes, the bits past the last hand
+  // stay clear so negated bitmaps never match them.
+  std::vector<std::uint64_t> matches(num_of_words, 0);
+  for (std::uint64_t shoe = 0; shoe < num_of_shoes; ++shoe)
+  {
+    if (!is_matching_shoe(shoe))
+    {
+      continue;
+    }
+    for (std::uint64_t round_index = shoe_index.get_first_round_index(shoe);
+         round_index < shoe_index.get_first_round_index(shoe + 1);)
+    {
+      std::uint64_t bit = round_index % BITS_PER_WORD;
+      std::uint64_t num_of_bits =
+          std::min(BITS_PER_WORD - bit,
+                   shoe_index.get_first_round_index(shoe + 1) - round_index);
+      std::uint64_t mask = num_of_bits == BITS_PER_WORD
+                               ? ~0ULL
+                               : ((1ULL << num_of_bits) - 1) << bit;
+      matches[round_index / BITS_PER_WORD] |= mask;
+      round_index += num_of_bits;
+    }
+  }
+
+  for (const HandFilter &hand_filter : hand_filters)
+  {
+    std::uint64_t flip = hand_filter.negated ? ~0ULL : 0;
+    for (std::uint64_t i = 0; i < num_of_words; ++i)
+    {
+      matches[i] &= hand_filter.bitmap[i] ^ flip;
+    }
+  }
+
+  // Walk the matching hands in order, so the shoe of each hand is found by
+  // moving forward rather than searching.
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> listed_hands;
+  std::uint64_t num_of_matching_hands = 0;
+  std::uint64_t num_of_matching_shoes = 0;
+  std::uint64_t shoe = 0;
+  bool is_shoe_counted = false;
+  for (std::uint64_t i = 0; i < num_of_words; ++i)
+  {
+    std::uint64_t word = matches[i];
+    num_of_matching_hands += std::bitset<BITS_PER_WORD>(word).count();
+    while (word != 0)
+    {
+      // The bits below the lowest set bit count its position.
+      std::uint64_t round_index =
+          i * BITS_PER_WORD +
+          std::bitset<BITS_PER_WORD>((word & (~word + 1)) - 1).count();
+      word &= word - 1;
+
+      while (shoe_index.get_first_round_index(shoe + 1) <= round_index)
+      {
+        ++shoe;
+        is_shoe_counted = false;
+      }
+      if (!is_shoe_counted)
+      {
+        ++num_of_matching_shoes;
+        is_shoe_counted = true;
+      }
+      if (listed_hands.size() < limit)
+      {
+        listed_hands.emplace_back(shoe, round_index);
+      }
+    }
+  }
+
+  printf("%llu of %llu hands in %llu shoes match.\n",
+         static_cast<unsigned long long>(num_of_matching_hands),
+         static_cast<unsigned long long>(num_of_rounds),
+         static_cast<unsigned long long>(num_of_matching_shoes));
+  for (const auto &[listed_shoe, round_index] : listed_hands)
+  {
+    print_hand(listed_shoe, round_index);
+  }
+}
+
+void ShoeQuery::print_hand(std::uint64_t shoe, std::uint64_t round_index) const
+{
+  RoundResult round_result;
+  if (!shoe_index.get_round(round_index, round_result))
+  {
+    printf("  shoe %llu, round %llu: invalid cards\n",
+           static_cast<unsigned long long>(shoe),
+           static_cast<unsigned long long>(
+               round_index - shoe_index.get_first_round_index(shoe)));
+    return;
+  }
+
+  std::string player_cards;
+  for (int i = 0; i < round_result.num_of_player_cards; ++i)
+  {
+    player_cards += (i > 0 ? "," : "") +
+                    CardDealer::get_string_card_type(
+                        round_result.player_cards[i]);
+  }
+  std::string banker_cards;
+  for (int i = 0; i < round_result.num_of_banker_cards; ++i)
+  {
+    banker_cards += (i > 0 ? "," : "") +
+                    CardDealer::get_string_card_type(
+                        round_result.banker_cards[i]);
+  }
+  printf("  shoe %llu, round %llu: PLAYER %d (%s), BANKER %d (%s), %s\n",
+         static_cast<unsigned long long>(shoe),
+         static_cast<unsigned long long>(
+             round_index - shoe_index.get_first_round_index(shoe)),
+         round_result.player_hand_value, player_cards.c_str(),
+         round_result.banker_hand_value, banker_cards.c_str(),
+         get_string_bet_type(round_result.outcome).c_str());
+}
+
+} // namespace BACCARAT
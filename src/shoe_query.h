@@ -0,0 +1,137 @@
+#ifndef SHOE_QUERY_H
+#define SHOE_QUERY_H
+
+#include "shoe_index.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief A class to find the shoes and hands of a ShoeIndex that match a set
+ * of filters.
+ *
+ * @details A filter either compares a shoe feature with a value, e.g.
+ * 'player-streak>=10' or 'ties=0', or names a hand bitmap, e.g. 'banker-draw'
+ * or 'player-third=7', optionally negated with 'not:'. Every filter must
+ * match. Without hand filters the matching shoes are found, otherwise the
+ * matching hands of the matching shoes are.
+ *
+ * @note Shoe filters scan a single column of 32 bit integers each, and hand
+ * filters are combined 64 hands at a time with bitwise operations, so no
+ * round is decoded except the ones that are listed.
+ */
+class ShoeQuery
+{
+public:
+  /**
+   * @brief Constructor for the ShoeQuery class.
+   *
+   * @param shoe_index The open index to query.
+   */
+  explicit ShoeQuery(const ShoeIndex &shoe_index);
+
+  /**
+   * @brief Adds a filter to the query.
+   *
+   * @param filter The filter, e.g. 'player-streak>=10' or 'not:tie'.
+   *
+   * @return true if the filter is valid, false otherwise.
+   */
+  auto add_filter(const std::string &filter) -> bool;
+
+  /**
+   * @brief Runs the query and prints the number of matches and the first
+   * matches.
+   *
+   * @param limit The most matches to list.
+   */
+  void run(std::uint64_t limit) const;
+
+private:
+  /**
+   * @brief Enum class to represent how a shoe feature is compared.
+   */
+  enum class Comparison : std::uint8_t
+  {
+    LESS,
+    LESS_EQUAL,
+    EQUAL,
+    GREATER_EQUAL,
+    GREATER
+  };
+
+  /**
+   * @brief A filter on a shoe feature.
+   */
+  struct ShoeFilter
+  {
+    /// @brief The name of the feature.
+    std::string name;
+    /// @brief The value of the feature for every shoe.
+    const std::uint32_t *values = nullptr;
+    /// @brief How the feature is compared with the value.
+    Comparison comparison = Comparison::EQUAL;
+    /// @brief The value the feature is compared with.
+    std::uint32_t value = 0;
+  };
+
+  /**
+   * @brief A filter on a hand bitmap.
+   */
+  struct HandFilter
+  {
+    /// @brief The bit of every hand.
+    const std::uint64_t *bitmap = nullptr;
+    /// @brief Whether the hands without the bit match instead.
+    bool negated = false;
+  };
+
+  /// @brief The index to query.
+  const ShoeIndex &shoe_index;
+
+  /// @brief The filters on shoe features.
+  std::vector<ShoeFilter> shoe_filters;
+
+  /// @brief The filters on hand bitmaps.
+  std::vector<HandFilter> hand_filters;
+
+  /**
+   * @brief Determines if a shoe matches every shoe filter.
+   *
+   * @param shoe The index of the shoe.
+   *
+   * @return true if the shoe matches, false otherwise.
+   */
+  [[nodiscard]] auto is_matching_shoe(std::uint64_t shoe) const -> bool;
+
+  /**
+   * @brief Prints the shoes that match the shoe filters.
+   *
+   * @param limit The most shoes to list.
+   */
+  void run_shoe_query(std::uint64_t limit) const;
+
+  /**
+   * @brief Prints the hands that match the hand filters in the shoes that
+   * match the shoe filters.
+   *
+   * @param limit The most hands to list.
+   */
+  void run_hand_query(std::uint64_t limit) const;
+
+  /**
+   * @brief Prints a hand.
+   *
+   * @param shoe The index of the shoe the hand was dealt from.
+   * @param round_index The index of the round in the index.
+   */
+  void print_hand(std::uint64_t shoe, std::uint64_t round_index) const;
+};
+
+} // namespace BACCARAT
+
+#endif // SHOE_QUERY_H
@@ -0,0 +1,163 @@
+#include "shoe_shuffler.h"
+
+#include <algorithm>
+#include <bitset>
+
+namespace BACCARAT
+{
+
+// CONSTRUCTORS
+
+ShoeShuffler::ShoeShuffler(ShuffleModel shuffle_model, int num_of_passes)
+    : shuffle_model(shuffle_model), num_of_passes(num_of_passes)
+{
+}
+
+// PUBLIC METHODS
+
+void ShoeShuffler::shuffle(std::vector<std::uint8_t> &cards,
+                           std::mt19937 &gen)
+{
+  shuffled_cards.resize(cards.size());
+  for (int pass = 0; pass < num_of_passes; ++pass)
+  {
+    switch (shuffle_model)
+    {
+    case ShuffleModel::RANDOM:
+      return;
+    case ShuffleModel::RIFFLE:
+      riffle_pass(cards, gen);
+      break;
+    case ShuffleModel::STRIP:
+      strip_pass(cards, gen);
+      break;
+    case ShuffleModel::MACHINE:
+      machine_pass(cards, gen);
+      break;
+    }
+  }
+}
+
+auto ShoeShuffler::draw_uniform_position(std::mt19937 &gen,
+                                         int num_of_positions) -> int
+{
+  // Lemire's multiply and shift method, the rare low products that would
+  // bias the result are rejected so every position is exactly equally likely.
+  auto range = static_cast<std::uint32_t>(num_of_positions);
+  std::uint64_t product = static_cast<std::uint64_t>(gen()) * range;
+  auto low_bits = static_cast<std::uint32_t>(product);
+  if (low_bits < range)
+  {
+    std::uint32_t threshold = (0U - range) % range;
+    while (low_bits < threshold)
+    {
+      product = static_cast<std::uint64_t>(gen()) * range;
+      low_bits = static_cast<std::uint32_t>(product);
+    }
+  }
+  return static_cast<int>(product >> 32U);
+}
+
+// PRIVATE METHODS
+
+void ShoeShuffler::riffle_pass(std::vector<std::uint8_t> &cards,
+                               std::mt19937 &gen)
+{
+  // A fair coin for every position of the new pile decides which packet its
+  // card comes from. The number of heads is the binomial cut, and given the
+  // cut every interleaving is equally likely, which is the Gilbert-Shannon-
+  // Reeds model with one bit of the generator per card.
+  constexpr int BITS_PER_DRAW = 32;
+  auto num_of_cards = static_cast<int>(cards.size());
+  riffle_bits.resize((cards.size() + BITS_PER_DRAW - 1) / BITS_PER_DRAW);
+  int cut = 0;
+  for (std::size_t i = 0; i < riffle_bits.size(); ++i)
+  {
+    riffle_bits[i] = gen();
+    int num_of_bits =
+        std::min(BITS_PER_DRAW, num_of_cards - static_cast<int>(i) *
+                                                   BITS_PER_DRAW);
+    if (num_of_bits < BITS_PER_DRAW)
+    {
+      riffle_bits[i] &= (1U << static_cast<unsigned>(num_of_bits)) - 1;
+    }
+    cut += static_cast<int>(std::bitset<BITS_PER_DRAW>(riffle_bits[i]).count());
+  }
+
+  // The packet is picked without a branch, the bits are too random for a
+  // branch predictor.
+  int top = 0;
+  int bottom = cut;
+  for (int i = 0; i < num_of_cards; ++i)
+  {
+    auto is_top_card = static_cast<int>(
+        (riffle_bits[i / BITS_PER_DRAW] >> (i % BITS_PER_DRAW)) & 1U);
+    shuffled_cards[i] = cards[is_top_card != 0 ? top : bottom];
+    top += is_top_card;
+    bottom += 1 - is_top_card;
+  }
+  cards.swap(shuffled_cards);
+}
+
+void ShoeShuffler::strip_pass(std::vector<std::uint8_t> &cards,
+                              std::mt19937 &gen)
+{
+  // Each packet lands on top of the ones pulled before it, so the first
+  // packet ends up at the bottom of the new pile.
+  auto num_of_cards = static_cast<int>(cards.size());
+  int top = 0;
+  int pile_top = num_of_cards;
+  while (top < num_of_cards)
+  {
+    int packet_size =
+        std::min(1 + draw_uniform_position(gen, 2 * MEAN_STRIP_PACKET_SIZE - 1),
+                 num_of_cards - top);
+    pile_top -= packet_size;
+    std::copy(cards.begin() + top, cards.begin() + top + packet_size,
+              shuffled_cards.begin() + pile_top);
+    top += packet_size;
+  }
+  cards.swap(shuffled_cards);
+}
+
+void ShoeShuffler::machine_pass(std::vector<std::uint8_t> &cards,
+                                std::mt19937 &gen)
+{
+  // Draw where every card is dropped first, the even drops go on top of
+  // their compartment and the odd drops at the bottom.
+  auto num_of_cards = static_cast<int>(cards.size());
+  drops.resize(cards.size());
+  std::array<int, NUM_OF_MACHINE_COMPARTMENTS> num_of_top_drops = {};
+  std::array<int, NUM_OF_MACHINE_COMPARTMENTS> num_of_cards_in_compartment =
+      {};
+  for (int i = 0; i < num_of_cards; ++i)
+  {
+    auto drop = static_cast<std::uint8_t>(
+        draw_uniform_position(gen, 2 * NUM_OF_MACHINE_COMPARTMENTS));
+    drops[i] = drop;
+    num_of_top_drops[drop / 2] += 1 - drop % 2;
+    ++num_of_cards_in_compartment[drop / 2];
+  }
+
+  // The cards dropped on top are stacked in reverse order above the cards
+  // dropped at the bottom, which keep their order.
+  std::array<int, NUM_OF_MACHINE_COMPARTMENTS> next_top_position = {};
+  std::array<int, NUM_OF_MACHINE_COMPARTMENTS> next_bottom_position = {};
+  int compartment_top = 0;
+  for (int i = 0; i < NUM_OF_MACHINE_COMPARTMENTS; ++i)
+  {
+    next_top_position[i] = compartment_top + num_of_top_drops[i] - 1;
+    next_bottom_position[i] = compartment_top + num_of_top_drops[i];
+    compartment_top += num_of_cards_in_compartment[i];
+  }
+  for (int i = 0; i < num_of_cards; ++i)
+  {
+    int compartment = drops[i] / 2;
+    int position = drops[i] % 2 == 0 ? next_top_position[compartment]--
+                                     : next_bottom_position[compartment]++;
+    shuffled_cards[position] = cards[i];
+  }
+  cards.swap(shuffled_cards);
+}
+
+} // namespace BACCARAT
@@ -0,0 +1,117 @@
+#ifndef SHOE_SHUFFLER_H
+#define SHOE_SHUFFLER_H
+
+#include "shuffle_model.h"
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief A class to shuffle an ordered shoe the way a dealer or a machine
+ * does, leaving some of the order of the cards in place.
+ *
+ * @details Every pass of a RIFFLE cuts the shoe into two packets with a
+ * binomial cut and interleaves them, dropping a card from either packet in
+ * proportion to its size (the Gilbert-Shannon-Reeds model). Every pass of a
+ * STRIP pulls packets of random size off the top of the shoe onto a new pile,
+ * which reverses the order of the packets. Every pass of a MACHINE drops each
+ * card at the top or bottom of a random compartment, then stacks the
+ * compartments in order. A RANDOM shuffle leaves the shoe as it is, the
+ * CardDealer draws every card uniformly from the cards remaining instead.
+ *
+ * @note The scratch buffers are kept between shuffles, so shuffling a shoe
+ * does not allocate once the first shoe has been shuffled.
+ */
+class ShoeShuffler
+{
+public:
+  /**
+   * @brief Default Constructor for the ShoeShuffler class, a RANDOM shuffle.
+   */
+  ShoeShuffler() = default;
+
+  /**
+   * @brief Constructor for the ShoeShuffler class.
+   *
+   * @param shuffle_model How the shoe is shuffled.
+   * @param num_of_passes The number of riffles, strip cuts or passes through
+   * the machine.
+   */
+  ShoeShuffler(ShuffleModel shuffle_model, int num_of_passes);
+
+  /**
+   * @brief Shuffles an ordered shoe.
+   *
+   * @param cards The card types of the shoe, top card first.
+   * @param gen The random number generator of the shoe.
+   */
+  void shuffle(std::vector<std::uint8_t> &cards, std::mt19937 &gen);
+
+  /**
+   * @brief Draws a uniformly random position.
+   *
+   * @param gen The random number generator.
+   * @param num_of_positions The number of positions, must be positive.
+   *
+   * @return A position from 0 to num_of_positions - 1.
+   */
+  static auto draw_uniform_position(std::mt19937 &gen,
+                                    int num_of_positions) -> int;
+
+  /// @brief The number of compartments of a shuffling machine.
+  static constexpr int NUM_OF_MACHINE_COMPARTMENTS = 20;
+
+  /// @brief The mean number of cards in a packet of a strip cut.
+  static constexpr int MEAN_STRIP_PACKET_SIZE = 20;
+
+private:
+  /// @brief How the shoe is shuffled.
+  ShuffleModel shuffle_model = ShuffleModel::RANDOM;
+
+  /// @brief The number of riffles, strip cuts or passes through the machine.
+  int num_of_passes = 0;
+
+  /// @brief The shoe being built by a pass.
+  std::vector<std::uint8_t> shuffled_cards;
+
+  /// @brief The packet every card of a riffle comes from, a bit per card,
+  /// see riffle_pass.
+  std::vector<std::uint32_t> riffle_bits;
+
+  /// @brief The compartment and side each card is dropped at by a pass
+  /// through the machine, see machine_pass.
+  std::vector<std::uint8_t> drops;
+
+  /**
+   * @brief Riffles the shoe once.
+   *
+   * @param cards The card types of the shoe, top card first.
+   * @param gen The random number generator of the shoe.
+   */
+  void riffle_pass(std::vector<std::uint8_t> &cards, std::mt19937 &gen);
+
+  /**
+   * @brief Strip cuts the shoe once.
+   *
+   * @param cards The card types of the shoe, top card first.
+   * @param gen The random number generator of the shoe.
+   */
+  void strip_pass(std::vector<std::uint8_t> &cards, std::mt19937 &gen);
+
+  /**
+   * @brief Passes the shoe through the shuffling machine once.
+   *
+   * @param cards The card types of the shoe, top card first.
+   * @param gen The random number generator of the shoe.
+   */
+  void machine_pass(std::vector<std::uint8_t> &cards, std::mt19937 &gen);
+};
+
+} // namespace BACCARAT
+
+#endif // SHOE_SHUFFLER_H
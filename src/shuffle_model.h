@@ -0,0 +1,45 @@
+#ifndef SHUFFLE_MODEL_H
+#define SHUFFLE_MODEL_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief Enum class to represent how the dealer shuffles a FINITE_SHOE.
+ */
+enum class ShuffleModel : std::uint8_t
+{
+  /// @brief A perfect shuffle, every order of the shoe is equally likely.
+  RANDOM,
+  /// @brief Gilbert-Shannon-Reeds riffle shuffles of the whole shoe.
+  RIFFLE,
+  /// @brief Strip cuts, packets are pulled off the top of the shoe onto a new
+  /// pile.
+  STRIP,
+  /// @brief A batch shuffling machine, every card is dropped into a random
+  /// compartment.
+  MACHINE
+};
+
+/**
+ * @brief Convert a ShuffleModel enum to a string representation.
+ *
+ * @param shuffle_model The ShuffleModel enum value.
+ *
+ * @return The string representation of the shuffle model.
+ */
+[[nodiscard]] static auto
+get_string_shuffle_model(const ShuffleModel &shuffle_model) -> std::string
+{
+  static const std::array<std::string, 4> SHUFFLE_MODEL_STRINGS = {
+      "RANDOM", "RIFFLE", "STRIP", "MACHINE"};
+  return SHUFFLE_MODEL_STRINGS[static_cast<std::size_t>(shuffle_model)];
+}
+
+} // namespace BACCARAT
+
+#endif // SHUFFLE_MODEL_H
@@ -0,0 +1,889 @@
+#include "simulation.h"
+#include "chunk_runner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <utility>
+
+namespace BACCARAT
+{
+
+// CONSTRUCTORS
+
+Simulation::Simulation(std::vector<SimulationConfig> configs,
+                       SimulationOptions options)
+    : configs(std::move(configs)), options(options)
+{
+}
+
+// PUBLIC METHODS
+
+void SimulationResult::merge(const SimulationResult &other)
+{
+  num_of_shoes += other.num_of_shoes;
+  num_of_rounds += other.num_of_rounds;
+  for (std::size_t i = 0; i < outcome_counts.size(); ++i)
+  {
+    outcome_counts[i] += other.outcome_counts[i];
+  }
+  for (std::size_t i = 0; i < card_counts.size(); ++i)
+  {
+    card_counts[i] += other.card_counts[i];
+  }
+  for (std::size_t i = 0; i < config_results.size(); ++i)
+  {
+    config_results[i].ev_per_round.merge(other.config_results[i].ev_per_round);
+    config_results[i].ev_per_unit_wagered.merge(
+        other.config_results[i].ev_per_unit_wagered);
+    paired_differences[i].merge(other.paired_differences[i]);
+  }
+}
+
+void SimulationResult::serialize(BinaryWriter &writer) const
+{
+  writer.write_u64(num_of_shoes);
+  writer.write_u64(num_of_rounds);
+  for (std::uint64_t outcome_count : outcome_counts)
+  {
+    writer.write_u64(outcome_count);
+  }
+  for (std::uint64_t card_count : card_counts)
+  {
+    writer.write_u64(card_count);
+  }
+  writer.write_u64(config_results.size());
+  for (std::size_t i = 0; i < config_results.size(); ++i)
+  {
+    config_results[i].ev_per_round.serialize(writer);
+    config_results[i].ev_per_unit_wagered.serialize(writer);
+    paired_differences[i].serialize(writer);
+  }
+}
+
+auto SimulationResult::deserialize(BinaryReader &reader) -> bool
+{
+  std::uint64_t num_of_configs = 0;
+  if (!reader.read_u64(num_of_shoes) || !reader.read_u64(num_of_rounds))
+  {
+    return false;
+  }
+  for (std::uint64_t &outcome_count : outcome_counts)
+  {
+    if (!reader.read_u64(outcome_count))
+    {
+      return false;
+    }
+  }
+  for (std::uint64_t &card_count : card_counts)
+  {
+    if (!reader.read_u64(card_count))
+    {
+      return false;
+    }
+  }
+  if (!reader.read_u64(num_of_configs))
+  {
+    return false;
+  }
+
+  config_results.assign(num_of_configs, ConfigResult());
+  paired_differences.assign(num_of_configs, RatioEstimator());
+  for (std::size_t i = 0; i < num_of_configs; ++i)
+  {
+    if (!config_results[i].ev_per_round.deserialize(reader) ||
+        !config_results[i].ev_per_unit_wagered.deserialize(reader) ||
+        !paired_differences[i].deserialize(reader))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto Simulation::run(SimulationResult &result) -> bool
+{
+  std::uint64_t num_of_chunks = get_num_of_chunks();
+
+  // A shard deals a contiguous range of chunks. The blocks that lie entirely
+  // in the shard are kept whole, the chunks of the blocks it shares with its
+  // neighbours are kept one by one so merge_shards can complete those blocks.
+  std::uint64_t shard_first_chunk_index = get_first_chunk_index(
+      options.shard_index, options.num_of_shards, num_of_chunks);
+  std::uint64_t last_chunk_index = get_first_chunk_index(
+      options.shard_index + 1, options.num_of_shards, num_of_chunks);
+  if (!options.shard_path.empty() &&
+      shard_first_chunk_index == last_chunk_index)
+  {
+    printf("Warning: shard %llu of %llu deals no shoes, a run of %llu shoes "
+           "only has %llu chunks of %llu shoes to split.\n",
+           static_cast<unsigned long long>(options.shard_index + 1),
+           static_cast<unsigned long long>(options.num_of_shards),
+           static_cast<unsigned long long>(options.num_of_shoes),
+           static_cast<unsigned long long>(num_of_chunks),
+           static_cast<unsigned long long>(SHOES_PER_CHUNK));
+  }
+
+  result = create_empty_result();
+  std::vector<SimulationResult> part_results;
+  std::uint64_t first_chunk_index = shard_first_chunk_index;
+
+  Checkpoint checkpoint(options.checkpoint, serialize_checkpoint_setup());
+  if (checkpoint.can_resume())
+  {
+    std::vector<std::uint8_t> state;
+    if (!checkpoint.read(first_chunk_index, state))
+    {
+      return false;
+    }
+    BinaryReader reader(std::move(state));
+    if (!result.deserialize(reader) ||
+        result.config_results.size() != configs.size() ||
+        !deserialize_part_results(reader, part_results) ||
+        !reader.is_at_end())
+    {
+      printf("Checkpoint '%s' is corrupt.\n",
+             options.checkpoint.path.c_str());
+      return false;
+    }
+    printf("Resuming from checkpoint after %llu of %llu shoes.\n",
+           static_cast<unsigned long long>(result.num_of_shoes),
+           static_cast<unsigned long long>(options.num_of_shoes));
+  }
+
+  // Checkpoints are only written between blocks, so no partial block has to
+  // be saved.
+  auto write_checkpoint = [&](std::uint64_t next_chunk_index)
+  {
+    BinaryWriter writer;
+    result.serialize(writer);
+    serialize_part_results(writer, part_results);
+    checkpoint.write(next_chunk_index, writer.get_buffer());
+  };
+
+  // The rate only counts the rounds dealt since the simulation started or
+  // resumed.
+  SimulationResult block_result = create_empty_result();
+  LiveStatsWriter live_stats_writer(options.live_stats_name);
+  std::chrono::steady_clock::time_point start_time =
+      std::chrono::steady_clock::now();
+  std::uint64_t num_of_rounds_at_start = result.num_of_rounds;
+  auto publish_live_stats = [&](bool finished)
+  {
+    SimulationResult live_result = result;
+    live_result.merge(block_result);
+    std::chrono::duration<double> elapsed_time =
+        std::chrono::steady_clock::now() - start_time;
+    LiveStats live_stats = get_live_stats(live_result);
+    live_stats.elapsed_seconds = elapsed_time.count();
+    live_stats.rounds_per_second =
+        elapsed_time.count() > 0.0
+            ? static_cast<double>(live_result.num_of_rounds -
+                                  num_of_rounds_at_start) /
+                  elapsed_time.count()
+            : 0.0;
+    live_stats.finished = finished ? 1 : 0;
+    live_stats_writer.publish(live_stats);
+  };
+  if (live_stats_writer.is_enabled())
+  {
+    publish_live_stats(false);
+  }
+
+  run_chunks_in_order<SimulationResult>(
+      first_chunk_index, last_chunk_index, options.num_of_threads,
+      [&](std::uint64_t chunk_index)
+      {
+        // Each chunk has its own dealer and strategies, so no state is shared
+        // while dealing.
+        std::vector<BetStrategy> strategies;
+        for (const SimulationConfig &config : configs)
+        {
+          strategies.push_back(config.strategy);
+        }
+
+        SimulationResult chunk_result = create_empty_result();
+        if (options.packed_shoes)
+        {
+          simulate_packed_chunk(chunk_index, strategies, chunk_result);
+          return chunk_result;
+        }
+
+        CardDealer card_dealer(configs[0].rules, options.shoe_mode);
+        card_dealer.set_continuous_shuffle_delay(
+            options.continuous_shuffle_delay);
+        card_dealer.set_shuffle_model(options.shuffle_model,
+                                      options.num_of_shuffle_passes);
+        simulate_chunk(chunk_index, card_dealer, strategies, chunk_result);
+        return chunk_result;
+      },
+      [&](std::uint64_t chunk_index, const SimulationResult &chunk_result)
+      {
+        // The chunks of a block are merged into the block first, then whole
+        // blocks are merged into the result. merge_shards completes the blocks
+        // split between shards from their chunks, so merging the parts of the
+        // shards in order adds up the same values in the same order as a
+        // single run.
+        block_result.merge(chunk_result);
+        bool is_block_in_shard =
+            is_block_in_range(chunk_index, shard_first_chunk_index,
+                              last_chunk_index, num_of_chunks);
+        if (!options.shard_path.empty() && !is_block_in_shard)
+        {
+          part_results.push_back(chunk_result);
+        }
+        if (chunk_index + 1 == get_block_end(chunk_index, num_of_chunks) ||
+            chunk_index + 1 == last_chunk_index)
+        {
+          result.merge(block_result);
+          if (!options.shard_path.empty() && is_block_in_shard)
+          {
+            part_results.push_back(block_result);
+          }
+          block_result = create_empty_result();
+          if (checkpoint.is_due())
+          {
+            write_checkpoint(chunk_index + 1);
+          }
+        }
+        if (live_stats_writer.is_enabled())
+        {
+          publish_live_stats(false);
+        }
+      });
+
+  if (checkpoint.is_enabled())
+  {
+    write_checkpoint(last_chunk_index);
+  }
+  if (live_stats_writer.is_enabled())
+  {
+    publish_live_stats(true);
+  }
+  if (!options.shard_path.empty() &&
+      !write_shard(shard_first_chunk_index, last_chunk_index, num_of_chunks,
+                   part_results))
+  {
+    return false;
+  }
+  return true;
+}
+
+auto Simulation::merge_shards(const std::vector<std::string> &paths,
+                              std::vector<SimulationConfig> &configs,
+                              SimulationOptions &options,
+                              SimulationResult &result) -> bool
+{
+  // The parts of every shard by the index of the shard. A shard of a run
+  // with more shards than chunks has no parts, so the shards are keyed by
+  // their index rather than by their first chunk.
+  std::map<std::uint64_t, std::vector<SimulationResult>> shards;
+  std::vector<std::uint8_t> setup;
+  std::uint64_t num_of_chunks = 0;
+  std::uint64_t num_of_shards = 0;
+  for (const std::string &path : paths)
+  {
+    std::vector<std::uint8_t> buffer;
+    if (!read_file(path, buffer))
+    {
+      printf("Failed to read shard '%s'.\n", path.c_str());
+      return false;
+    }
+
+    BinaryReader reader(std::move(buffer));
+    std::uint64_t magic = 0;
+    std::uint64_t setup_size = 0;
+    std::vector<std::uint8_t> shard_setup;
+    std::uint64_t shard_num_of_chunks = 0;
+    std::uint64_t shard_index = 0;
+    std::uint64_t shard_num_of_shards = 0;
+    std::vector<SimulationResult> part_results;
+    if (!reader.read_u64(magic) || magic != SHARD_MAGIC ||
+        !reader.read_u64(setup_size) ||
+        !reader.read_bytes(setup_size, shard_setup) ||
+        !reader.read_u64(shard_num_of_chunks) ||
+        !reader.read_u64(shard_index) ||
+        !reader.read_u64(shard_num_of_shards) ||
+        !deserialize_part_results(reader, part_results) ||
+        !reader.is_at_end() || shard_index >= shard_num_of_shards)
+    {
+      printf("'%s' is not a valid shard.\n", path.c_str());
+      return false;
+    }
+
+    if (shards.empty())
+    {
+      setup = shard_setup;
+      num_of_chunks = shard_num_of_chunks;
+      num_of_shards = shard_num_of_shards;
+    }
+    else if (shard_setup != setup || shard_num_of_chunks != num_of_chunks ||
+             shard_num_of_shards != num_of_shards)
+    {
+      printf("Shard '%s' was written by a different simulation setup.\n",
+             path.c_str());
+      return false;
+    }
+    if (!shards.emplace(shard_index, std::move(part_results)).second)
+    {
+      printf("Shard '%s' was given twice.\n", path.c_str());
+      return false;
+    }
+  }
+
+  BinaryReader setup_reader(setup);
+  if (shards.empty() || !deserialize_setup(setup_reader, configs, options))
+  {
+    printf("The shards do not describe a valid simulation.\n");
+    return false;
+  }
+
+  // Merge the parts in order, exactly as a single run merges them. A part is
+  // a whole block if the block lies entirely in its shard, and a single chunk
+  // otherwise, so the blocks split between shards are completed here.
+  result = SimulationResult();
+  result.config_results.resize(configs.size());
+  result.paired_differences.resize(configs.size());
+  const SimulationResult empty_result = result;
+  SimulationResult block_result = empty_result;
+  std::uint64_t next_shard_index = 0;
+  for (const auto &[shard_index, part_results] : shards)
+  {
+    if (shard_index != next_shard_index)
+    {
+      printf("Shard %llu of %llu is missing.\n",
+             static_cast<unsigned long long>(next_shard_index + 1),
+             static_cast<unsigned long long>(num_of_shards));
+      return false;
+    }
+    std::uint64_t first_chunk_index =
+        get_first_chunk_index(shard_index, num_of_shards, num_of_chunks);
+    std::uint64_t chunk_index = first_chunk_index;
+    std::uint64_t last_chunk_index =
+        get_first_chunk_index(shard_index + 1, num_of_shards, num_of_chunks);
+    for (const SimulationResult &part_result : part_results)
+    {
+      if (chunk_index == last_chunk_index ||
+          part_result.config_results.size() != configs.size())
+      {
+        printf("The shards do not describe a valid simulation.\n");
+        return false;
+      }
+      std::uint64_t block_end = get_block_end(chunk_index, num_of_chunks);
+      chunk_index = is_block_in_range(chunk_index, first_chunk_index,
+                                      last_chunk_index, num_of_chunks)
+                        ? block_end
+                        : chunk_index + 1;
+      block_result.merge(part_result);
+      if (chunk_index == block_end)
+      {
+        result.merge(block_result);
+        block_result = empty_result;
+      }
+    }
+    if (chunk_index != last_chunk_index)
+    {
+      printf("The shards do not describe a valid simulation.\n");
+      return false;
+    }
+    ++next_shard_index;
+  }
+  if (next_shard_index != num_of_shards)
+  {
+    printf("Shard %llu of %llu is missing.\n",
+           static_cast<unsigned long long>(next_shard_index + 1),
+           static_cast<unsigned long long>(num_of_shards));
+    return false;
+  }
+  return true;
+}
+
+void Simulation::print_result(const SimulationResult &result,
+                              bool print_paired_differences) const
+{
+  printf("\n--- Batch Simulation ---\n\n");
+  printf("Shoes: %llu\nRounds: %llu\nSeed: %llu\nShoe Mode: %s%s\n",
+         static_cast<unsigned long long>(result.num_of_shoes),
+         static_cast<unsigned long long>(result.num_of_rounds),
+         static_cast<unsigned long long>(options.seed),
+         get_string_shoe_mode(options.shoe_mode).c_str(),
+         options.antithetic     ? " (antithetic)"
+         : options.packed_shoes ? " (packed)"
+                                : "");
+  if (options.shoe_mode == ShoeMode::CONTINUOUS_SHUFFLE)
+  {
+    printf("Continuous Shuffle Delay: %d rounds\n",
+           options.continuous_shuffle_delay);
+  }
+  if (options.shuffle_model != ShuffleModel::RANDOM)
+  {
+    printf("Shuffle: %s, %d passes\n",
+           get_string_shuffle_model(options.shuffle_model).c_str(),
+           options.num_of_shuffle_passes);
+  }
+  printf("\n");
+
+  auto num_of_rounds = static_cast<double>(std::max<std::uint64_t>(
+      result.num_of_rounds, 1));
+  for (std::size_t i = 0; i < result.outcome_counts.size(); ++i)
+  {
+    printf("%-8s %14llu %12.8f\n",
+           get_string_bet_type(static_cast<BetType>(i)).c_str(),
+           static_cast<unsigned long long>(result.outcome_counts[i]),
+           static_cast<double>(result.outcome_counts[i]) / num_of_rounds);
+  }
+
+  printf("\n%-28s %13s %11s %13s %11s\n", "CONFIG", "EV/ROUND", "95% CI",
+         "EV/WAGERED", "95% CI");
+  for (std::size_t i = 0; i < configs.size(); ++i)
+  {
+    const ConfigResult &config_result = result.config_results[i];
+    printf("%-28s %+13.8f %11.8f %+13.8f %11.8f\n", configs[i].name.c_str(),
+           config_result.ev_per_round.get_ratio(),
+           config_result.ev_per_round.get_confidence_interval(),
+           config_result.ev_per_unit_wagered.get_ratio(),
+           config_result.ev_per_unit_wagered.get_confidence_interval());
+  }
+
+  if (!print_paired_differences || configs.size() < 2)
+  {
+    printf("\n");
+    return;
+  }
+
+  // The variance reduction is the variance of the difference had the
+  // configurations been run on independent shoes, over the paired variance.
+  printf("\nPaired difference in EV/ROUND vs %s:\n\n", configs[0].name.c_str());
+  printf("%-28s %13s %11s %13s\n", "CONFIG", "DIFFERENCE", "95% CI",
+         "VAR REDUCTION");
+  double first_standard_error =
+      result.config_results[0].ev_per_round.get_standard_error();
+  for (std::size_t i = 1; i < configs.size(); ++i)
+  {
+    double standard_error =
+        result.config_results[i].ev_per_round.get_standard_error();
+    double paired_standard_error =
+        result.paired_differences[i].get_standard_error();
+    double variance_reduction =
+        paired_standard_error > 0.0
+            ? ((first_standard_error * first_standard_error) +
+               (standard_error * standard_error)) /
+                  (paired_standard_error * paired_standard_error)
+            : 0.0;
+    printf("%-28s %+13.8f %11.8f %12.1fx\n", configs[i].name.c_str(),
+           result.paired_differences[i].get_ratio(),
+           result.paired_differences[i].get_confidence_interval(),
+           variance_reduction);
+  }
+  printf("\n");
+}
+
+auto Simulation::get_shoe_seed(std::uint64_t seed,
+                               std::uint64_t shoe_index) -> std::uint64_t
+{
+  // SplitMix64 of the seed offset by the shoe index.
+  std::uint64_t hash = seed + ((shoe_index + 1) * 0x9E3779B97F4A7C15ULL);
+  hash = (hash ^ (hash >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+  hash = (hash ^ (hash >> 27U)) * 0x94D049BB133111EBULL;
+  return hash ^ (hash >> 31U);
+}
+
+// PRIVATE METHODS
+
+auto Simulation::get_num_of_chunks() const -> std::uint64_t
+{
+  return (options.num_of_shoes + SHOES_PER_CHUNK - 1) / SHOES_PER_CHUNK;
+}
+
+auto Simulation::get_first_chunk_index(std::uint64_t shard_index,
+                                       std::uint64_t num_of_shards,
+                                       std::uint64_t num_of_chunks)
+    -> std::uint64_t
+{
+  return shard_index * num_of_chunks / num_of_shards;
+}
+
+auto Simulation::get_block_end(std::uint64_t chunk_index,
+                               std::uint64_t num_of_chunks) -> std::uint64_t
+{
+  return std::min((chunk_index / CHUNKS_PER_BLOCK + 1) * CHUNKS_PER_BLOCK,
+                  num_of_chunks);
+}
+
+auto Simulation::is_block_in_range(std::uint64_t chunk_index,
+                                   std::uint64_t first_chunk_index,
+                                   std::uint64_t last_chunk_index,
+                                   std::uint64_t num_of_chunks) -> bool
+{
+  return chunk_index / CHUNKS_PER_BLOCK * CHUNKS_PER_BLOCK >=
+             first_chunk_index &&
+         get_block_end(chunk_index, num_of_chunks) <= last_chunk_index;
+}
+
+auto Simulation::serialize_setup() const -> std::vector<std::uint8_t>
+{
+  BinaryWriter writer;
+  writer.write_string(options.compare ? "compare" : "batch");
+  writer.write_u64(options.num_of_shoes);
+  writer.write_u64(options.seed);
+  writer.write_double(options.penetration);
+  writer.write_u64(static_cast<std::uint64_t>(options.shoe_mode));
+  writer.write_i64(options.continuous_shuffle_delay);
+  writer.write_u64(static_cast<std::uint64_t>(options.shuffle_model));
+  writer.write_i64(options.num_of_shuffle_passes);
+  writer.write_u64(options.antithetic ? 1 : 0);
+  writer.write_u64(options.packed_shoes ? 1 : 0);
+  writer.write_u64(configs.size());
+  for (const SimulationConfig &config : configs)
+  {
+    writer.write_string(config.name);
+    config.rules.serialize(writer);
+    writer.write_string(config.strategy.to_string());
+  }
+  return writer.get_buffer();
+}
+
+auto Simulation::serialize_checkpoint_setup() const
+    -> std::vector<std::uint8_t>
+{
+  // A shard can only be resumed by the same shard.
+  BinaryWriter writer;
+  writer.write_bytes(serialize_setup());
+  writer.write_u64(options.shard_index);
+  writer.write_u64(options.num_of_shards);
+  return writer.get_buffer();
+}
+
+auto Simulation::deserialize_setup(BinaryReader &reader,
+                                   std::vector<SimulationConfig> &configs,
+                                   SimulationOptions &options) -> bool
+{
+  std::string simulation_type;
+  std::uint64_t shoe_mode = 0;
+  std::int64_t continuous_shuffle_delay = 0;
+  std::uint64_t shuffle_model = 0;
+  std::int64_t num_of_shuffle_passes = 0;
+  std::uint64_t antithetic = 0;
+  std::uint64_t packed_shoes = 0;
+  std::uint64_t num_of_configs = 0;
+  if (!reader.read_string(simulation_type) ||
+      (simulation_type != "batch" && simulation_type != "compare") ||
+      !reader.read_u64(options.num_of_shoes) ||
+      !reader.read_u64(options.seed) ||
+      !reader.read_double(options.penetration) ||
+      !reader.read_u64(shoe_mode) ||
+      !reader.read_i64(continuous_shuffle_delay) ||
+      !reader.read_u64(shuffle_model) ||
+      !reader.read_i64(num_of_shuffle_passes) ||
+      !reader.read_u64(antithetic) || !reader.read_u64(packed_shoes) ||
+      !reader.read_u64(num_of_configs))
+  {
+    return false;
+  }
+  options.shoe_mode = static_cast<ShoeMode>(shoe_mode);
+  options.continuous_shuffle_delay = static_cast<int>(continuous_shuffle_delay);
+  options.shuffle_model = static_cast<ShuffleModel>(shuffle_model);
+  options.num_of_shuffle_passes = static_cast<int>(num_of_shuffle_passes);
+  options.antithetic = antithetic != 0;
+  options.packed_shoes = packed_shoes != 0;
+  options.compare = simulation_type == "compare";
+
+  configs.clear();
+  for (std::uint64_t i = 0; i < num_of_configs; ++i)
+  {
+    SimulationConfig config;
+    std::string strategy_string;
+    if (!reader.read_string(config.name) ||
+        !config.rules.deserialize(reader) ||
+        !reader.read_string(strategy_string) ||
+        !BetStrategy::from_string(strategy_string, config.strategy))
+    {
+      return false;
+    }
+    configs.push_back(config);
+  }
+  return !configs.empty() && reader.is_at_end();
+}
+
+void Simulation::serialize_part_results(
+    BinaryWriter &writer, const std::vector<SimulationResult> &part_results)
+{
+  writer.write_u64(part_results.size());
+  for (const SimulationResult &part_result : part_results)
+  {
+    part_result.serialize(writer);
+  }
+}
+
+auto Simulation::deserialize_part_results(
+    BinaryReader &reader, std::vector<SimulationResult> &part_results) -> bool
+{
+  std::uint64_t num_of_parts = 0;
+  if (!reader.read_u64(num_of_parts))
+  {
+    return false;
+  }
+  part_results.clear();
+  for (std::uint64_t i = 0; i < num_of_parts; ++i)
+  {
+    SimulationResult part_result;
+    if (!part_result.deserialize(reader))
+    {
+      return false;
+    }
+    part_results.push_back(std::move(part_result));
+  }
+  return true;
+}
+
+auto Simulation::write_shard(
+    std::uint64_t first_chunk_index,
+    std::uint64_t last_chunk_index,
+    std::uint64_t num_of_chunks,
+    const std::vector<SimulationResult> &part_results) const -> bool
+{
+  std::vector<std::uint8_t> setup = serialize_setup();
+
+  BinaryWriter writer;
+  writer.write_u64(SHARD_MAGIC);
+  writer.write_u64(setup.size());
+  writer.write_bytes(setup);
+  writer.write_u64(num_of_chunks);
+  writer.write_u64(options.shard_index);
+  writer.write_u64(options.num_of_shards);
+  serialize_part_results(writer, part_results);
+
+  if (!write_file_atomically(options.shard_path, writer.get_buffer()))
+  {
+    printf("Failed to write shard '%s'.\n", options.shard_path.c_str());
+    return false;
+  }
+  printf("Wrote shard %llu of %llu, %llu of %llu chunks from chunk %llu, to "
+         "'%s'.\n",
+         static_cast<unsigned long long>(options.shard_index + 1),
+         static_cast<unsigned long long>(options.num_of_shards),
+         static_cast<unsigned long long>(last_chunk_index - first_chunk_index),
+         static_cast<unsigned long long>(num_of_chunks),
+         static_cast<unsigned long long>(first_chunk_index),
+         options.shard_path.c_str());
+  return true;
+}
+
+auto Simulation::get_live_stats(const SimulationResult &result) const
+    -> LiveStats
+{
+  LiveStats live_stats;
+  live_stats.num_of_shoes = result.num_of_shoes;
+  live_stats.num_of_shoes_to_deal = options.num_of_shoes;
+  live_stats.num_of_rounds = result.num_of_rounds;
+  live_stats.outcome_counts = result.outcome_counts;
+  live_stats.card_counts = result.card_counts;
+  live_stats.num_of_configs =
+      std::min<std::size_t>(configs.size(), LiveStats::MAX_CONFIGS);
+  for (std::size_t i = 0; i < live_stats.num_of_configs; ++i)
+  {
+    // The name is truncated to leave room for the null terminator.
+    LiveConfigStats &config_stats = live_stats.configs[i];
+    std::strncpy(config_stats.name.data(), configs[i].name.c_str(),
+                 config_stats.name.size() - 1);
+    const ConfigResult &config_result = result.config_results[i];
+    config_stats.ev_per_round = config_result.ev_per_round.get_ratio();
+    config_stats.ev_per_round_confidence_interval =
+        config_result.ev_per_round.get_confidence_interval();
+    config_stats.ev_per_unit_wagered =
+        config_result.ev_per_unit_wagered.get_ratio();
+  }
+  return live_stats;
+}
+
+auto Simulation::create_empty_result() const -> SimulationResult
+{
+  SimulationResult result;
+  result.config_results.resize(configs.size());
+  result.paired_differences.resize(configs.size());
+  return result;
+}
+
+void Simulation::simulate_chunk(std::uint64_t chunk_index,
+                                CardDealer &card_dealer,
+                                std::vector<BetStrategy> &strategies,
+                                SimulationResult &result) const
+{
+  std::uint64_t first_shoe_index = chunk_index * SHOES_PER_CHUNK;
+  std::uint64_t last_shoe_index =
+      std::min(first_shoe_index + SHOES_PER_CHUNK, options.num_of_shoes);
+
+  // The profit and amount wagered of each configuration in the current shoe,
+  // or antithetic pair of shoes.
+  std::vector<double> profits(configs.size());
+  std::vector<double> wagered(configs.size());
+
+  std::uint64_t shoes_per_sample = options.antithetic ? 2 : 1;
+  for (std::uint64_t shoe_index = first_shoe_index;
+       shoe_index < last_shoe_index; shoe_index += shoes_per_sample)
+  {
+    std::fill(profits.begin(), profits.end(), 0.0);
+    std::fill(wagered.begin(), wagered.end(), 0.0);
+
+    // Both shoes of an antithetic pair are dealt from the same seed.
+    std::uint64_t shoe_seed =
+        get_shoe_seed(options.seed, shoe_index / shoes_per_sample);
+
+    card_dealer.set_antithetic(options.antithetic ? AntitheticShoe::FIRST
+                                                  : AntitheticShoe::NONE);
+    card_dealer.reset_deck(shoe_seed);
+    std::uint64_t num_of_rounds =
+        simulate_shoe(card_dealer, strategies, profits, wagered, result);
+
+    if (options.antithetic)
+    {
+      card_dealer.set_antithetic(AntitheticShoe::MIRRORED);
+      card_dealer.reset_deck(shoe_seed);
+      num_of_rounds +=
+          simulate_shoe(card_dealer, strategies, profits, wagered, result);
+    }
+
+    add_sample(profits, wagered, 0, shoes_per_sample, num_of_rounds, result);
+  }
+}
+
+void Simulation::simulate_packed_chunk(
+    std::uint64_t chunk_index,
+    const std::vector<BetStrategy> &strategies,
+    SimulationResult &result) const
+{
+  std::uint64_t first_shoe_index = chunk_index * SHOES_PER_CHUNK;
+  std::uint64_t last_shoe_index =
+      std::min(first_shoe_index + SHOES_PER_CHUNK, options.num_of_shoes);
+  std::size_t num_of_configs = configs.size();
+
+  // Every shoe of the chunk has its own copy of the strategies, profits and
+  // amounts wagered, the entries of a shoe start at its index times the
+  // number of configurations.
+  PackedShoeBatch shoe_batch(configs[0].rules, options.penetration);
+  std::vector<BetStrategy> shoe_strategies;
+  for (std::uint64_t shoe_index = first_shoe_index;
+       shoe_index < last_shoe_index; ++shoe_index)
+  {
+    shoe_batch.add_shoe(get_shoe_seed(options.seed, shoe_index));
+    for (const BetStrategy &strategy : strategies)
+    {
+      shoe_strategies.push_back(strategy);
+      shoe_strategies.back().reset_state();
+    }
+  }
+  std::size_t num_of_shoes = shoe_batch.get_num_of_shoes();
+  std::vector<double> profits(num_of_shoes * num_of_configs);
+  std::vector<double> wagered(num_of_shoes * num_of_configs);
+  std::vector<std::uint64_t> num_of_rounds(num_of_shoes);
+
+  std::vector<std::uint32_t> shoe_indexes;
+  std::vector<RoundResult> round_results;
+  shoe_batch.deal_next_rounds(shoe_indexes, round_results);
+  while (!shoe_indexes.empty())
+  {
+    for (std::size_t i = 0; i < shoe_indexes.size(); ++i)
+    {
+      std::uint32_t shoe = shoe_indexes[i];
+      ++num_of_rounds[shoe];
+      record_round(round_results[i], shoe_strategies, profits, wagered,
+                   shoe * num_of_configs, result);
+    }
+    shoe_batch.deal_next_rounds(shoe_indexes, round_results);
+  }
+
+  // The samples are added in shoe order, the same as dealing the shoes one
+  // after the other.
+  for (std::size_t shoe = 0; shoe < num_of_shoes; ++shoe)
+  {
+    add_sample(profits, wagered, shoe * num_of_configs, 1, num_of_rounds[shoe],
+               result);
+  }
+}
+
+auto Simulation::simulate_shoe(CardDealer &card_dealer,
+                               std::vector<BetStrategy> &strategies,
+                               std::vector<double> &profits,
+                               std::vector<double> &wagered,
+                               SimulationResult &result) const -> std::uint64_t
+{
+  for (BetStrategy &strategy : strategies)
+  {
+    strategy.reset_state();
+  }
+
+  int total_cards_in_deck =
+      CardDealer::CARDS_PER_DECK * configs[0].rules.num_of_decks;
+  auto cut_card_position =
+      static_cast<int>(options.penetration * total_cards_in_deck);
+
+  RoundResult round_result;
+  std::uint64_t num_of_rounds = 0;
+  int num_of_cards_dealt = 0;
+  while (num_of_cards_dealt < cut_card_position &&
+         num_of_cards_dealt + MAX_CARDS_IN_ROUND <= total_cards_in_deck)
+  {
+    card_dealer.deal_round(round_result);
+    num_of_cards_dealt +=
+        round_result.num_of_player_cards + round_result.num_of_banker_cards;
+    ++num_of_rounds;
+    record_round(round_result, strategies, profits, wagered, 0, result);
+  }
+  return num_of_rounds;
+}
+
+void Simulation::record_round(const RoundResult &round_result,
+                              std::vector<BetStrategy> &strategies,
+                              std::vector<double> &profits,
+                              std::vector<double> &wagered,
+                              std::size_t first_entry,
+                              SimulationResult &result) const
+{
+  ++result.outcome_counts[static_cast<std::size_t>(round_result.outcome)];
+  for (int i = 0; i < round_result.num_of_player_cards; ++i)
+  {
+    ++result.card_counts[round_result.player_cards[i]];
+  }
+  for (int i = 0; i < round_result.num_of_banker_cards; ++i)
+  {
+    ++result.card_counts[round_result.banker_cards[i]];
+  }
+
+  // Settle every configuration on the same round.
+  for (std::size_t i = 0; i < configs.size(); ++i)
+  {
+    BetStrategy &strategy = strategies[first_entry + i];
+    double bet_amount = strategy.get_next_bet_amount();
+    double payout_multiplier = CardDealer::get_payout_multiplier(
+        round_result.outcome, strategy.get_next_bet_type(), configs[i].rules);
+
+    profits[first_entry + i] += bet_amount * (payout_multiplier - 1);
+    wagered[first_entry + i] += bet_amount;
+    strategy.record_result(round_result.outcome, payout_multiplier);
+  }
+}
+
+void Simulation::add_sample(const std::vector<double> &profits,
+                            const std::vector<double> &wagered,
+                            std::size_t first_entry,
+                            std::uint64_t num_of_shoes,
+                            std::uint64_t num_of_rounds,
+                            SimulationResult &result) const
+{
+  result.num_of_shoes += num_of_shoes;
+  result.num_of_rounds += num_of_rounds;
+  auto rounds = static_cast<double>(num_of_rounds);
+  double baseline_profit = profits[first_entry];
+  for (std::size_t i = 0; i < configs.size(); ++i)
+  {
+    double profit = profits[first_entry + i];
+    result.config_results[i].ev_per_round.add(profit, rounds);
+    result.config_results[i].ev_per_unit_wagered.add(
+        profit, wagered[first_entry + i]);
+    result.paired_differences[i].add(profit - baseline_profit, rounds);
+  }
+}
+
+} // namespace BACCARAT
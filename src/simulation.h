@@ -0,0 +1,497 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "bet_strategy.h"
+#include "binary_io.h"
+#include "card_dealer.h"
+#include "checkpoint.h"
+#include "live_stats.h"
+#include "packed_shoe.h"
+#include "rule_set.h"
+#include "shoe_mode.h"
+#include "shuffle_model.h"
+#include "statistics.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief A betting strategy and the table rules it is settled with.
+ */
+struct SimulationConfig
+{
+  /// @brief The name of the configuration, used when printing results.
+  std::string name;
+
+  /// @brief The table rules used to settle the bets.
+  RuleSet rules;
+
+  /// @brief The betting strategy of the simulated player.
+  BetStrategy strategy;
+};
+
+/**
+ * @brief The options of a batch simulation.
+ */
+struct SimulationOptions
+{
+  /// @brief The number of shoes to deal.
+  std::uint64_t num_of_shoes = 10000;
+
+  /// @brief The master seed, every shoe is seeded from it and its index.
+  std::uint64_t seed = 1;
+
+  /// @brief The fraction of the shoe dealt before the cut card is reached.
+  double penetration = 0.9;
+
+  /// @brief How cards are drawn from the shoe.
+  ShoeMode shoe_mode = ShoeMode::FINITE_SHOE;
+
+  /// @brief The number of rounds before the cards of a round are returned to
+  /// a CONTINUOUS_SHUFFLE shoe.
+  int continuous_shuffle_delay = 0;
+
+  /// @brief How the dealer shuffles a FINITE_SHOE, see
+  /// CardDealer::set_shuffle_model.
+  ShuffleModel shuffle_model = ShuffleModel::RANDOM;
+
+  /// @brief The number of riffles, strip cuts or passes through the machine
+  /// of every shuffle.
+  int num_of_shuffle_passes = 0;
+
+  /// @brief If true, every second shoe is the mirrored shoe of the one
+  /// before it, see CardDealer::set_antithetic. The number of shoes must be
+  /// even.
+  bool antithetic = false;
+
+  /// @brief If true, the shoes of every chunk are dealt in lockstep from
+  /// packed shoe states, see PackedShoeBatch.
+  bool packed_shoes = false;
+
+  /// @brief If true, the configurations are compared against the first, as
+  /// 'baccarat compare' does, and their paired differences are printed.
+  bool compare = false;
+
+  /// @brief The number of worker threads, 0 to use every core.
+  int num_of_threads = 0;
+
+  /// @brief Where and how often the simulation state is saved.
+  CheckpointOptions checkpoint;
+
+  /// @brief The name of the shared memory segment the running counters are
+  /// published to, empty to disable publishing, see LiveStatsWriter.
+  std::string live_stats_name;
+
+  /// @brief The index of the shard to deal, from 0 to num_of_shards - 1.
+  std::uint64_t shard_index = 0;
+
+  /// @brief The number of shards the shoes are split into, 1 to deal every
+  /// shoe in a single run.
+  std::uint64_t num_of_shards = 1;
+
+  /// @brief The path the results of the shard are written to, empty if the
+  /// run is not sharded.
+  std::string shard_path;
+};
+
+/**
+ * @brief The results of a single configuration in a batch simulation.
+ */
+struct ConfigResult
+{
+  /// @brief The expected profit of the player per round dealt.
+  RatioEstimator ev_per_round;
+
+  /// @brief The expected profit of the player per unit wagered.
+  RatioEstimator ev_per_unit_wagered;
+};
+
+/**
+ * @brief The results of a batch simulation.
+ */
+struct SimulationResult
+{
+  /// @brief The number of shoes dealt.
+  std::uint64_t num_of_shoes = 0;
+
+  /// @brief The number of rounds dealt.
+  std::uint64_t num_of_rounds = 0;
+
+  /// @brief The number of rounds won by the PLAYER, BANKER and TIE.
+  std::array<std::uint64_t, 3> outcome_counts = {};
+
+  /// @brief The number of cards of each type dealt.
+  std::array<std::uint64_t, CardDealer::NUM_OF_UNIQUE_CARDS> card_counts = {};
+
+  /// @brief The results of each configuration.
+  std::vector<ConfigResult> config_results;
+
+  /// @brief The profit per round of each configuration minus the profit per
+  /// round of the first configuration, measured on the same shoes.
+  /// @note The first element is always zero.
+  std::vector<RatioEstimator> paired_differences;
+
+  /**
+   * @brief Adds the results of another simulation to this result.
+   *
+   * @param other The result to merge.
+   */
+  void merge(const SimulationResult &other);
+
+  /**
+   * @brief Writes the result to a binary buffer.
+   *
+   * @param writer The writer to write to.
+   */
+  void serialize(BinaryWriter &writer) const;
+
+  /**
+   * @brief Reads a result written by serialize.
+   *
+   * @param reader The reader to read from.
+   *
+   * @return true if the result was read, false otherwise.
+   */
+  auto deserialize(BinaryReader &reader) -> bool;
+};
+
+/**
+ * @brief A class to run batch simulations of Baccarat across many shoes.
+ *
+ * @details Every configuration is settled on the same dealt shoes (common
+ * random numbers), so the difference between two configurations can be
+ * measured far more precisely than with independent runs. The shoes are split
+ * into chunks that are dealt by a pool of worker threads, and the chunk
+ * results are always merged in order, so the result only depends on the seed
+ * and not on the number of threads.
+ *
+ * @note Every configuration must use the same number of decks, as they share
+ * the dealt shoes.
+ *
+ * @note If a checkpoint path is given, the merged results are saved
+ * periodically by the merging thread while the workers keep dealing, and the
+ * simulation can be resumed from the checkpoint with identical results.
+ *
+ * @note If a live stats name is given, the merged results are published to
+ * shared memory by the merging thread after every chunk, so the workers never
+ * wait for the readers.
+ *
+ * @note The chunks are merged into blocks and the blocks into the result. A
+ * run can be split into shards of whole chunks, e.g. one per process, that
+ * each write their results to a shard file, whole blocks where they can and
+ * single chunks where a block is split between shards. merge_shards combines
+ * the shard files into exactly the result of a single run.
+ */
+class Simulation
+{
+public:
+  /**
+   * @brief Constructor for the Simulation class.
+   *
+   * @param configs The configurations to simulate.
+   * @param options The options of the simulation.
+   */
+  Simulation(std::vector<SimulationConfig> configs, SimulationOptions options);
+
+  /**
+   * @brief Runs the simulation.
+   *
+   * @param result The results of the simulation.
+   *
+   * @return true if the simulation finished, false if its checkpoint could not
+   * be resumed.
+   */
+  auto run(SimulationResult &result) -> bool;
+
+  /**
+   * @brief Prints the results of the simulation.
+   *
+   * @param result The results of the simulation.
+   * @param print_paired_differences If true, also print the paired difference
+   * of every configuration against the first configuration.
+   */
+  void print_result(const SimulationResult &result,
+                    bool print_paired_differences) const;
+
+  /**
+   * @brief Combines the shard files of a sharded simulation.
+   *
+   * @details The shards can be given in any order, but must all come from the
+   * same setup and every shard from 1 to N must be given exactly once. A
+   * shard of a run with more shards than chunks deals no shoes, but is still
+   * needed.
+   *
+   * @param paths The paths of the shard files.
+   * @param configs The configurations of the simulation, read from the shards.
+   * @param options The options of the simulation, read from the shards.
+   * @param result The result of the simulation, identical to the result of a
+   * single run.
+   *
+   * @return true if the shards were merged, false otherwise.
+   */
+  static auto merge_shards(const std::vector<std::string> &paths,
+                           std::vector<SimulationConfig> &configs,
+                           SimulationOptions &options,
+                           SimulationResult &result) -> bool;
+
+  /**
+   * @brief Gets the seed of a shoe.
+   *
+   * @details The seed is a hash of the master seed and the shoe index, so any
+   * range of shoes can be dealt independently.
+   *
+   * @param seed The master seed.
+   * @param shoe_index The index of the shoe.
+   *
+   * @return The seed of the shoe.
+   */
+  [[nodiscard]] static auto
+  get_shoe_seed(std::uint64_t seed, std::uint64_t shoe_index) -> std::uint64_t;
+
+  /// @brief The number of shoes in a chunk of work given to a worker thread,
+  /// each chunk is dealt by a new dealer.
+  /// @note Must be even, so an antithetic pair is never split.
+  static constexpr std::uint64_t SHOES_PER_CHUNK = 256;
+
+private:
+  /// @brief The number of chunks merged into a block before the block is
+  /// merged into the result.
+  static constexpr std::uint64_t CHUNKS_PER_BLOCK = 64;
+
+  /// @brief The most cards that can be dealt in a single round.
+  static constexpr int MAX_CARDS_IN_ROUND = 6;
+
+  /// @brief Identifies a shard file, the ASCII string "BACSHRD4".
+  static constexpr std::uint64_t SHARD_MAGIC = 0x3444524853434142ULL;
+
+  /// @brief The configurations to simulate.
+  std::vector<SimulationConfig> configs;
+
+  /// @brief The options of the simulation.
+  SimulationOptions options;
+
+  /**
+   * @brief Gets the number of chunks the shoes are split into.
+   *
+   * @return The number of chunks.
+   */
+  [[nodiscard]] auto get_num_of_chunks() const -> std::uint64_t;
+
+  /**
+   * @brief Gets the first chunk dealt by a shard.
+   *
+   * @param shard_index The index of the shard.
+   * @param num_of_shards The number of shards.
+   * @param num_of_chunks The number of chunks in the whole simulation.
+   *
+   * @return The index of the first chunk of the shard, which is also the
+   * chunk after the last chunk of the previous shard.
+   */
+  [[nodiscard]] static auto
+  get_first_chunk_index(std::uint64_t shard_index, std::uint64_t num_of_shards,
+                        std::uint64_t num_of_chunks) -> std::uint64_t;
+
+  /**
+   * @brief Gets the chunk after the last chunk of the block of a chunk.
+   *
+   * @param chunk_index The index of the chunk.
+   * @param num_of_chunks The number of chunks in the whole simulation.
+   *
+   * @return The index of the first chunk of the next block.
+   */
+  [[nodiscard]] static auto
+  get_block_end(std::uint64_t chunk_index, std::uint64_t num_of_chunks)
+      -> std::uint64_t;
+
+  /**
+   * @brief Checks if the block of a chunk lies entirely in a range of chunks.
+   *
+   * @param chunk_index The index of the chunk.
+   * @param first_chunk_index The first chunk of the range.
+   * @param last_chunk_index The chunk after the last chunk of the range.
+   * @param num_of_chunks The number of chunks in the whole simulation.
+   *
+   * @return true if every chunk of the block is in the range, false otherwise.
+   */
+  [[nodiscard]] static auto
+  is_block_in_range(std::uint64_t chunk_index, std::uint64_t first_chunk_index,
+                    std::uint64_t last_chunk_index,
+                    std::uint64_t num_of_chunks) -> bool;
+
+  /**
+   * @brief Writes the setup of the simulation, every option and configuration
+   * that changes its results.
+   *
+   * @return The serialized setup.
+   */
+  [[nodiscard]] auto serialize_setup() const -> std::vector<std::uint8_t>;
+
+  /**
+   * @brief Writes the setup of the simulation and the shard being dealt.
+   *
+   * @return The serialized setup.
+   */
+  [[nodiscard]] auto
+  serialize_checkpoint_setup() const -> std::vector<std::uint8_t>;
+
+  /**
+   * @brief Reads a setup written by serialize_setup.
+   *
+   * @param reader The reader to read from.
+   * @param configs The configurations read.
+   * @param options The options read, the rest are left unchanged.
+   *
+   * @return true if the setup was read, false otherwise.
+   */
+  static auto deserialize_setup(BinaryReader &reader,
+                                std::vector<SimulationConfig> &configs,
+                                SimulationOptions &options) -> bool;
+
+  /**
+   * @brief Writes the results of a list of shard parts, prefixed by their
+   * number.
+   *
+   * @param writer The writer to write to.
+   * @param part_results The results of each part, a whole block or a chunk.
+   */
+  static void
+  serialize_part_results(BinaryWriter &writer,
+                         const std::vector<SimulationResult> &part_results);
+
+  /**
+   * @brief Reads the results of a list of shard parts written by
+   * serialize_part_results.
+   *
+   * @param reader The reader to read from.
+   * @param part_results The results of each part.
+   *
+   * @return true if the results were read, false otherwise.
+   */
+  static auto
+  deserialize_part_results(BinaryReader &reader,
+                           std::vector<SimulationResult> &part_results)
+      -> bool;
+
+  /**
+   * @brief Writes the shard file of a shard.
+   *
+   * @param first_chunk_index The index of the first chunk of the shard.
+   * @param last_chunk_index The chunk after the last chunk of the shard.
+   * @param num_of_chunks The number of chunks in the whole simulation.
+   * @param part_results The results of each part of the shard, in order.
+   *
+   * @return true if the shard file was written, false otherwise.
+   */
+  auto write_shard(std::uint64_t first_chunk_index,
+                   std::uint64_t last_chunk_index,
+                   std::uint64_t num_of_chunks,
+                   const std::vector<SimulationResult> &part_results) const
+      -> bool;
+
+  /**
+   * @brief Gets the running counters of the merged results to publish.
+   *
+   * @param result The results merged so far.
+   *
+   * @return The counters, without the timings.
+   */
+  [[nodiscard]] auto
+  get_live_stats(const SimulationResult &result) const -> LiveStats;
+
+  /**
+   * @brief Creates an empty result with an entry for every configuration.
+   *
+   * @return The empty result.
+   */
+  [[nodiscard]] auto create_empty_result() const -> SimulationResult;
+
+  /**
+   * @brief Deals a chunk of shoes and settles every configuration on them.
+   *
+   * @param chunk_index The index of the chunk.
+   * @param card_dealer The dealer used to deal the shoes.
+   * @param strategies The strategies of each configuration.
+   * @param result The result to update.
+   */
+  void simulate_chunk(std::uint64_t chunk_index,
+                      CardDealer &card_dealer,
+                      std::vector<BetStrategy> &strategies,
+                      SimulationResult &result) const;
+
+  /**
+   * @brief Deals a single shoe and settles every configuration on it.
+   *
+   * @param card_dealer The dealer used to deal the shoe, already reset.
+   * @param strategies The strategies of each configuration.
+   * @param profits The profit of each configuration, updated.
+   * @param wagered The amount wagered by each configuration, updated.
+   * @param result The result to update with the outcome counts.
+   *
+   * @return The number of rounds dealt.
+   */
+  auto simulate_shoe(CardDealer &card_dealer,
+                     std::vector<BetStrategy> &strategies,
+                     std::vector<double> &profits,
+                     std::vector<double> &wagered,
+                     SimulationResult &result) const -> std::uint64_t;
+
+  /**
+   * @brief Deals a chunk of packed shoes in lockstep and settles every
+   * configuration on them, see PackedShoeBatch.
+   *
+   * @param chunk_index The index of the chunk.
+   * @param strategies The strategies of each configuration, copied for every
+   * shoe.
+   * @param result The result to update.
+   */
+  void simulate_packed_chunk(std::uint64_t chunk_index,
+                             const std::vector<BetStrategy> &strategies,
+                             SimulationResult &result) const;
+
+  /**
+   * @brief Counts the outcome and cards of a round and settles every
+   * configuration on it.
+   *
+   * @param round_result The round.
+   * @param strategies The strategies of each configuration.
+   * @param profits The profit of each configuration, updated.
+   * @param wagered The amount wagered by each configuration, updated.
+   * @param first_entry The index of the entry of the first configuration in
+   * the strategies, profits and amounts wagered.
+   * @param result The result to update with the outcome counts.
+   */
+  void record_round(const RoundResult &round_result,
+                    std::vector<BetStrategy> &strategies,
+                    std::vector<double> &profits,
+                    std::vector<double> &wagered,
+                    std::size_t first_entry,
+                    SimulationResult &result) const;
+
+  /**
+   * @brief Adds the profit of every configuration over a shoe, or antithetic
+   * pair of shoes, to the estimators.
+   *
+   * @param profits The profit of each configuration.
+   * @param wagered The amount wagered by each configuration.
+   * @param first_entry The index of the entry of the first configuration in
+   * the profits and amounts wagered.
+   * @param num_of_shoes The number of shoes in the sample.
+   * @param num_of_rounds The number of rounds dealt from them.
+   * @param result The result to update.
+   */
+  void add_sample(const std::vector<double> &profits,
+                  const std::vector<double> &wagered,
+                  std::size_t first_entry,
+                  std::uint64_t num_of_shoes,
+                  std::uint64_t num_of_rounds,
+                  SimulationResult &result) const;
+};
+
+} // namespace BACCARAT
+
+#endif // SIMULATION_H
@@ -0,0 +1,86 @@
+#include "statistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace BACCARAT
+{
+
+// PUBLIC METHODS
+
+void RatioEstimator::add(double numerator, double denominator)
+{
+  ++count;
+  sum_numerator += numerator;
+  sum_denominator += denominator;
+  sum_numerator_squared += numerator * numerator;
+  sum_denominator_squared += denominator * denominator;
+  sum_numerator_denominator += numerator * denominator;
+}
+
+void RatioEstimator::merge(const RatioEstimator &other)
+{
+  count += other.count;
+  sum_numerator += other.sum_numerator;
+  sum_denominator += other.sum_denominator;
+  sum_numerator_squared += other.sum_numerator_squared;
+  sum_denominator_squared += other.sum_denominator_squared;
+  sum_numerator_denominator += other.sum_numerator_denominator;
+}
+
+auto RatioEstimator::get_count() const -> std::uint64_t { return count; }
+
+auto RatioEstimator::get_ratio() const -> double
+{
+  if (sum_denominator == 0.0)
+  {
+    return 0.0;
+  }
+  return sum_numerator / sum_denominator;
+}
+
+auto RatioEstimator::get_standard_error() const -> double
+{
+  if (count < 2 || sum_denominator == 0.0)
+  {
+    return 0.0;
+  }
+
+  // The variance of the residuals numerator - ratio * denominator.
+  double ratio = get_ratio();
+  double residual_sum_of_squares =
+      sum_numerator_squared - (2 * ratio * sum_numerator_denominator) +
+      (ratio * ratio * sum_denominator_squared);
+  double residual_variance = std::max(residual_sum_of_squares, 0.0) /
+                             static_cast<double>(count - 1);
+
+  double mean_denominator = sum_denominator / static_cast<double>(count);
+  return std::sqrt(residual_variance / static_cast<double>(count)) /
+         mean_denominator;
+}
+
+auto RatioEstimator::get_confidence_interval() const -> double
+{
+  return Z_95 * get_standard_error();
+}
+
+void RatioEstimator::serialize(BinaryWriter &writer) const
+{
+  writer.write_u64(count);
+  writer.write_double(sum_numerator);
+  writer.write_double(sum_denominator);
+  writer.write_double(sum_numerator_squared);
+  writer.write_double(sum_denominator_squared);
+  writer.write_double(sum_numerator_denominator);
+}
+
+auto RatioEstimator::deserialize(BinaryReader &reader) -> bool
+{
+  return reader.read_u64(count) && reader.read_double(sum_numerator) &&
+         reader.read_double(sum_denominator) &&
+         reader.read_double(sum_numerator_squared) &&
+         reader.read_double(sum_denominator_squared) &&
+         reader.read_double(sum_numerator_denominator);
+}
+
+} // namespace BACCARAT
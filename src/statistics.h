@@ -0,0 +1,109 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include "binary_io.h"
+
+#include <cstdint>
+
+namespace BACCARAT
+{
+
+/**
+ * @brief A class to estimate a ratio of two sums from independent samples.
+ *
+ * @details Each sample is a pair, e.g. the profit and number of rounds of a
+ * single shoe. The estimate is the sum of the numerators over the sum of the
+ * denominators, and the standard error uses the delta method, so rounds
+ * within the same shoe are not assumed to be independent.
+ *
+ * @note Estimators can be merged, the result is the same as adding every
+ * sample to a single estimator.
+ */
+class RatioEstimator
+{
+public:
+  /**
+   * @brief Adds a sample to the estimator.
+   *
+   * @param numerator The numerator of the sample.
+   * @param denominator The denominator of the sample.
+   */
+  void add(double numerator, double denominator);
+
+  /**
+   * @brief Adds all the samples of another estimator to this estimator.
+   *
+   * @param other The estimator to merge.
+   */
+  void merge(const RatioEstimator &other);
+
+  /**
+   * @brief Get the number of samples.
+   *
+   * @return The number of samples added.
+   */
+  [[nodiscard]] auto get_count() const -> std::uint64_t;
+
+  /**
+   * @brief Get the estimate of the ratio.
+   *
+   * @return The sum of the numerators over the sum of the denominators.
+   */
+  [[nodiscard]] auto get_ratio() const -> double;
+
+  /**
+   * @brief Get the standard error of the ratio.
+   *
+   * @return The standard error, or 0 if there are less than two samples.
+   */
+  [[nodiscard]] auto get_standard_error() const -> double;
+
+  /**
+   * @brief Get the half width of the 95% confidence interval of the ratio.
+   *
+   * @return The half width of the confidence interval.
+   */
+  [[nodiscard]] auto get_confidence_interval() const -> double;
+
+  /**
+   * @brief Writes the estimator to a binary buffer.
+   *
+   * @param writer The writer to write to.
+   */
+  void serialize(BinaryWriter &writer) const;
+
+  /**
+   * @brief Reads an estimator written by serialize.
+   *
+   * @param reader The reader to read from.
+   *
+   * @return true if the estimator was read, false otherwise.
+   */
+  auto deserialize(BinaryReader &reader) -> bool;
+
+private:
+  /// @brief The z value of a two sided 95% confidence interval.
+  static constexpr double Z_95 = 1.959963984540054;
+
+  /// @brief The number of samples added.
+  std::uint64_t count = 0;
+
+  /// @brief The sum of the numerators.
+  double sum_numerator = 0.0;
+
+  /// @brief The sum of the denominators.
+  double sum_denominator = 0.0;
+
+  /// @brief The sum of the squared numerators.
+  double sum_numerator_squared = 0.0;
+
+  /// @brief The sum of the squared denominators.
+  double sum_denominator_squared = 0.0;
+
+  /// @brief The sum of the numerators multiplied by the denominators.
+  double sum_numerator_denominator = 0.0;
+};
+
+} // namespace BACCARAT
+
+#endif // STATISTICS_H